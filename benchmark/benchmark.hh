@@ -0,0 +1,52 @@
+#ifndef BENCHMARK_HH
+#define BENCHMARK_HH
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace Benchmark
+{
+    // Makes the compiler assume that value is read and modified here, so that
+    // it can neither drop the computation of value nor devirtualize calls on
+    // it afterwards.
+    template <typename T>
+    inline void escape (T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    // Returns the time taken by f() in nanoseconds, divided by operations.
+    template <typename F>
+    double ns_per_op (F f, std::size_t operations)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(stop - start).count() /
+               operations;
+    }
+
+    inline void report (const std::string& name, double ns)
+    {
+        std::cout << std::left << std::setw(56) << name
+                  << std::right << std::setw(10) << std::fixed
+                  << std::setprecision(2) << ns << " ns\n";
+    }
+
+    inline std::size_t size_arg (int argc, char* argv[], int i,
+                                 std::size_t default_value)
+    {
+        return i < argc ? std::strtoul(argv[i], nullptr, 10) : default_value;
+    }
+}
+
+#endif // BENCHMARK_HH
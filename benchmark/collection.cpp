@@ -0,0 +1,157 @@
+// Compares summing foo() over a std::vector<SBO::Fooable> holding two types
+// in pseudo-random order, one stored in the small buffer and one on the heap,
+// with the same values in a type_erasure::collection<Ref::FooableView>:
+// visited through the erased reference, and visited with both types known,
+// which makes the per-segment loops direct calls.
+//
+// usage: collection_benchmark [largest size]
+//
+// Sizes go from 1000 up to the largest size (10 million by default) in steps
+// of 10.  100 million elements need about 8 GB.
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../test/sbo/interface.hh"
+#include "../test/ref/interface.hh"
+#include "benchmark.hh"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Small
+    {
+        explicit Small (int value) :
+            value_(value)
+        {}
+
+        int foo() const
+        {
+            return value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_;
+    };
+
+    // Too large for the small buffer.
+    struct Large
+    {
+        explicit Large (int value)
+        {
+            values_[0] = value;
+        }
+
+        int foo() const
+        {
+            return 2 * values_[0];
+        }
+
+        void set_value(int val)
+        {
+            values_[0] = val;
+        }
+
+    private:
+        std::array<int, 12> values_ = {{}};
+    };
+
+    using Collection = type_erasure::collection<Ref::FooableView>;
+
+    struct Sum
+    {
+        template <typename T>
+        void operator() (const T& value)
+        {
+            sum += value.foo();
+        }
+
+        int sum = 0;
+    };
+
+    template <typename T>
+    void add (std::vector<SBO::Fooable>& fooables, T value)
+    {
+        fooables.push_back(std::move(value));
+    }
+
+    template <typename T>
+    void add (Collection& collection, T value)
+    {
+        collection.insert(std::move(value));
+    }
+
+    template <typename Container>
+    void fill (Container& container, std::size_t size)
+    {
+        unsigned int state = 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            state = state * 1103515245u + 12345u;
+            if (state & 0x10000)
+                add(container, Small(static_cast<int>(i)));
+            else
+                add(container, Large(static_cast<int>(i)));
+        }
+    }
+
+    // Repeats f() so that each size visits about the same number of
+    // elements in total.
+    template <typename F>
+    double time_passes (std::size_t size, F f)
+    {
+        const std::size_t passes = size < 10000000 ? 10000000 / size : 1;
+        return Benchmark::ns_per_op([&] {
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                f();
+            }
+        }, passes * size);
+    }
+
+    void run (std::size_t size)
+    {
+        const std::string suffix = ", " + std::to_string(size) + " elements";
+
+        {
+            std::vector<SBO::Fooable> fooables;
+            fooables.reserve(size);
+            fill(fooables, size);
+            Benchmark::report("vector<SBO::Fooable>" + suffix, time_passes(size, [&] {
+                int sum = 0;
+                for (const SBO::Fooable& fooable : fooables) {
+                    sum += fooable.foo();
+                }
+                Benchmark::escape(sum);
+            }));
+        }
+
+        Collection collection;
+        fill(collection, size);
+        Benchmark::report("collection, erased" + suffix, time_passes(size, [&] {
+            Sum sum = collection.for_each(Sum());
+            Benchmark::escape(sum);
+        }));
+        Benchmark::report("collection, known types" + suffix, time_passes(size, [&] {
+            Sum sum = collection.for_each<Small, Large>(Sum());
+            Benchmark::escape(sum);
+        }));
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t largest = Benchmark::size_arg(argc, argv, 1, 10000000);
+
+    std::cout << "times per element\n\n";
+
+    for (std::size_t size = 1000; size <= largest; size *= 10) {
+        run(size);
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Compares the shared_ptr-based cow form (COW::Fooable) with the intrusive
+// one (IntrusiveCOW::Fooable): the size of each erased object and of its heap
+// allocation, and the time taken to copy vectors of erased values and to
+// write to every element of such a copy.
+//
+// usage: cow_benchmark [vector size] [copies]
+
+#include "../test/cow/interface.hh"
+#include "../test/intrusive_cow/interface.hh"
+#include "benchmark.hh"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::size_t allocated_bytes = 0;
+}
+
+void* operator new (std::size_t size)
+{
+    allocated_bytes += size;
+    if (void* ptr = std::malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete (void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    struct Value
+    {
+        explicit Value (int value) :
+            value_(value)
+        {}
+
+        int foo() const
+        {
+            return value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_;
+    };
+
+    template <typename Fooable>
+    std::vector<Fooable> make_fooables (std::size_t size)
+    {
+        std::vector<Fooable> retval;
+        retval.reserve(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            retval.push_back(Value(static_cast<int>(i)));
+        }
+        return retval;
+    }
+
+    template <typename Fooable>
+    std::size_t heap_bytes_per_value ()
+    {
+        const std::size_t before = allocated_bytes;
+        Fooable fooable = Value(0);
+        Benchmark::escape(fooable);
+        return allocated_bytes - before;
+    }
+
+    template <typename Fooable>
+    double copy_vector (std::size_t size, std::size_t copies)
+    {
+        const std::vector<Fooable> fooables = make_fooables<Fooable>(size);
+        return Benchmark::ns_per_op([&] {
+            for (std::size_t i = 0; i < copies; ++i) {
+                std::vector<Fooable> copy(fooables);
+                Benchmark::escape(copy);
+            }
+        }, size * copies);
+    }
+
+    // Every write detaches the element from the original, cloning it.
+    template <typename Fooable>
+    double copy_and_write (std::size_t size, std::size_t copies)
+    {
+        const std::vector<Fooable> fooables = make_fooables<Fooable>(size);
+        return Benchmark::ns_per_op([&] {
+            for (std::size_t i = 0; i < copies; ++i) {
+                std::vector<Fooable> copy(fooables);
+                for (Fooable& fooable : copy) {
+                    fooable.set_value(1);
+                }
+                Benchmark::escape(copy);
+            }
+        }, size * copies);
+    }
+
+    template <typename Fooable>
+    void run (const std::string& name, std::size_t size, std::size_t copies)
+    {
+        std::cout << name << ": " << sizeof(Fooable) << " bytes per object, "
+                  << heap_bytes_per_value<Fooable>() << " bytes on the heap\n";
+        Benchmark::report("copy vector<" + name + ">",
+                          copy_vector<Fooable>(size, copies));
+        Benchmark::report("copy vector<" + name + ">, write all",
+                          copy_and_write<Fooable>(size, copies));
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t size = Benchmark::size_arg(argc, argv, 1, 1000);
+    const std::size_t copies = Benchmark::size_arg(argc, argv, 2, 1000);
+
+    // Makes std::shared_ptr use atomic operations, as it does in every
+    // program that ever starts a thread.
+    std::thread([] {}).join();
+
+    std::cout << "times per element, " << size << " elements, "
+              << copies << " copies\n\n";
+
+    run<COW::Fooable>("COW::Fooable", size, copies);
+    run<IntrusiveCOW::Fooable>("IntrusiveCOW::Fooable", size, copies);
+
+    return 0;
+}
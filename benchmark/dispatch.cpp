@@ -0,0 +1,126 @@
+// Compares dispatch through the virtual handle of forms/sbo.hpp with
+// dispatch through the per-type function pointer table of
+// forms/static_vtable.hpp, and through the function pointers copied into each
+// object by forms/inline_vtable.hpp, and through the switch over a closed set
+// of types of forms/closed.hpp.
+//
+// usage: dispatch_benchmark [calls] [vector size]
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../test/sbo/interface.hh"
+#include "../test/static_vtable/interface.hh"
+#include "../test/inline_vtable/interface.hh"
+#include "../test/closed/small_interface.hh"
+#include "../test/mock_fooable.hh"
+#include "benchmark.hh"
+
+#include <vector>
+
+namespace
+{
+    struct Doubler
+    {
+        int foo() const
+        {
+            return 2 * value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_ = Mock::value;
+    };
+
+    // Each call depends on the result of the previous one.
+    template <typename Fooable>
+    double call_latency (std::size_t calls)
+    {
+        Fooable fooable = Mock::MockFooable();
+        Benchmark::escape(fooable);
+
+        return Benchmark::ns_per_op([&] {
+            unsigned int sum = 1;
+            for (std::size_t i = 0; i < calls; ++i) {
+                fooable.set_value(static_cast<int>(sum & 0xff));
+                sum = sum * 31 + static_cast<unsigned int>(fooable.foo());
+            }
+            Benchmark::escape(sum);
+        }, 2 * calls);
+    }
+
+    // Two concrete types in pseudo-random order, so that the indirect branch
+    // is not trivially predictable.  A closed set can only hold the types it
+    // was generated for, so it gets a mock in place of Doubler.
+    template <typename Fooable, typename Other>
+    std::vector<Fooable> make_fooables (std::size_t size)
+    {
+        std::vector<Fooable> retval;
+        retval.reserve(size);
+        unsigned int state = 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            state = state * 1103515245u + 12345u;
+            if (state & 0x10000)
+                retval.push_back(Mock::MockFooable());
+            else
+                retval.push_back(Other());
+        }
+        return retval;
+    }
+
+    template <typename Fooable, typename Other = Doubler>
+    double vector_iteration (std::size_t size)
+    {
+        std::vector<Fooable> fooables = make_fooables<Fooable, Other>(size);
+        Benchmark::escape(fooables);
+
+        const std::size_t passes = 10;
+        return Benchmark::ns_per_op([&] {
+            int sum = 0;
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                for (const Fooable& fooable : fooables) {
+                    sum += fooable.foo();
+                }
+                Benchmark::escape(fooables);
+            }
+            Benchmark::escape(sum);
+        }, passes * size);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t calls = Benchmark::size_arg(argc, argv, 1, 100000000);
+    const std::size_t size = Benchmark::size_arg(argc, argv, 2, 1000000);
+
+    std::cout << "sizeof(SBO::Fooable) = " << sizeof(SBO::Fooable) << "\n"
+              << "sizeof(StaticVTable::Fooable) = "
+              << sizeof(StaticVTable::Fooable) << "\n"
+              << "sizeof(InlineVTable::Fooable) = "
+              << sizeof(InlineVTable::Fooable) << "\n"
+              << "sizeof(ClosedSmall::Fooable) = "
+              << sizeof(ClosedSmall::Fooable) << "\n\n";
+
+    Benchmark::report("call latency, SBO::Fooable",
+                      call_latency<SBO::Fooable>(calls));
+    Benchmark::report("call latency, StaticVTable::Fooable",
+                      call_latency<StaticVTable::Fooable>(calls));
+    Benchmark::report("call latency, InlineVTable::Fooable",
+                      call_latency<InlineVTable::Fooable>(calls));
+    Benchmark::report("call latency, ClosedSmall::Fooable",
+                      call_latency<ClosedSmall::Fooable>(calls));
+
+    Benchmark::report("vector<SBO::Fooable> iteration, per element",
+                      vector_iteration<SBO::Fooable>(size));
+    Benchmark::report("vector<StaticVTable::Fooable> iteration, per element",
+                      vector_iteration<StaticVTable::Fooable>(size));
+    Benchmark::report("vector<InlineVTable::Fooable> iteration, per element",
+                      vector_iteration<InlineVTable::Fooable>(size));
+    Benchmark::report("vector<ClosedSmall::Fooable> iteration, per element",
+                      vector_iteration<ClosedSmall::Fooable,
+                                       Mock::MockRelocatableFooable>(size));
+
+    return 0;
+}
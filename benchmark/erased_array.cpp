@@ -0,0 +1,147 @@
+// Compares a std::vector<SBO::Fooable> with a
+// type_erasure::erased_array<Ref::FooableRef> holding the same values of two
+// trivially copyable types: one small enough for the small buffer, and one
+// that SBO::Fooable stores on the heap.  Measures the memory used, and the
+// time taken to sum foo() over all values and to copy the container.
+//
+// usage: erased_array_benchmark [size]
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../test/sbo/interface.hh"
+#include "../test/ref/interface.hh"
+#include "benchmark.hh"
+
+#include <array>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace
+{
+    std::size_t allocated_bytes = 0;
+}
+
+void* operator new (std::size_t size)
+{
+    allocated_bytes += size;
+    if (void* ptr = std::malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete (void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    struct Small
+    {
+        explicit Small (int value) :
+            value_(value)
+        {}
+
+        int foo() const
+        {
+            return value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_;
+    };
+
+    // Too large for the small buffer.
+    struct Large
+    {
+        explicit Large (int value)
+        {
+            values_[0] = value;
+        }
+
+        int foo() const
+        {
+            return 2 * values_[0];
+        }
+
+        void set_value(int val)
+        {
+            values_[0] = val;
+        }
+
+    private:
+        std::array<int, 12> values_ = {{}};
+    };
+
+    using ErasedArray = type_erasure::erased_array<Ref::FooableRef>;
+
+    // One Large value in eight.
+    template <typename Container>
+    void fill (Container& container, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; ++i) {
+            if (i % 8)
+                container.push_back(Small(static_cast<int>(i)));
+            else
+                container.push_back(Large(static_cast<int>(i)));
+        }
+    }
+
+    template <typename Container, typename Fooable>
+    void run (const std::string& name, std::size_t size, Container& container)
+    {
+        std::cout << name << ": " << static_cast<double>(allocated_bytes) / size
+                  << " bytes per element\n";
+
+        Benchmark::report(name + ", sum", Benchmark::ns_per_op([&] {
+            const std::size_t passes = 10;
+            int sum = 0;
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                for (Fooable fooable : container) {
+                    sum += fooable.foo();
+                }
+                Benchmark::escape(container);
+            }
+            Benchmark::escape(sum);
+        }, 10 * size));
+
+        Benchmark::report(name + ", copy", Benchmark::ns_per_op([&] {
+            Container copy(container);
+            Benchmark::escape(copy);
+        }, size));
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t size = Benchmark::size_arg(argc, argv, 1, 1000000);
+
+    std::cout << "times per element, " << size << " elements\n\n";
+
+    {
+        allocated_bytes = 0;
+        std::vector<SBO::Fooable> fooables;
+        fooables.reserve(size);
+        fill(fooables, size);
+        run<std::vector<SBO::Fooable>, const SBO::Fooable&>(
+            "vector<SBO::Fooable>", size, fooables);
+    }
+
+    {
+        ErasedArray probe;
+        fill(probe, size);
+
+        allocated_bytes = 0;
+        ErasedArray array;
+        array.reserve_bytes(probe.bytes());
+        fill(array, size);
+        run<ErasedArray, Ref::FooableRef>("erased_array<Ref::FooableRef>", size, array);
+    }
+
+    return 0;
+}
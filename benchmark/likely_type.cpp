@@ -0,0 +1,90 @@
+// Compares iteration over forms/static_vtable.hpp objects generated with and
+// without --likely-type Mock::MockFooable, for mixes in which 100%, 90%, 50%
+// and 0% of the objects hold the likely type.  At 0% every guard fails, which
+// shows the cost of a wrong guess.
+//
+// usage: likely_type_benchmark [vector size]
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../test/static_vtable/interface.hh"
+#include "../test/static_vtable/likely_interface.hh"
+#include "../test/mock_fooable.hh"
+#include "benchmark.hh"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Doubler
+    {
+        int foo() const
+        {
+            return 2 * value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_ = Mock::value;
+    };
+
+    // The likely type in pseudo-random positions, so that the guard is not
+    // trivially predictable.
+    template <typename Fooable>
+    std::vector<Fooable> make_fooables (std::size_t size, unsigned int likely_percent)
+    {
+        std::vector<Fooable> retval;
+        retval.reserve(size);
+        unsigned int state = 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            state = state * 1103515245u + 12345u;
+            if ((state >> 16) % 100 < likely_percent)
+                retval.push_back(Mock::MockFooable());
+            else
+                retval.push_back(Doubler());
+        }
+        return retval;
+    }
+
+    template <typename Fooable>
+    double vector_iteration (std::size_t size, unsigned int likely_percent)
+    {
+        std::vector<Fooable> fooables = make_fooables<Fooable>(size, likely_percent);
+        Benchmark::escape(fooables);
+
+        const std::size_t passes = 10;
+        return Benchmark::ns_per_op([&] {
+            int sum = 0;
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                for (Fooable& fooable : fooables) {
+                    fooable.set_value(sum & 0xff);
+                    sum += fooable.foo();
+                }
+                Benchmark::escape(fooables);
+            }
+            Benchmark::escape(sum);
+        }, passes * size);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t size = Benchmark::size_arg(argc, argv, 1, 1000000);
+
+    std::cout << "set_value() and foo() per element, " << size << " elements\n\n";
+
+    const unsigned int likely_percents[] = {100, 90, 50, 0};
+    for (unsigned int likely_percent : likely_percents) {
+        const std::string suffix = ", " + std::to_string(likely_percent) + "% likely type";
+        Benchmark::report("StaticVTable::Fooable" + suffix,
+                          vector_iteration<StaticVTable::Fooable>(size, likely_percent));
+        Benchmark::report("StaticVTableLikely::Fooable" + suffix,
+                          vector_iteration<StaticVTableLikely::Fooable>(size, likely_percent));
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Compares a std::vector<COW::Fooable> with a
+// type_erasure::persistent_vector<COW::Fooable> holding the same values.
+// Measures the time taken to copy the container, to copy it and change one
+// value in the copy, and to sum foo() over all values.
+//
+// usage: persistent_vector_benchmark [size]
+
+#include "../test/cow/interface.hh"
+#include "benchmark.hh"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Payload
+    {
+        explicit Payload (int value) :
+            value_(value)
+        {}
+
+        int foo() const
+        {
+            return value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_;
+    };
+
+    using PersistentVector = type_erasure::persistent_vector<COW::Fooable>;
+
+    void set (std::vector<COW::Fooable>& container, std::size_t index, const COW::Fooable& value)
+    {
+        container[index] = value;
+    }
+
+    void set (PersistentVector& container, std::size_t index, const COW::Fooable& value)
+    {
+        container.set(index, value);
+    }
+
+    template <typename Container>
+    void run (const std::string& name, std::size_t size, const Container& container)
+    {
+        const std::size_t copies = 20;
+        const COW::Fooable value = Payload(-1);
+
+        Benchmark::report(name + ", copy", Benchmark::ns_per_op([&] {
+            for (std::size_t i = 0; i < copies; ++i) {
+                Container copy(container);
+                Benchmark::escape(copy);
+            }
+        }, copies));
+
+        Benchmark::report(name + ", copy and set one", Benchmark::ns_per_op([&] {
+            for (std::size_t i = 0; i < copies; ++i) {
+                Container copy(container);
+                set(copy, i * size / copies, value);
+                Benchmark::escape(copy);
+            }
+        }, copies));
+
+        Benchmark::report(name + ", sum per element", Benchmark::ns_per_op([&] {
+            const std::size_t passes = 10;
+            int sum = 0;
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                for (const COW::Fooable& fooable : container) {
+                    sum += fooable.foo();
+                }
+                Benchmark::escape(container);
+            }
+            Benchmark::escape(sum);
+        }, 10 * size));
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t size = Benchmark::size_arg(argc, argv, 1, 100000);
+
+    std::cout << "times per operation, " << size << " elements\n\n";
+
+    std::vector<COW::Fooable> fooables;
+    PersistentVector persistent;
+    for (std::size_t i = 0; i < size; ++i) {
+        fooables.push_back(Payload(static_cast<int>(i)));
+        persistent.push_back(Payload(static_cast<int>(i)));
+    }
+
+    run("vector<COW::Fooable>", size, fooables);
+    run("persistent_vector<COW::Fooable>", size, persistent);
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Compares construct/destroy throughput of erased values that do not fit the
+// small buffer, with their handles allocated by the global operator new
+// (malloc) or by type_erasure::thread_local_pool_resource(), with 1, 8 and
+// 32 threads running at once.
+//
+// usage: pool_benchmark [operations per thread]
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../test/pmr_sbo/interface.hh"
+#include "../test/pmr_cow/interface.hh"
+#include "benchmark.hh"
+
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Too large for the small buffer.
+    struct Payload
+    {
+        int foo() const
+        {
+            return values_[0];
+        }
+
+        void set_value(int val)
+        {
+            values_[0] = val;
+        }
+
+    private:
+        std::array<int, 12> values_ = {{}};
+    };
+
+    // Each thread keeps a window of live values, and replaces one of them
+    // with a new one per operation, so that allocation and deallocation
+    // interleave the way they do in real code.
+    template <typename Fooable>
+    void churn (type_erasure::memory_resource* resource, std::size_t operations)
+    {
+        std::vector<Fooable> window(64);
+        for (std::size_t i = 0; i < operations; ++i) {
+            window[i % window.size()] = Fooable(Payload(), resource);
+            Benchmark::escape(window);
+        }
+    }
+
+    // Returns the wall clock time per operation over all threads.
+    template <typename Fooable>
+    double construct_destroy (type_erasure::memory_resource* resource,
+                              std::size_t threads, std::size_t operations)
+    {
+        return Benchmark::ns_per_op([&] {
+            std::vector<std::thread> workers;
+            for (std::size_t i = 0; i < threads; ++i) {
+                workers.emplace_back([&] {
+                    churn<Fooable>(resource, operations);
+                });
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+        }, threads * operations);
+    }
+
+    template <typename Fooable>
+    void run (const std::string& name, std::size_t operations)
+    {
+        const std::size_t thread_counts[] = {1, 8, 32};
+        for (std::size_t threads : thread_counts) {
+            const std::string suffix =
+                ", " + std::to_string(threads) + " thread" + (threads == 1 ? "" : "s");
+            Benchmark::report(
+                name + ", malloc" + suffix,
+                construct_destroy<Fooable>(type_erasure::default_resource(),
+                                           threads, operations)
+            );
+            Benchmark::report(
+                name + ", thread-local pool" + suffix,
+                construct_destroy<Fooable>(type_erasure::thread_local_pool_resource(),
+                                           threads, operations)
+            );
+        }
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t operations = Benchmark::size_arg(argc, argv, 1, 1000000);
+
+    std::cout << "wall clock time per construct/destroy, "
+              << operations << " per thread, "
+              << std::thread::hardware_concurrency() << " hardware threads\n\n";
+
+    run<PMRSBO::Fooable>("PMRSBO::Fooable", operations);
+    run<PMRCOW::Fooable>("PMRCOW::Fooable", operations);
+
+    return 0;
+}
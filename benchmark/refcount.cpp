@@ -0,0 +1,83 @@
+// Measures copy-heavy use of erased values stored on the heap, where every
+// copy and every destruction of a copy updates the reference count of the
+// shared value: with an atomic count (SBOCOW::Fooable), with a plain one
+// (SBOCOWLocal::Fooable, generated with --ref-count
+// type_erasure::local_ref_count), and with std::shared_ptr (COW::Fooable).
+//
+// usage: refcount_benchmark [vector size] [copies]
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../test/sbo_cow/interface.hh"
+#include "../test/sbo_cow/local_interface.hh"
+#include "../test/cow/interface.hh"
+#include "benchmark.hh"
+
+#include <array>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Too large for the small buffer.
+    struct Payload
+    {
+        explicit Payload (int value)
+        {
+            values_[0] = value;
+        }
+
+        int foo() const
+        {
+            return values_[0];
+        }
+
+        void set_value(int val)
+        {
+            values_[0] = val;
+        }
+
+    private:
+        std::array<int, 12> values_ = {{}};
+    };
+
+    // Copies the whole vector over and over; reads through the copies do not
+    // detach them, so the cost is all in the reference counting.
+    template <typename Fooable>
+    double copy_vector (std::size_t size, std::size_t copies)
+    {
+        std::vector<Fooable> fooables;
+        for (std::size_t i = 0; i < size; ++i) {
+            fooables.push_back(Payload(static_cast<int>(i)));
+        }
+
+        return Benchmark::ns_per_op([&] {
+            for (std::size_t i = 0; i < copies; ++i) {
+                std::vector<Fooable> copy(fooables);
+                Benchmark::escape(copy);
+            }
+        }, size * copies);
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t size = Benchmark::size_arg(argc, argv, 1, 1000);
+    const std::size_t copies = Benchmark::size_arg(argc, argv, 2, 10000);
+
+    // Makes std::shared_ptr use atomic operations, as it does in every
+    // program that ever starts a thread.
+    std::thread([] {}).join();
+
+    std::cout << "times per copied element, " << size << " elements, "
+              << copies << " copies\n\n";
+
+    Benchmark::report("copy vector<SBOCOW::Fooable>, atomic count",
+                      copy_vector<SBOCOW::Fooable>(size, copies));
+    Benchmark::report("copy vector<SBOCOWLocal::Fooable>, local count",
+                      copy_vector<SBOCOWLocal::Fooable>(size, copies));
+    Benchmark::report("copy vector<COW::Fooable>, std::shared_ptr",
+                      copy_vector<COW::Fooable>(size, copies));
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+// Measures how fast vectors of erased values grow and sort, that is how fast
+// the erased types move.  Values that are trivially relocatable, either
+// because they are trivially copyable or because they opt in with
+// type_erasure::is_trivially_relocatable, are moved by copying their bytes;
+// everything else goes through its move constructor and destructor.
+//
+// usage: relocation_benchmark [vector size]
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../test/sbo/interface.hh"
+#include "../test/sbo_cow/interface.hh"
+#include "../test/static_vtable/interface.hh"
+#include "benchmark.hh"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Trivially copyable, and thus trivially relocatable.
+    struct Plain
+    {
+        explicit Plain (int value) :
+            value_(value)
+        {}
+
+        int foo() const
+        {
+            return value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_;
+    };
+
+    // Has a move constructor and a destructor of its own, as any type with
+    // members like std::unique_ptr does.
+    struct Tracked
+    {
+        explicit Tracked (int value) :
+            value_(value)
+        {}
+
+        Tracked (const Tracked& other) noexcept :
+            value_(other.value_)
+        {}
+
+        Tracked (Tracked&& other) noexcept :
+            value_(other.value_)
+        {
+            other.value_ = 0;
+        }
+
+        Tracked& operator= (const Tracked& other) noexcept
+        {
+            value_ = other.value_;
+            return *this;
+        }
+
+        ~Tracked ()
+        {
+            Benchmark::escape(value_);
+        }
+
+        int foo() const
+        {
+            return value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_;
+    };
+
+    // The same, but declared safe to move by copying its bytes.
+    struct Relocatable : Tracked
+    {
+        explicit Relocatable (int value) :
+            Tracked(value)
+        {}
+    };
+}
+
+namespace type_erasure
+{
+    template <>
+    struct is_trivially_relocatable<Relocatable> : std::true_type
+    {};
+}
+
+namespace
+{
+    template <typename Fooable, typename Value>
+    std::vector<Fooable> make_fooables (std::size_t size)
+    {
+        std::vector<Fooable> retval;
+        unsigned int state = 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            state = state * 1103515245u + 12345u;
+            retval.push_back(Value(static_cast<int>(state >> 8)));
+        }
+        return retval;
+    }
+
+    // Grows the vector one element at a time, so that every element is moved
+    // about once per doubling of the capacity.
+    template <typename Fooable, typename Value>
+    double grow (std::size_t size)
+    {
+        return Benchmark::ns_per_op([&] {
+            std::vector<Fooable> fooables = make_fooables<Fooable, Value>(size);
+            Benchmark::escape(fooables);
+        }, size);
+    }
+
+    template <typename Fooable, typename Value>
+    double sort (std::size_t size)
+    {
+        std::vector<Fooable> fooables = make_fooables<Fooable, Value>(size);
+        Benchmark::escape(fooables);
+
+        return Benchmark::ns_per_op([&] {
+            std::sort(fooables.begin(), fooables.end(),
+                      [](const Fooable& lhs, const Fooable& rhs) {
+                          return lhs.foo() < rhs.foo();
+                      });
+            Benchmark::escape(fooables);
+        }, size);
+    }
+
+    template <typename Fooable>
+    void run (const std::string& name, std::size_t size)
+    {
+        Benchmark::report("grow vector<" + name + ">, Plain",
+                          grow<Fooable, Plain>(size));
+        Benchmark::report("grow vector<" + name + ">, Tracked",
+                          grow<Fooable, Tracked>(size));
+        Benchmark::report("grow vector<" + name + ">, Relocatable",
+                          grow<Fooable, Relocatable>(size));
+        Benchmark::report("sort vector<" + name + ">, Plain",
+                          sort<Fooable, Plain>(size));
+        Benchmark::report("sort vector<" + name + ">, Tracked",
+                          sort<Fooable, Tracked>(size));
+        Benchmark::report("sort vector<" + name + ">, Relocatable",
+                          sort<Fooable, Relocatable>(size));
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t size = Benchmark::size_arg(argc, argv, 1, 10000000);
+
+    std::cout << "times per element, " << size << " elements\n\n";
+
+    run<SBO::Fooable>("SBO::Fooable", size);
+    run<SBOCOW::Fooable>("SBOCOW::Fooable", size);
+    run<StaticVTable::Fooable>("StaticVTable::Fooable", size);
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Compares a type_erasure::slot_map<SBO::Fooable> with objects held by
+// std::shared_ptr<SBO::Fooable>, both referenced from elsewhere by their
+// handles or pointers.  Measures the time taken to insert and erase, to look
+// a value up through a handle or pointer, and to sum foo() over all values.
+//
+// usage: slot_map_benchmark [size]
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../test/sbo/interface.hh"
+#include "benchmark.hh"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Payload
+    {
+        explicit Payload (int value) :
+            value_(value)
+        {}
+
+        int foo() const
+        {
+            return value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_;
+    };
+
+    using SlotMap = type_erasure::slot_map<SBO::Fooable>;
+    using SharedPtr = std::shared_ptr<SBO::Fooable>;
+
+    // Each run references the values in a shuffled order, the way other
+    // structures would.
+    std::vector<std::size_t> shuffled (std::size_t size)
+    {
+        std::vector<std::size_t> retval(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            retval[i] = i;
+        }
+        std::shuffle(retval.begin(), retval.end(), std::mt19937(42));
+        return retval;
+    }
+
+    void run_slot_map (std::size_t size, const std::vector<std::size_t>& order)
+    {
+        SlotMap map;
+        std::vector<SlotMap::handle> handles(size);
+
+        Benchmark::report("slot_map, insert", Benchmark::ns_per_op([&] {
+            for (std::size_t i = 0; i < size; ++i) {
+                handles[i] = map.insert(Payload(static_cast<int>(i)));
+            }
+            Benchmark::escape(map);
+        }, size));
+
+        Benchmark::report("slot_map, lookup", Benchmark::ns_per_op([&] {
+            int sum = 0;
+            for (std::size_t i : order) {
+                sum += map[handles[i]].foo();
+            }
+            Benchmark::escape(sum);
+        }, size));
+
+        Benchmark::report("slot_map, sum", Benchmark::ns_per_op([&] {
+            int sum = 0;
+            for (const SBO::Fooable& fooable : map) {
+                sum += fooable.foo();
+            }
+            Benchmark::escape(sum);
+        }, size));
+
+        Benchmark::report("slot_map, erase", Benchmark::ns_per_op([&] {
+            for (std::size_t i : order) {
+                map.erase(handles[i]);
+            }
+            Benchmark::escape(map);
+        }, size));
+    }
+
+    void run_shared_ptr (std::size_t size, const std::vector<std::size_t>& order)
+    {
+        std::vector<SharedPtr> pointers(size);
+
+        Benchmark::report("shared_ptr, insert", Benchmark::ns_per_op([&] {
+            for (std::size_t i = 0; i < size; ++i) {
+                pointers[i] = std::make_shared<SBO::Fooable>(Payload(static_cast<int>(i)));
+            }
+            Benchmark::escape(pointers);
+        }, size));
+
+        Benchmark::report("shared_ptr, lookup", Benchmark::ns_per_op([&] {
+            int sum = 0;
+            for (std::size_t i : order) {
+                sum += pointers[i]->foo();
+            }
+            Benchmark::escape(sum);
+        }, size));
+
+        Benchmark::report("shared_ptr, sum", Benchmark::ns_per_op([&] {
+            int sum = 0;
+            for (const SharedPtr& pointer : pointers) {
+                sum += pointer->foo();
+            }
+            Benchmark::escape(sum);
+        }, size));
+
+        Benchmark::report("shared_ptr, erase", Benchmark::ns_per_op([&] {
+            for (std::size_t i : order) {
+                pointers[i].reset();
+            }
+            Benchmark::escape(pointers);
+        }, size));
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t size = Benchmark::size_arg(argc, argv, 1, 1000000);
+    const std::vector<std::size_t> order = shuffled(size);
+
+    std::cout << "times per element, " << size << " elements\n\n";
+
+    run_slot_map(size, order);
+    run_shared_ptr(size, order);
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Compares three calls through the erased interface of SBOVisit::Fooable,
+// foo(), set_value() and foo() again, with the same three calls made inside
+// one visit(), which looks up the stored type once and then calls the
+// concrete type directly.
+//
+// usage: visit_benchmark [vector size]
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../test/sbo/visit_interface.hh"
+#include "../test/mock_fooable.hh"
+#include "benchmark.hh"
+
+#include <vector>
+
+namespace
+{
+    // Works on the concrete types given to emtypen with --visit-type, and on
+    // the erased object for all others.
+    struct Increment
+    {
+        template <typename Fooable>
+        int operator() (Fooable& fooable) const
+        {
+            const int value = fooable.foo();
+            fooable.set_value(value + 1);
+            return fooable.foo();
+        }
+    };
+
+    std::vector<SBOVisit::Fooable> make_fooables (std::size_t size)
+    {
+        std::vector<SBOVisit::Fooable> retval;
+        retval.reserve(size);
+        unsigned int state = 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            state = state * 1103515245u + 12345u;
+            if (state & 0x10000)
+                retval.push_back(Mock::MockFooable());
+            else
+                retval.push_back(Mock::MockLargeFooable());
+        }
+        return retval;
+    }
+
+    template <typename F>
+    double per_element (std::vector<SBOVisit::Fooable>& fooables, F f)
+    {
+        const std::size_t passes = 10;
+        return Benchmark::ns_per_op([&] {
+            int sum = 0;
+            for (std::size_t pass = 0; pass < passes; ++pass) {
+                for (SBOVisit::Fooable& fooable : fooables) {
+                    sum += f(fooable);
+                }
+                Benchmark::escape(fooables);
+            }
+            Benchmark::escape(sum);
+        }, passes * fooables.size());
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    const std::size_t size = Benchmark::size_arg(argc, argv, 1, 1000000);
+
+    std::cout << "foo(), set_value() and foo() per element, " << size << " elements\n\n";
+
+    std::vector<SBOVisit::Fooable> fooables = make_fooables(size);
+
+    Benchmark::report("three erased calls", per_element(fooables, [](SBOVisit::Fooable& fooable) {
+        return Increment()(fooable);
+    }));
+    Benchmark::report("one visit()", per_element(fooables, [](SBOVisit::Fooable& fooable) {
+        return fooable.visit(Increment());
+    }));
+
+    return 0;
+}
@@ -20,8 +20,11 @@ class client_data:
         self.current_struct = null_cursor
         self.current_struct_prefix = ''
         # function signature, forwarding call arguments, optional return
-        # keyword, function name, and "const"/"" for function constness
-        self.member_functions = [] # each element [''] * 5
+        # keyword, function name, "const"/"" for function constness, return
+        # type, parameter list, attributes, ref-qualifier, exception
+        # specification and function signature without the exception
+        # specification
+        self.member_functions = [] # each element [''] * 11
         self.printed_headers = False
         self.filename = ''
         self.include_guarded = False
@@ -29,6 +32,14 @@ class client_data:
         self.form_lines = []
         self.headers = ''
         self.copy_on_write = False
+        self.dispatch = 'handle'
+        self.inline_vtable_limit = 3
+        self.buffer_size = 'SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE'
+        self.buffer_alignment = 'SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT'
+        self.ref_count = 'std::atomic_size_t'
+        self.types = []
+        self.likely_type = ''
+        self.visit_types = []
 
 def get_tokens (tu, cursor):
     return [x for x in tu.get_tokens(extent=cursor.extent)]
@@ -91,35 +102,45 @@ def struct_prefix (struct_cursor):
 
     return retval
 
+scalar_type_kinds = [
+    'BOOL', 'CHAR_U', 'UCHAR', 'CHAR16', 'CHAR32', 'USHORT', 'UINT', 'ULONG',
+    'ULONGLONG', 'UINT128', 'CHAR_S', 'SCHAR', 'WCHAR', 'SHORT', 'INT', 'LONG',
+    'LONGLONG', 'INT128', 'FLOAT', 'DOUBLE', 'LONGDOUBLE', 'NULLPTR', 'POINTER',
+    'MEMBERPOINTER', 'BLOCKPOINTER', 'ENUM'
+]
+
+# A parameter taken by value or by rvalue reference belongs to the forwarding
+# function, so it is moved on to the next call instead of being copied again.
+# Lvalue references, and scalars, which a move would only copy, are passed on
+# by name.
+def forwarded_arg (arg_cursor):
+    kind = arg_cursor.type.get_canonical().kind
+    scalar_kinds = [getattr(clang.cindex.TypeKind, name) for name in scalar_type_kinds
+                    if hasattr(clang.cindex.TypeKind, name)]
+    if kind == clang.cindex.TypeKind.LVALUEREFERENCE or kind in scalar_kinds:
+        return arg_cursor.spelling
+    return 'std::move(' + arg_cursor.spelling + ')'
+
 def member_params (cursor):
     tokens = get_tokens(data.tu, cursor)
 
     open_brace = '{'
     semicolon = ';'
     close_paren = ')'
-    const_token = 'const'
     comma = ','
 
-    str = ''
-    constness = ''
+    spellings = []
 
     identifier_regex = re.compile(r'[_a-zA-Z][_a-zA-Z0-9]*')
 
     probably_args = []
-    close_paren_seen = False
     for i in range(len(tokens)):
         spelling = tokens[i].spelling
         if identifier_regex.match(spelling) and i < len(tokens) - 1 and (tokens[i + 1].spelling == comma or tokens[i + 1].spelling == close_paren):
             probably_args.append(spelling)
-        if close_paren_seen and spelling == const_token:
-            constness = 'const'
-        if spelling == close_paren:
-            close_paren_seen = True
         if spelling == open_brace or spelling == semicolon:
             break
-        if i:
-            str += ' '
-        str += spelling
+        spellings.append(spelling)
 
     args = [x for x in cursor.get_arguments()]
     args_str = ''
@@ -141,99 +162,352 @@ these possibly-wrong, heuristically-determined parameter names instead:
             break
         if i:
             args_str += ', '
-        args_str += arg_cursor.spelling
+        args_str += forwarded_arg(arg_cursor)
 
     return_str = cursor.result_type.kind != clang.cindex.TypeKind.VOID and 'return ' or ''
 
-    return [str, args_str, return_str, function_name, constness]
+    attributes, spellings = split_attributes(spellings)
+    # Depending on the version, libclang may leave leading attributes out of
+    # the extent of the declaration.
+    nodiscard_kind = getattr(clang.cindex.CursorKind, 'WARN_UNUSED_RESULT_ATTR', None)
+    if not attributes and nodiscard_kind is not None and \
+       [x for x in cursor.get_children() if x.kind == nodiscard_kind]:
+        attributes = ['[[nodiscard]]']
+
+    return_type, params, close_paren_index = return_type_and_params(spellings, function_name)
+    constness, ref_qualifier, exception_spec, spec_begin, spec_end = \
+        trailing_qualifiers(spellings, close_paren_index)
+
+    signature = ' '.join(spellings)
+    throwing_signature = ' '.join(spellings[:spec_begin] + spellings[spec_end:])
+
+    return [signature, args_str, return_str, function_name, constness, return_type, params,
+            ''.join([x + ' ' for x in attributes]), ref_qualifier, exception_spec,
+            throwing_signature]
+
+# Removes C++11 attributes, such as [[nodiscard]], from the spellings of a
+# declaration.  Returns them separately, since they must come before any
+# "virtual" in the generated declarations.
+def split_attributes (spellings):
+    attributes = []
+    rest = []
+    i = 0
+    while i < len(spellings):
+        if spellings[i] == '[' and i + 1 < len(spellings) and spellings[i + 1] == '[':
+            depth = 0
+            j = i
+            while j < len(spellings):
+                if spellings[j] == '[':
+                    depth += 1
+                elif spellings[j] == ']':
+                    depth -= 1
+                    if depth == 0:
+                        break
+                j += 1
+            attributes.append(''.join(spellings[i:j + 1]))
+            i = j + 1
+        else:
+            rest.append(spellings[i])
+            i += 1
+    return [attributes, rest]
+
+def return_type_and_params (spellings, function_name):
+    open_paren = '('
+    close_paren = ')'
+    specifiers = ['virtual', 'static', 'inline', 'explicit']
+
+    name_index = 0
+    for i in range(len(spellings) - 1):
+        if spellings[i] == function_name and spellings[i + 1] == open_paren:
+            name_index = i
+            break
+
+    return_type = ' '.join(
+        [x for x in spellings[:name_index] if x not in specifiers]
+    )
+
+    params = []
+    depth = 0
+    close_paren_index = len(spellings)
+    for i in range(name_index + 1, len(spellings)):
+        spelling = spellings[i]
+        if spelling == close_paren:
+            depth -= 1
+            if depth == 0:
+                close_paren_index = i
+                break
+        if depth:
+            params.append(spelling)
+        if spelling == open_paren:
+            depth += 1
+
+    return [return_type, ' '.join(params), close_paren_index]
+
+# Returns the cv-qualifier, ref-qualifier and exception specification that
+# follow the parameter list ending at close_paren_index, and the range of
+# spellings taken by the exception specification.
+def trailing_qualifiers (spellings, close_paren_index):
+    constness = ''
+    ref_qualifier = ''
+    exception_spec = ''
+    spec_begin = spec_end = len(spellings)
+
+    i = close_paren_index + 1
+    while i < len(spellings):
+        spelling = spellings[i]
+        if spelling == '=':
+            break
+        if spelling == 'const':
+            constness = 'const'
+        elif spelling == '&' or spelling == '&&':
+            ref_qualifier = spelling
+        elif spelling == 'noexcept' or spelling == 'throw':
+            j = i + 1
+            if j < len(spellings) and spellings[j] == '(':
+                depth = 0
+                while j < len(spellings):
+                    if spellings[j] == '(':
+                        depth += 1
+                    elif spellings[j] == ')':
+                        depth -= 1
+                        if depth == 0:
+                            break
+                    j += 1
+                j += 1
+            exception_spec = ' '.join(spellings[i:j])
+            spec_begin = i
+            spec_end = j
+            i = j
+            continue
+        i += 1
+
+    return [constness, ref_qualifier, exception_spec, spec_begin, spec_end]
 
 def indent_lines (lines):
     regex = re.compile(r'\n')
     indentation = indent()
     return regex.sub('\n' + indentation, indentation + lines)
 
+expansion_names = [
+    'nonvirtual_members',
+    'bind_members',
+    'pure_virtual_members',
+    'virtual_members',
+    'vtable_members',
+    'vtable_thunks',
+    'vtable_initializers'
+]
+
 def find_expansion_lines (lines):
-    retval = [0] * 3
+    retval = []
     for i in range(len(lines)):
         line = lines[i]
-        try:
-            nonvirtual_pos = line.index('{nonvirtual_members}')
-        except:
-            nonvirtual_pos = -1
-        try:
-            pure_virtual_pos = line.index('{pure_virtual_members}')
-        except:
-            pure_virtual_pos = -1
-        try:
-            virtual_pos = line.index('{virtual_members}')
-        except:
-            virtual_pos = -1
-        if nonvirtual_pos != -1:
-            retval[0] = (i, nonvirtual_pos)
-        elif pure_virtual_pos != -1:
-            retval[1] = (i, pure_virtual_pos)
-        elif virtual_pos != -1:
-            retval[2] = (i, virtual_pos)
+        for name in expansion_names:
+            try:
+                pos = line.index('{' + name + '}')
+            except:
+                continue
+            retval.append((i, name, pos))
+            break
+    return retval
+
+def vtable_entry_names ():
+    retval = []
+    for function in data.member_functions:
+        name = function[3]
+        overload = 0
+        while name in retval:
+            overload += 1
+            name = function[3] + '_' + str(overload)
+        retval.append(name)
+    return retval
+
+def object_param (function):
+    return (function[4] == 'const' and 'const void* ' or 'void* ') + 'object_'
+
+# The object expression a forwarded call is made on.  An rvalue-qualified
+# function is called on an rvalue, so that it can consume the stored value.
+def call_object (function, object_):
+    if function[8] == '&&':
+        return 'std::move(' + object_ + ')'
+    return object_
+
+def exception_spec (function):
+    return function[9] != '' and ' ' + function[9] or ''
+
+def thunk_params (function):
+    retval = object_param(function)
+    if function[6] != '':
+        retval += ', ' + function[6]
     return retval
 
+def expansion_block (block_lines, pos):
+    return '\n'.join([' ' * pos + line for line in block_lines])
+
+def snake_case_name (name):
+    name = re.sub(r'([A-Z]+)([A-Z][a-z])', r'\1_\2', name)
+    name = re.sub(r'([a-z0-9])([A-Z])', r'\1_\2', name)
+    return name.lower()
+
+def inline_vtable ():
+    return len(data.member_functions) <= data.inline_vtable_limit and 'true' or 'false'
+
 def close_struct ():
     lines = data.form_lines
 
     expansion_lines = find_expansion_lines(lines)
 
+    placeholders = dict([(name, '{' + name + '}') for name in expansion_names])
+
     lines = map(
         lambda line: line.format(
             struct_prefix=data.current_struct_prefix,
             struct_name=data.current_struct.spelling,
-            nonvirtual_members='{nonvirtual_members}',
-            pure_virtual_members='{pure_virtual_members}',
-            virtual_members='{virtual_members}'
+            snake_case_name=snake_case_name(data.current_struct.spelling),
+            inline_vtable=inline_vtable(),
+            buffer_size=data.buffer_size,
+            buffer_alignment=data.buffer_alignment,
+            ref_count=data.ref_count,
+            closed_types=', '.join(data.types),
+            visit_types=', '.join(data.visit_types),
+            **placeholders
         ),
         lines
     )
 
     nonvirtual_members = ''
+    bind_members = ''
     pure_virtual_members = ''
     virtual_members = ''
+    vtable_members = []
+    vtable_thunks = []
+    vtable_initializers = []
 
     function_offset = 2;
 
-    for function in data.member_functions:
-        if data.copy_on_write:
+    entry_names = vtable_entry_names()
+
+    for i in range(len(data.member_functions)):
+        function = data.member_functions[i]
+        entry_name = entry_names[i]
+        if data.dispatch == 'vtable':
+            object_args = 'object()'
+            if function[1] != '':
+                object_args += ', ' + function[1]
+            likely_call = ''
+            if data.likely_type != '':
+                direct_call = call_object(function, 'value_of< ' + data.likely_type + ' >()') + \
+                    '.' + function[3] + '(' + function[1] + ' );\n'
+                if function[2] != '':
+                    likely_call = \
+                        indent(function_offset) + 'if (holds< ' + data.likely_type + ' >())\n' + \
+                        indent(function_offset + 1) + function[2] + direct_call
+                else:
+                    likely_call = \
+                        indent(function_offset) + 'if (holds< ' + data.likely_type + ' >()) {\n' + \
+                        indent(function_offset + 1) + direct_call + \
+                        indent(function_offset + 1) + 'return;\n' + \
+                        indent(function_offset) + '}\n'
+            nonvirtual_members += \
+                indentation + function[7] + function[0] + '\n' + \
+                indentation + '{\n' + \
+                indent(function_offset) + 'assert(vtable_);\n' + \
+                likely_call + \
+                indent(function_offset) + function[2] + 'vtable().' + entry_name + \
+                '(' + object_args + ' );\n' + \
+                indentation + '}\n'
+            delegate_type = 'type_erasure::delegate<' + function[5] + ' (' + \
+                thunk_params(function) + ')>'
+            bind_members += \
+                indentation + delegate_type + ' bind_' + entry_name + ' ()' + \
+                (function[4] == 'const' and ' const' or '') + '\n' + \
+                indentation + '{\n' + \
+                indent(function_offset) + 'assert(vtable_);\n' + \
+                indent(function_offset) + 'return ' + delegate_type + '(object(), vtable().' + \
+                entry_name + ', this, &bound_generation);\n' + \
+                indentation + '}\n'
+        elif data.dispatch == 'switch':
+            cases = ''
+            for j in range(len(data.types)):
+                label = j < len(data.types) - 1 and 'case ' + str(j + 1) or 'default'
+                cases += \
+                    indent(function_offset) + label + ': return ' + \
+                    call_object(function, 'value_of< ' + data.types[j] + ' >()') + '.' + \
+                    function[3] + '(' + function[1] + ' );\n'
             nonvirtual_members += \
-                indentation + function[0] + '\n' + \
+                indentation + function[7] + function[0] + '\n' + \
+                indentation + '{\n' + \
+                indent(function_offset) + 'assert(index_);\n' + \
+                indent(function_offset) + 'switch (index_) {\n' + \
+                cases + \
+                indent(function_offset) + '}\n' + \
+                indentation + '}\n'
+        elif data.copy_on_write:
+            # write() may have to copy the value, so a non-const function
+            # cannot keep its exception specification.
+            nonvirtual_members += \
+                indentation + function[7] + \
+                (function[4] == 'const' and function[0] or function[10]) + '\n' + \
                 indentation + '{\n' + \
 		indent(function_offset) + 'assert(handle_);\n' + \
 		indent(function_offset) +  function[2] + \
-                (function[4] == 'const' and 'read().' or 'write().') + \
+                call_object(function, function[4] == 'const' and 'read()' or 'write()') + '.' + \
                 function[3] + '(' + function[1] + ' );\n' + \
 		indentation + '}\n'
         else:
             nonvirtual_members += \
-                indentation + function[0] + '\n' + \
+                indentation + function[7] + function[0] + '\n' + \
                 indentation + '{\n' + \
                 indent(function_offset) + 'assert(handle_);\n' + \
-		indent(function_offset) + function[2] + 'handle_->' + function[3] + \
+		indent(function_offset) + function[2] + \
+                (function[8] == '&&' and 'std::move(*handle_).' or 'handle_->') + function[3] + \
                 '(' + function[1] + ' );\n' + \
                 indentation + '}\n'
 
         pure_virtual_members += \
-            indentation * 2 + 'virtual ' + function[0] + ' = 0;\n'
+            indentation * 2 + function[7] + 'virtual ' + function[0] + ' = 0;\n'
 
         virtual_members += \
-            indentation * 2 + 'virtual ' + function[0] + ' {\n' + \
+            indentation * 2 + function[7] + 'virtual ' + function[0] + ' {\n' + \
             indentation * 3 + function[2] + \
-            'value_.' + function[3] + \
+            call_object(function, 'value_') + '.' + function[3] + \
             '(' + function[1] + ' );\n' + \
             indentation * 2 + '}\n'
 
+        vtable_members.append(
+            function[5] + ' (*' + entry_name + ') (' + thunk_params(function) + ')' + \
+                exception_spec(function) + ';'
+        )
+
+        vtable_thunks.extend([
+            'static ' + function[5] + ' ' + entry_name + ' (' + thunk_params(function) + ')' + \
+                exception_spec(function),
+            '{',
+            indentation + function[2] + \
+                (function[8] == '&&' and 'rvalue_of(object_).' or 'value_of(object_).') + function[3] + \
+                '(' + function[1] + ' );',
+            '}'
+        ])
+
+        vtable_initializers.append('&' + entry_name + ',')
+
     nonvirtual_members = nonvirtual_members[:-1]
+    bind_members = bind_members[:-1]
     pure_virtual_members = pure_virtual_members[:-1]
     virtual_members = virtual_members[:-1]
 
-    lines[expansion_lines[0][0]] = nonvirtual_members
-    lines[expansion_lines[1][0]] = pure_virtual_members
-    lines[expansion_lines[2][0]] = virtual_members
+    expansions = {
+        'nonvirtual_members': lambda pos: nonvirtual_members,
+        'bind_members': lambda pos: bind_members,
+        'pure_virtual_members': lambda pos: pure_virtual_members,
+        'virtual_members': lambda pos: virtual_members,
+        'vtable_members': lambda pos: expansion_block(vtable_members, pos),
+        'vtable_thunks': lambda pos: expansion_block(vtable_thunks, pos),
+        'vtable_initializers': lambda pos: expansion_block(vtable_initializers, pos)
+    }
+
+    for (i, name, pos) in expansion_lines:
+        lines[i] = expansions[name](pos)
 
     output[0] += '\n'
     for line in lines:
@@ -385,9 +659,46 @@ archetype by name, along with "struct", "class", "template <...>" etc.
 
 %struct_name% - This is replaced with only the archetype's name.
 
+%snake_case_name% - This is replaced with the archetype's name in snake case,
+for instance "fooable" for Fooable, or "aligned_fooable" for AlignedFooable.
+The forms use it to name their make_*() functions.
+
+%buffer_size% and %buffer_alignment% - These are replaced with the size and
+alignment of the small buffer, for forms that have one.  They default to the
+macros SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE and
+SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT, which the matching header files
+define as 24 and alignof(void*) unless they are already defined.  Use
+--buffer-size and --buffer-alignment to give each interface its own values.
+
+%ref_count% - This is replaced with the type of the reference count, for
+forms that count references themselves (such as forms/sbo_cow.hpp and
+forms/intrusive_cow.hpp).  forms/sbo_cow.hpp only counts references to
+values on the heap.  It defaults to std::atomic_size_t.  For erased
+objects that never leave their thread, --ref-count
+type_erasure::local_ref_count gives a plain counter; the headers of both forms
+define it, and in debug builds it asserts that it is only used on the thread
+that created it.
+
+%closed_types% - This is replaced with the types given with --type, separated
+by commas, for forms that can only hold a fixed set of types (such as
+forms/closed.hpp).
+
+%visit_types% - This is replaced with the types given with --visit-type,
+separated by commas, for forms with a visit() member (such as forms/sbo.hpp).
+visit(f) calls f on the stored value with its concrete type if it is one of
+these, after a single lookup of the stored type, and calls f on the erased
+object itself otherwise.  f must return the same type for all of them.
+
 %nonvirtual_members% - This is the generated portion of the API of the erased
 type.  It is replaced with a version of the functions in the archetype that
-forwards each call to the virtual functions in the handle object.
+forwards each call to the virtual functions in the handle object.  Parameters
+taken by value or by rvalue reference are passed on with std::move() at each
+step, so an argument is copied no more often than by a direct call.
+Attributes such as [[nodiscard]], ref-qualifiers and exception specifications
+are kept.  Functions qualified with && are called on the stored value as an
+rvalue, so they can consume it.  Copy-on-write forms drop the exception
+specification of non-const functions, since making the value unique may
+throw.
 
 %pure_virtual_members% - This is the generated portion of the API of the
 handle base class. It is replaced with pure virtual declarations of the
@@ -397,6 +708,31 @@ functions in the archetype.
 handle class. It is replaced with virtual function definitions of the
 functions in the archetype that forward to the underlying held value.
 
+Forms that dispatch through a table of function pointers instead of a virtual
+handle (such as forms/static_vtable.hpp) use these instead of, or in addition
+to, the ones above.  Unlike the ones above, they are indented to the column at
+which they appear in the form:
+
+%vtable_members% - This is replaced with one function pointer declaration per
+function in the archetype.  Each takes the object as its first parameter, as
+"const void* object_" for const functions and "void* object_" otherwise,
+followed by the archetype function's parameters.  Overloads get distinct
+names by appending "_1", "_2", etc.
+
+%vtable_thunks% - This is replaced with static functions matching the entries
+declared by %vtable_members%.  Each forwards to the held value, which it
+obtains by calling value_of(object_); the form must provide value_of().
+
+%vtable_initializers% - This is replaced with the address of each thunk
+declared by %vtable_thunks%, in the same order as %vtable_members%, each
+followed by a comma.
+
+%inline_vtable% - This is replaced with "true" if the archetype has no more
+functions than the limit given by --inline-vtable-limit, and "false"
+otherwise.  Forms that copy the function pointer table into each object (such
+as forms/inline_vtable.hpp) use it to fall back to a shared table for larger
+archetypes.
+
 Within the constraints implied by the pattern of code generation outlined
 above, the form can include anything you like.
 
@@ -410,6 +746,39 @@ handle.  They may be public or private.  read() will be called in every const
 member function in the archetype's API, and write() will be called in every
 non-const member function.
 
+Similarly, if you specify on the command line that your form dispatches
+through a function pointer table (see emtypen --help for details), the
+generated forwarding functions assert that a member called vtable_ is set,
+and call the table entry in vtable() with object() as the first argument.
+vtable() must return a reference to the table, and object() must return a
+const/non-const void pointer to whatever the thunks expect as object_.
+
+With --likely-type, such forwarding functions first check whether the object
+holds the given type, and if so call the function on it directly, where the
+compiler can inline it; other types go through vtable() as before.  The form
+must provide holds<T>(), which returns whether the stored value is a T without
+an indirect call (forms/static_vtable.hpp and forms/inline_vtable.hpp compare
+their table pointer with the address of T's table), and value_of<T>(), which
+returns a const/non-const reference to the stored value.  Name the type most objects hold.
+
+%bind_members% - For forms that dispatch through a function pointer table,
+this is replaced with one function per function in the archetype, named
+bind_ followed by the table entry's name.  Each returns a
+type_erasure::delegate holding object() and the table entry, so that the
+function can later be called without a lookup.  The form must provide a
+static function bound_generation(), which takes a pointer to the erased
+object as const void* and returns a count that changes whenever the object
+is given a new value or moved from; with TYPE_ERASURE_CHECK_DELEGATES
+defined, the delegate uses it to check that the object has not changed since
+the delegate was bound.
+
+Forms for a closed set of types use --dispatch switch.  There, each generated
+forwarding function asserts that a member called index_ is nonzero, and
+switches on it: index_ 1 calls the function on value_of<T>() for the first
+type given with --type, 2 for the second, and so on, with the last type as
+the default case.  value_of<T>() must return a const/non-const reference to
+the stored value.
+
 
 The Header file
 
@@ -417,12 +786,17 @@ The header file should contain all headers, macros, forward declarations,
 etc. required by the code in the form.  Headers required by the code in an
 archetype file should be included there, not in the header file.
 
+More than one header file may be given.  They are prepended in the order
+given, so optional support code (such as headers/pool_resource.hpp) can be
+added after the form's own header file.
+
 
 Command Line Options
 
 An alternate form file and/or header file can be specified on the command
 line.  Also, you will probably need to generate slightly different code for
-forms that use copy-on-write.  See emtypen --help for details.
+forms that use copy-on-write or function pointer tables.  See emtypen --help
+for details.
 
 '''
 
@@ -457,8 +831,25 @@ if '--manual' in sys.argv:
 
 parser = argparse.ArgumentParser(description='Generates type erased C++ code.')
 parser.add_argument('--form', type=str, required=True, help='form used to generate code')
-parser.add_argument('--headers', type=str, required=False, help='file containing headers to prepend to the generated code')
+parser.add_argument('--headers', type=str, required=False, action='append',
+                    help='file containing headers to prepend to the generated code; may be given more than once')
 parser.add_argument('--copy-on-write', type=str, required=False, help='generate code suitable for a COW implementation')
+parser.add_argument('--dispatch', type=str, required=False, default='handle', choices=['handle', 'vtable', 'switch'],
+                    help='generate forwarding functions that call through a handle (default), a function pointer table, or a switch over the types given with --type')
+parser.add_argument('--inline-vtable-limit', type=int, required=False, default=3,
+                    help='largest number of functions for which %%inline_vtable%% is true (default 3)')
+parser.add_argument('--buffer-size', type=str, required=False, default='SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE',
+                    help='size in bytes of the small buffer (default SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE)')
+parser.add_argument('--buffer-alignment', type=str, required=False, default='SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT',
+                    help='alignment in bytes of the small buffer (default SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT)')
+parser.add_argument('--ref-count', type=str, required=False, default='std::atomic_size_t',
+                    help='type of the reference count in forms that have one (default std::atomic_size_t)')
+parser.add_argument('--type', type=str, required=False, action='append', dest='types',
+                    help='type that a closed form (--dispatch switch) can hold; give once per type')
+parser.add_argument('--visit-type', type=str, required=False, action='append', dest='visit_types',
+                    help='type that visit() passes to its function object directly; give once per type')
+parser.add_argument('--likely-type', type=str, required=False, default='',
+                    help='type that most objects hold; forwarding functions (--dispatch vtable) call it directly after checking for it')
 parser.add_argument('--out-file', type=str, required=False, help='write output to given file')
 parser.add_argument('--clang-path', type=str, required=False, help='path to libclang library')
 parser.add_argument('--manual', action='store_true', required=False, help='print a much longer manual to the terminal')
@@ -475,11 +866,27 @@ from_main_file = clang.cindex.conf.lib.clang_Location_isFromMainFile
 
 data = client_data()
 data.copy_on_write = args.copy_on_write == "True"
+data.dispatch = args.dispatch
+data.inline_vtable_limit = args.inline_vtable_limit
+data.buffer_size = args.buffer_size
+data.buffer_alignment = args.buffer_alignment
+data.ref_count = args.ref_count
+data.types = args.types or []
+data.likely_type = args.likely_type
+data.visit_types = args.visit_types or []
+
+if data.dispatch == 'switch' and not data.types:
+    os.write(2, 'emtypen: --dispatch switch requires at least one --type\n')
+    exit(1)
+
+if data.likely_type != '' and data.dispatch != 'vtable':
+    os.write(2, 'emtypen: --likely-type requires --dispatch vtable\n')
+    exit(1)
 
 data.form = prepare_form(open(args.form).read())
 data.form_lines = prepare_form(open(args.form).readlines())
 
-data.headers = args.headers and open(args.headers).read() or ''
+data.headers = ''.join([open(headers).read() for headers in args.headers or []])
 
 include_guarded = False
 archetypes = open(args.file).read()
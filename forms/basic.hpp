@@ -25,6 +25,16 @@ public:
         : handle_ ( std::move(rhs.handle_) )
     {}
 
+    // Constructs a T from args in place.
+    template <typename T, typename... Args>
+    explicit %struct_name% ( type_erasure::in_place_type_t<T>, Args&&... args ) :
+        handle_ (
+            new Handle<T>(
+                type_erasure::in_place_type_t<T>(), std::forward<Args>( args )...
+            )
+        )
+    {}
+
     // Assignment
     template <typename T,
               typename std::enable_if<
@@ -51,32 +61,98 @@ public:
         return *this;
     }
 
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        handle_.reset(
+            new Handle<T>(
+                type_erasure::in_place_type_t<T>(), std::forward<Args>( args )...
+            )
+        );
+        return value_of<T>();
+    }
+
     template <typename T>
     T* cast()
     {
         assert(handle_);
-        Handle<T>* handle = dynamic_cast<Handle<T>*>( handle_.get() );
-        if(handle)
-            return &handle->value_;
-        return nullptr;
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<Handle<T>*>( handle_.get() )->value_;
     }
 
     template <typename T>
     const T* cast() const
     {
         assert(handle_);
-        const Handle<T>* handle = dynamic_cast<const Handle<T>*>( handle_.get() );
-        if(handle)
-            return &handle->value_;
-        return nullptr;
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<const Handle<T>*>( handle_.get() )->value_;
+    }
+
+    // Calls f(value) on the stored value if its type is one of those given to
+    // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+    // looked up once, so the calls f makes on value can be inlined.
+    template <typename F>
+    auto visit (F&& f) -> decltype(f(std::declval<%struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    template <typename F>
+    auto visit (F&& f) const -> decltype(f(std::declval<const %struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
     }
 
     %nonvirtual_members%
 
 private:
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename... Ts>
+    struct VisitTypes
+    {};
+
+    template <typename F, typename Self>
+    static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+    {
+        return f(self);
+    }
+
+    template <typename F, typename Self, typename T, typename... Ts>
+    static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+    {
+        if (id == type_id<T>())
+            return f(self.template value_of<T>());
+        return visit_impl(f, self, id, VisitTypes<Ts...>());
+    }
+
+    template <typename T>
+    T& value_of ()
+    {
+        return static_cast<Handle<T>*>(handle_.get())->value_;
+    }
+
+    template <typename T>
+    const T& value_of () const
+    {
+        return static_cast<const Handle<T>*>(handle_.get())->value_;
+    }
+
     struct HandleBase
     {
         virtual ~HandleBase () {}
+        virtual const void* type_id () const noexcept = 0;
         virtual HandleBase * clone () const = 0;
 
         %pure_virtual_members%
@@ -102,11 +178,21 @@ private:
             : value_( std::forward<U>(value) )
         {}
 
+        template <typename... Args>
+        explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+            : value_( std::forward<Args>(args)... )
+        {}
+
         virtual HandleBase* clone () const
         { 
           return new Handle(value_);
         }
 
+        virtual const void* type_id () const noexcept
+        {
+            return %struct_name%::type_id<T>();
+        }
+
         %virtual_members%
 
         T value_;
@@ -122,3 +208,10 @@ private:
 
     std::unique_ptr<HandleBase> handle_;
 };
+
+// Constructs a T from args in place, in a new %struct_name%.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
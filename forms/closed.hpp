@@ -0,0 +1,155 @@
+%struct_prefix%
+{
+private:
+    // The types that can be stored, in the order of their index.
+    using Types = type_erasure::closed_set<%closed_types%>;
+
+public:
+    // Contructors
+    %struct_name% () = default;
+
+    template <typename T,
+              typename std::enable_if<
+                  Types::template index_of<typename std::decay<T>::type>() != 0
+                  >::type* = nullptr>
+    %struct_name% (T&& value) noexcept ( std::is_nothrow_constructible<typename std::decay<T>::type, T&&>::value )
+    {
+        ::new (static_cast<void*>(&storage_)) typename std::decay<T>::type(std::forward<T>(value));
+        index_ = Types::template index_of<typename std::decay<T>::type>();
+    }
+
+    // Constructs a T from args in place.
+    template <typename T, typename... Args,
+              typename std::enable_if<
+                  Types::template index_of<T>() != 0
+                  >::type* = nullptr>
+    explicit %struct_name% (type_erasure::in_place_type_t<T>, Args&&... args)
+    {
+        ::new (static_cast<void*>(&storage_)) T(std::forward<Args>(args)...);
+        index_ = Types::template index_of<T>();
+    }
+
+    %struct_name% (const %struct_name%& rhs)
+    {
+        if (rhs.index_) {
+            Types::copy(rhs.index_, &rhs.storage_, &storage_);
+            index_ = rhs.index_;
+        }
+    }
+
+    %struct_name% (%struct_name%&& rhs) noexcept ( Types::nothrow_movable() )
+    {
+        move_from(rhs);
+    }
+
+    // Assignment
+    template <typename T,
+              typename std::enable_if<
+                  Types::template index_of<typename std::decay<T>::type>() != 0
+                  >::type* = nullptr>
+    %struct_name%& operator= (T&& value)
+    {
+        %struct_name% temp(std::forward<T>(value));
+        reset();
+        move_from(temp);
+        return *this;
+    }
+
+    %struct_name%& operator= (const %struct_name%& rhs)
+    {
+        %struct_name% temp(rhs);
+        reset();
+        move_from(temp);
+        return *this;
+    }
+
+    %struct_name%& operator= (%struct_name%&& rhs) noexcept ( Types::nothrow_movable() )
+    {
+        if (this != &rhs) {
+            reset();
+            move_from(rhs);
+        }
+        return *this;
+    }
+
+    ~%struct_name% ()
+    {
+        reset();
+    }
+
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.
+    template <typename T, typename... Args,
+              typename std::enable_if<
+                  Types::template index_of<T>() != 0
+                  >::type* = nullptr>
+    T& emplace (Args&&... args)
+    {
+        reset();
+        ::new (static_cast<void*>(&storage_)) T(std::forward<Args>(args)...);
+        index_ = Types::template index_of<T>();
+        return value_of<T>();
+    }
+
+    template <typename T>
+    T* cast()
+    {
+        assert(index_);
+        if (index_ != Types::template index_of<T>())
+            return nullptr;
+        return &value_of<T>();
+    }
+
+    template <typename T>
+    const T* cast() const
+    {
+        assert(index_);
+        if (index_ != Types::template index_of<T>())
+            return nullptr;
+        return &value_of<T>();
+    }
+
+    %nonvirtual_members%
+
+private:
+    using Storage = typename std::aligned_storage<Types::max_size(), Types::max_alignment()>::type;
+
+    template <typename T>
+    T& value_of ()
+    {
+        return *static_cast<T*>(static_cast<void*>(&storage_));
+    }
+
+    template <typename T>
+    const T& value_of () const
+    {
+        return *static_cast<const T*>(static_cast<const void*>(&storage_));
+    }
+
+    void move_from (%struct_name%& rhs) noexcept ( Types::nothrow_movable() )
+    {
+        if (rhs.index_) {
+            Types::move(rhs.index_, &rhs.storage_, &storage_);
+            index_ = rhs.index_;
+            rhs.reset();
+        }
+    }
+
+    void reset () noexcept
+    {
+        if (index_) {
+            Types::destroy(index_, &storage_);
+            index_ = 0;
+        }
+    }
+
+    Storage storage_;
+    std::size_t index_ = 0;
+};
+
+// Constructs a T from args in place, in a new %struct_name%.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
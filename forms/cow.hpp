@@ -17,6 +17,16 @@ public:
         )
     {}
 
+    // Constructs a T from args in place.
+    template <typename T, typename... Args>
+    explicit %struct_name% (type_erasure::in_place_type_t<T>, Args&&... args) :
+        handle_ (
+            std::make_shared< Handle<T> >(
+                type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+            )
+        )
+    {}
+
     // Assignment
     template <typename T,
               typename std::enable_if<
@@ -30,32 +40,56 @@ public:
         return *this;
     }
 
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.  Writing through the reference after the object is copied
+    // would change the copies too.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        handle_ = std::make_shared< Handle<T> >(
+            type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+        );
+        return value_of<T>();
+    }
+
     template <typename T>
     T* cast()
     {
         assert(handle_);
-        Handle<T>* handle = dynamic_cast<Handle<T>*>( handle_.get() );
-        if(handle)
-            return &handle->value_;
-        return nullptr;
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<Handle<T>*>( handle_.get() )->value_;
     }
 
     template <typename T>
     const T* cast() const
     {
         assert(handle_);
-        const Handle<T>* handle = dynamic_cast<const Handle<T>*>( handle_.get() );
-        if(handle)
-            return &handle->value_;
-        return nullptr;
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<const Handle<T>*>( handle_.get() )->value_;
     }
 
     %nonvirtual_members%
 
 private:
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename T>
+    T& value_of ()
+    {
+        return static_cast<Handle<T>*>(handle_.get())->value_;
+    }
+
     struct HandleBase
     {
         virtual ~HandleBase () {}
+        virtual const void* type_id () const noexcept = 0;
         virtual std::shared_ptr<HandleBase> clone () const = 0;
 
         %pure_virtual_members%
@@ -81,11 +115,21 @@ private:
             : value_( std::forward<U>(value) )
         {}
 
+        template <typename... Args>
+        explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+            : value_( std::forward<Args>(args)... )
+        {}
+
         virtual std::shared_ptr<HandleBase> clone () const
         {
             return std::make_shared<Handle>(value_);
         }
 
+        virtual const void* type_id () const noexcept
+        {
+            return %struct_name%::type_id<T>();
+        }
+
         %virtual_members%
 
         T value_;
@@ -113,3 +157,10 @@ private:
 
     std::shared_ptr<HandleBase> handle_;
 };
+
+// Constructs a T from args in place, in a new %struct_name%.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
@@ -0,0 +1,437 @@
+%struct_prefix%
+{
+public:
+    // Contructors
+    %struct_name% () = default;
+
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name% (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                         std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+    {
+        construct<typename std::decay<T>::type>(std::forward<T>(value));
+    }
+
+    // Constructs a T from args in place.
+    template <typename T, typename... Args>
+    explicit %struct_name% (type_erasure::in_place_type_t<T>, Args&&... args)
+    {
+        construct<T>(std::forward<Args>(args)...);
+    }
+
+    %struct_name% (const %struct_name%& rhs) :
+        vtable_ (rhs.vtable_)
+    {
+        if (vtable_)
+            vtable_.table->copy(rhs.object(), object());
+    }
+
+    %struct_name% (%struct_name%&& rhs) noexcept :
+        vtable_ (rhs.vtable_),
+        storage_ (rhs.storage_)
+    {
+        rhs.vtable_.set(nullptr);
+        rhs.invalidate_delegates();
+    }
+
+    // Assignment
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name%& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                    std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+    {
+        %struct_name% temp(std::forward<T>(value));
+        swap(temp);
+        return *this;
+    }
+
+    %struct_name%& operator= (const %struct_name%& rhs)
+    {
+        %struct_name% temp(rhs);
+        swap(temp);
+        return *this;
+    }
+
+    %struct_name%& operator= (%struct_name%&& rhs) noexcept
+    {
+        %struct_name% temp(std::move(rhs));
+        swap(temp);
+        return *this;
+    }
+
+    ~%struct_name% ()
+    {
+        reset();
+    }
+
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        reset();
+        construct<T>(std::forward<Args>(args)...);
+        return Thunks<T, !stored_inline<T>()>::stored(object());
+    }
+
+    template <typename T>
+    T* cast()
+    {
+        assert(vtable_);
+        if (vtable_.table->type_id != &type_id<T>)
+            return nullptr;
+        return &Thunks<T, !stored_inline<T>()>::stored(object());
+    }
+
+    template <typename T>
+    const T* cast() const
+    {
+        assert(vtable_);
+        if (vtable_.table->type_id != &type_id<T>)
+            return nullptr;
+        return &Thunks<T, !stored_inline<T>()>::stored(object());
+    }
+
+    // Calls f(value) on the stored value if its type is one of those given to
+    // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+    // looked up once, so the calls f makes on value can be inlined.
+    template <typename F>
+    auto visit (F&& f) -> decltype(f(std::declval<%struct_name%&>()))
+    {
+        assert(vtable_);
+        return visit_impl(f, *this, vtable_.table->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    template <typename F>
+    auto visit (F&& f) const -> decltype(f(std::declval<const %struct_name%&>()))
+    {
+        assert(vtable_);
+        return visit_impl(f, *this, vtable_.table->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    // The storage slot, and what fits in it.  Values are kept in the slot only
+    // if they are trivially relocatable, so that moving is a plain memberwise
+    // copy; everything else lives on the heap, with the slot holding the
+    // pointer.
+    static constexpr std::size_t buffer_size ()
+    {
+        return sizeof(Storage);
+    }
+
+    static constexpr std::size_t buffer_alignment ()
+    {
+        return alignof(Storage);
+    }
+
+    static constexpr std::size_t inline_capacity ()
+    {
+        return sizeof(Storage);
+    }
+
+    template <typename T>
+    static constexpr bool stored_inline ()
+    {
+        return sizeof(T) <= sizeof(Storage) &&
+               alignof(T) <= alignof(Storage) &&
+               type_erasure::is_trivially_relocatable<T>::value;
+    }
+
+    %nonvirtual_members%
+
+    %bind_members%
+
+private:
+    using Storage = typename std::aligned_storage<%buffer_size%, %buffer_alignment%>::type;
+
+    // The entries used by the forwarding functions.  Every entry takes a
+    // pointer to storage_ as its object parameter.
+    struct Members
+    {
+        %vtable_members%
+    };
+
+    // One table per stored type and storage location, built at compile time.
+    struct VTable
+    {
+        // cast() compares this with &type_id<T>, so it makes no indirect call.
+        const void* (*type_id) ();
+        void (*copy) (const void* from, void* to);
+        void (*destroy) (void* object_);
+        Members members;
+    };
+
+    // Points to the shared table, and for small interfaces also keeps a copy
+    // of its Members, so that a call is a single indirect call with no table
+    // load.
+    template <bool Inline, typename Dummy = void>
+    struct Dispatch
+    {
+        void set (const VTable* vtable)
+        {
+            table = vtable;
+            if (table)
+                members = table->members;
+        }
+
+        const Members& get () const
+        {
+            return members;
+        }
+
+        explicit operator bool () const
+        {
+            return table != nullptr;
+        }
+
+        const VTable* table = nullptr;
+        Members members;
+    };
+
+    template <typename Dummy>
+    struct Dispatch<false, Dummy>
+    {
+        void set (const VTable* vtable)
+        {
+            table = vtable;
+        }
+
+        const Members& get () const
+        {
+            return table->members;
+        }
+
+        explicit operator bool () const
+        {
+            return table != nullptr;
+        }
+
+        const VTable* table = nullptr;
+    };
+
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename... Ts>
+    struct VisitTypes
+    {};
+
+    template <typename F, typename Self>
+    static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+    {
+        return f(self);
+    }
+
+    template <typename F, typename Self, typename T, typename... Ts>
+    static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+    {
+        if (id == type_id<T>())
+            return f(self.template value_of<T>());
+        return visit_impl(f, self, id, VisitTypes<Ts...>());
+    }
+
+    template <typename T>
+    struct Unwrap
+    {
+        using type = T;
+
+        static T& get (T& value)
+        {
+            return value;
+        }
+
+        static const T& get (const T& value)
+        {
+            return value;
+        }
+    };
+
+    template <typename T>
+    struct Unwrap<std::reference_wrapper<T>>
+    {
+        using type = T;
+
+        static T& get (std::reference_wrapper<T> ref)
+        {
+            return ref.get();
+        }
+    };
+
+    template <typename T, bool HeapAllocated>
+    struct Thunks
+    {
+        template <typename... Args>
+        static void construct (void* object_, Args&&... args)
+        {
+            if (HeapAllocated)
+                *static_cast<T**>(object_) = new T(std::forward<Args>(args)...);
+            else
+                new (object_) T(std::forward<Args>(args)...);
+        }
+
+        static T& stored (void* object_)
+        {
+            return HeapAllocated ?
+                **static_cast<T**>(object_) :
+                *static_cast<T*>(object_);
+        }
+
+        static const T& stored (const void* object_)
+        {
+            return HeapAllocated ?
+                **static_cast<T* const*>(object_) :
+                *static_cast<const T*>(object_);
+        }
+
+        static typename Unwrap<T>::type& value_of (void* object_)
+        {
+            return Unwrap<T>::get(stored(object_));
+        }
+
+        static const typename Unwrap<T>::type& value_of (const void* object_)
+        {
+            return Unwrap<T>::get(stored(object_));
+        }
+
+        // For rvalue-qualified functions, which may consume the value.
+        static typename Unwrap<T>::type&& rvalue_of (void* object_)
+        {
+            return std::move(value_of(object_));
+        }
+
+        static const typename Unwrap<T>::type&& rvalue_of (const void* object_)
+        {
+            return std::move(value_of(object_));
+        }
+
+        static void copy (const void* from, void* to)
+        {
+            construct(to, stored(from));
+        }
+
+        static void destroy (void* object_)
+        {
+            if (HeapAllocated)
+                delete &stored(object_);
+            else
+                stored(object_).~T();
+        }
+
+        %vtable_thunks%
+
+        static const VTable* table ()
+        {
+            static constexpr VTable table = {
+                &type_id<T>,
+                &copy,
+                &destroy,
+                {
+                    %vtable_initializers%
+                }
+            };
+            return &table;
+        }
+    };
+
+    // Expects this to be empty.
+    template <typename T, typename... Args>
+    void construct (Args&&... args)
+    {
+        using StoredThunks = Thunks<T, !stored_inline<T>()>;
+
+        StoredThunks::construct(object(), std::forward<Args>(args)...);
+        vtable_.set(StoredThunks::table());
+    }
+
+    void swap (%struct_name%& rhs) noexcept
+    {
+        std::swap(vtable_, rhs.vtable_);
+        std::swap(storage_, rhs.storage_);
+        invalidate_delegates();
+        rhs.invalidate_delegates();
+    }
+
+    void reset ()
+    {
+        if (vtable_)
+            vtable_.table->destroy(object());
+        vtable_.set(nullptr);
+        invalidate_delegates();
+    }
+
+    const Members& vtable () const
+    {
+        return vtable_.get();
+    }
+
+    // With TYPE_ERASURE_CHECK_DELEGATES defined, counts the times this object
+    // has been given a new value or moved from, and the delegates returned by
+    // the bind_*() members check that the count has not changed since they
+    // were bound.
+    static std::size_t bound_generation (const void* owner)
+    {
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+        return static_cast<const %struct_name%*>(owner)->generation_;
+#else
+        (void)owner;
+        return 0;
+#endif
+    }
+
+    void invalidate_delegates () noexcept
+    {
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+        ++generation_;
+#endif
+    }
+
+    // Each stored type has its own table, so comparing the table pointer
+    // identifies it without an indirect call.
+    template <typename T>
+    bool holds () const
+    {
+        return vtable_.table == Thunks<T, !stored_inline<T>()>::table();
+    }
+
+    template <typename T>
+    typename Unwrap<T>::type& value_of ()
+    {
+        return Thunks<T, !stored_inline<T>()>::value_of(object());
+    }
+
+    template <typename T>
+    const typename Unwrap<T>::type& value_of () const
+    {
+        return Thunks<T, !stored_inline<T>()>::value_of(object());
+    }
+
+    void* object ()
+    {
+        return &storage_;
+    }
+
+    const void* object () const
+    {
+        return &storage_;
+    }
+
+    Dispatch<%inline_vtable%> vtable_;
+    Storage storage_;
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+    std::size_t generation_ = 0;
+#endif
+};
+
+// Constructs a T from args in place, in a new %struct_name%.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
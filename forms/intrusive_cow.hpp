@@ -0,0 +1,217 @@
+%struct_prefix%
+{
+public:
+    // Contructors
+    %struct_name% () = default;
+
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name% (T&& value) :
+        handle_ (
+            new Handle<typename std::decay<T>::type>(
+                std::forward<T>(value)
+            )
+        )
+    {}
+
+    %struct_name% (const %struct_name% & rhs) noexcept :
+        handle_ (rhs.handle_)
+    {
+        if (handle_)
+            ++handle_->ref_count_;
+    }
+
+    %struct_name% (%struct_name% && rhs) noexcept :
+        handle_ (rhs.handle_)
+    {
+        rhs.handle_ = nullptr;
+    }
+
+    ~%struct_name% ()
+    {
+        release();
+    }
+
+    // Constructs a T from args in place.
+    template <typename T, typename... Args>
+    explicit %struct_name% (type_erasure::in_place_type_t<T>, Args&&... args) :
+        handle_ (
+            new Handle<T>(
+                type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+            )
+        )
+    {}
+
+    // Assignment
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name%& operator= (T&& value)
+    {
+        %struct_name% temp( std::forward<T>(value) );
+        std::swap(temp.handle_, handle_);
+        return *this;
+    }
+
+    %struct_name% & operator= (const %struct_name% & rhs) noexcept
+    {
+        %struct_name% temp(rhs);
+        std::swap(temp.handle_, handle_);
+        return *this;
+    }
+
+    %struct_name% & operator= (%struct_name% && rhs) noexcept
+    {
+        %struct_name% temp(std::move(rhs));
+        std::swap(temp.handle_, handle_);
+        return *this;
+    }
+
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.  Writing through the reference after the object is copied
+    // would change the copies too.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        HandleBase* const handle = new Handle<T>(
+            type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+        );
+        release();
+        handle_ = handle;
+        return value_of<T>();
+    }
+
+    template <typename T>
+    T* cast()
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<Handle<T>*>( handle_ )->value_;
+    }
+
+    template <typename T>
+    const T* cast() const
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<const Handle<T>*>( handle_ )->value_;
+    }
+
+    %nonvirtual_members%
+
+private:
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename T>
+    T& value_of ()
+    {
+        return static_cast<Handle<T>*>(handle_)->value_;
+    }
+
+    // The reference count lives in the handle, so that the erased object is a
+    // single pointer, and checking for sharing needs no virtual call.
+    struct HandleBase
+    {
+        HandleBase () noexcept :
+            ref_count_(1)
+        {}
+
+        virtual ~HandleBase () {}
+        virtual const void* type_id () const noexcept = 0;
+        virtual HandleBase* clone () const = 0;
+
+        %pure_virtual_members%
+
+        %ref_count% ref_count_;
+    };
+
+    template <typename T>
+    struct Handle : HandleBase
+    {
+        template <typename U,
+                  typename std::enable_if<
+                      !std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle( U&& value ) noexcept
+            : value_( value )
+        {}
+
+        template <typename U,
+                  typename std::enable_if<
+                      std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle( U&& value ) noexcept ( std::is_rvalue_reference<U>::value &&
+                                                std::is_nothrow_move_constructible<typename std::decay<U>::type>::value )
+            : value_( std::forward<U>(value) )
+        {}
+
+        template <typename... Args>
+        explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+            : value_( std::forward<Args>(args)... )
+        {}
+
+        virtual HandleBase* clone () const
+        {
+            return new Handle(value_);
+        }
+
+        virtual const void* type_id () const noexcept
+        {
+            return %struct_name%::type_id<T>();
+        }
+
+        %virtual_members%
+
+        T value_;
+    };
+
+    template <typename T>
+    struct Handle< std::reference_wrapper<T> > : Handle<T&>
+    {
+        Handle (std::reference_wrapper<T> ref)
+            : Handle<T&> (ref.get())
+        {}
+    };
+
+    // A count of one means that no other object can be copying the handle
+    // at the same time, so the last owner skips the atomic decrement.
+    void release () noexcept
+    {
+        if (handle_ && (handle_->ref_count_ == 1u || --handle_->ref_count_ == 0u))
+            delete handle_;
+    }
+
+    const HandleBase& read () const
+    {
+        return *handle_;
+    }
+
+    HandleBase& write ()
+    {
+        if (handle_->ref_count_ != 1u) {
+            HandleBase* const clone = handle_->clone();
+            release();
+            handle_ = clone;
+        }
+        return *handle_;
+    }
+
+    HandleBase* handle_ = nullptr;
+};
+
+// Constructs a T from args in place, in a new %struct_name%.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
@@ -0,0 +1,253 @@
+%struct_prefix%
+{
+public:
+    // Contructors
+    %struct_name% () = default;
+
+    explicit %struct_name% (type_erasure::memory_resource* resource) noexcept :
+        resource_ (resource)
+    {}
+
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value &&
+                  !std::is_convertible< T, type_erasure::memory_resource* >::value
+                  >::type* = nullptr>
+    %struct_name% (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                         std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ) :
+        handle_ (
+            std::allocate_shared< Handle<typename std::decay<T>::type> >(
+                Allocator<HandleBase>(resource_),
+                std::forward<T>(value)
+            )
+        )
+    {}
+
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name% (T&& value, type_erasure::memory_resource* resource) :
+        resource_ (resource),
+        handle_ (
+            std::allocate_shared< Handle<typename std::decay<T>::type> >(
+                Allocator<HandleBase>(resource_),
+                std::forward<T>(value)
+            )
+        )
+    {}
+
+    // Constructs a T from args in place.
+    template <typename T, typename... Args,
+              typename std::enable_if<
+                  !type_erasure::leads_with_resource<Args...>::value
+                  >::type* = nullptr>
+    explicit %struct_name% (type_erasure::in_place_type_t<T>, Args&&... args) :
+        handle_ (
+            std::allocate_shared< Handle<T> >(
+                Allocator<HandleBase>(resource_),
+                type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+            )
+        )
+    {}
+
+    template <typename T, typename... Args>
+    %struct_name% (type_erasure::in_place_type_t<T>, type_erasure::memory_resource* resource,
+                   Args&&... args) :
+        resource_ (resource),
+        handle_ (
+            std::allocate_shared< Handle<T> >(
+                Allocator<HandleBase>(resource_),
+                type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+            )
+        )
+    {}
+
+    // Assignment
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name%& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                    std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+    {
+        %struct_name% temp( std::forward<T>(value), resource_ );
+        std::swap(temp.handle_, handle_);
+        return *this;
+    }
+
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.  Writing through the reference after the object is copied
+    // would change the copies too.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        handle_ = std::allocate_shared< Handle<T> >(
+            Allocator<HandleBase>(resource_),
+            type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+        );
+        return value_of<T>();
+    }
+
+    template <typename T>
+    T* cast()
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<Handle<T>*>( handle_.get() )->value_;
+    }
+
+    template <typename T>
+    const T* cast() const
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<const Handle<T>*>( handle_.get() )->value_;
+    }
+
+    // The resource that values are allocated from, including the copies made
+    // when a shared value is written to.  It goes along with the value on
+    // copies, moves and assignments.
+    type_erasure::memory_resource* resource () const noexcept
+    {
+        return resource_;
+    }
+
+    %nonvirtual_members%
+
+private:
+    // Allocates from a memory_resource, for std::allocate_shared().
+    template <typename T>
+    struct Allocator
+    {
+        using value_type = T;
+
+        explicit Allocator (type_erasure::memory_resource* resource) noexcept :
+            resource_ (resource)
+        {}
+
+        template <typename U>
+        Allocator (const Allocator<U>& other) noexcept :
+            resource_ (other.resource_)
+        {}
+
+        T* allocate (std::size_t n)
+        {
+            return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate (T* ptr, std::size_t n)
+        {
+            resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+        }
+
+        template <typename U>
+        bool operator== (const Allocator<U>& rhs) const noexcept
+        {
+            return resource_ == rhs.resource_;
+        }
+
+        template <typename U>
+        bool operator!= (const Allocator<U>& rhs) const noexcept
+        {
+            return resource_ != rhs.resource_;
+        }
+
+        type_erasure::memory_resource* resource_;
+    };
+
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename T>
+    T& value_of ()
+    {
+        return static_cast<Handle<T>*>(handle_.get())->value_;
+    }
+
+    struct HandleBase
+    {
+        virtual ~HandleBase () {}
+        virtual const void* type_id () const noexcept = 0;
+        virtual std::shared_ptr<HandleBase> clone (type_erasure::memory_resource* resource) const = 0;
+
+        %pure_virtual_members%
+    };
+
+    template <typename T>
+    struct Handle : HandleBase
+    {
+        template <typename U,
+                  typename std::enable_if<
+                      !std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle( U&& value ) noexcept
+            : value_( value )
+        {}
+
+        template <typename U,
+                  typename std::enable_if<
+                      std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle( U&& value ) noexcept ( std::is_rvalue_reference<U>::value &&
+                                                std::is_nothrow_move_constructible<typename std::decay<U>::type>::value )
+            : value_( std::forward<U>(value) )
+        {}
+
+        template <typename... Args>
+        explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+            : value_( std::forward<Args>(args)... )
+        {}
+
+        virtual std::shared_ptr<HandleBase> clone (type_erasure::memory_resource* resource) const
+        {
+            return std::allocate_shared<Handle>(Allocator<Handle>(resource), value_);
+        }
+
+        virtual const void* type_id () const noexcept
+        {
+            return %struct_name%::type_id<T>();
+        }
+
+        %virtual_members%
+
+        T value_;
+    };
+
+    template <typename T>
+    struct Handle< std::reference_wrapper<T> > : Handle<T&>
+    {
+        Handle (std::reference_wrapper<T> ref)
+            : Handle<T&> (ref.get())
+        {}
+    };
+
+    const HandleBase& read () const
+    {
+        return *handle_;
+    }
+
+    HandleBase& write ()
+    {
+        if (!handle_.unique())
+            handle_ = handle_->clone(resource_);
+        return *handle_;
+    }
+
+    type_erasure::memory_resource* resource_ = type_erasure::default_resource();
+    std::shared_ptr<HandleBase> handle_;
+};
+
+// Constructs a T from args in place, in a new %struct_name%.  A leading
+// memory_resource* is used for the object's allocations instead.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
@@ -0,0 +1,393 @@
+%struct_prefix%
+{
+    public:
+    // Contructors
+    %struct_name% () = default;
+
+    explicit %struct_name% (type_erasure::memory_resource* resource) noexcept :
+        resource_ (resource)
+    {}
+
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value &&
+                  !std::is_convertible< T, type_erasure::memory_resource* >::value
+                  >::type* = nullptr>
+    %struct_name% (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                         std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+    {
+        handle_ = clone_impl( std::forward<T>(value), buffer_, resource_ );
+    }
+
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name% (T&& value, type_erasure::memory_resource* resource) :
+        resource_ (resource)
+    {
+        handle_ = clone_impl( std::forward<T>(value), buffer_, resource_ );
+    }
+
+    // Constructs a T from args in place.
+    template <typename T, typename... Args,
+              typename std::enable_if<
+                  !type_erasure::leads_with_resource<Args...>::value
+                  >::type* = nullptr>
+    explicit %struct_name% (type_erasure::in_place_type_t<T>, Args&&... args)
+    {
+        handle_ = emplace_impl<T>(buffer_, resource_, type_erasure::in_place_type_t<T>(),
+                                  std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename... Args>
+    %struct_name% (type_erasure::in_place_type_t<T>, type_erasure::memory_resource* resource,
+                   Args&&... args) :
+        resource_ (resource)
+    {
+        handle_ = emplace_impl<T>(buffer_, resource_, type_erasure::in_place_type_t<T>(),
+                                  std::forward<Args>(args)...);
+    }
+
+    // Copies use the resource of rhs.
+    %struct_name% (const %struct_name%& rhs) :
+        resource_ (rhs.resource_)
+    {
+        if (rhs.handle_)
+            handle_ = rhs.handle_->clone_into(buffer_, resource_);
+    }
+
+    %struct_name% (%struct_name%&& rhs) noexcept
+    {
+        move_from(rhs);
+    }
+
+    // Assignment
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name%& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                    std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+    {
+        reset();
+        handle_ = clone_impl(std::forward<T>(value), buffer_, resource_);
+        return *this;
+    }
+
+    %struct_name%& operator= (const %struct_name%& rhs)
+    {
+        %struct_name% temp(rhs);
+        reset();
+        move_from(temp);
+        return *this;
+    }
+
+    %struct_name%& operator= (%struct_name%&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            reset();
+            move_from(rhs);
+        }
+        return *this;
+    }
+
+    ~%struct_name% ()
+    {
+        reset();
+    }
+
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        reset();
+        handle_ = emplace_impl<T>(buffer_, resource_, type_erasure::in_place_type_t<T>(),
+                                  std::forward<Args>(args)...);
+        return value_of<T>();
+    }
+
+    template <typename T>
+    T* cast()
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    template <typename T>
+    const T* cast() const
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    // Calls f(value) on the stored value if its type is one of those given to
+    // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+    // looked up once, so the calls f makes on value can be inlined.
+    template <typename F>
+    auto visit (F&& f) -> decltype(f(std::declval<%struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    template <typename F>
+    auto visit (F&& f) const -> decltype(f(std::declval<const %struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    // The resource that values which do not fit the buffer are allocated
+    // from.  It goes along with the value on copies, moves and assignments.
+    type_erasure::memory_resource* resource () const noexcept
+    {
+        return resource_;
+    }
+
+    // The small buffer, and what fits in it.  inline_capacity() is the size of
+    // the largest pointer-aligned value that is stored in the buffer instead
+    // of on the heap, provided it can be moved without throwing or is
+    // trivially relocatable.
+    static constexpr std::size_t buffer_size ()
+    {
+        return sizeof(Buffer);
+    }
+
+    static constexpr std::size_t buffer_alignment ()
+    {
+        return alignof(Buffer);
+    }
+
+    static constexpr std::size_t inline_capacity ()
+    {
+        return sizeof(Buffer) - sizeof(HandleBase);
+    }
+
+    template <typename T>
+    static constexpr bool stored_inline ()
+    {
+        return sizeof(Handle<typename std::decay<T>::type, false>) <= sizeof(Buffer) &&
+               alignof(Handle<typename std::decay<T>::type, false>) <= alignof(Buffer) &&
+               (std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ||
+                type_erasure::is_trivially_relocatable<typename std::decay<T>::type>::value);
+    }
+
+    %nonvirtual_members%
+
+    private:
+        using Buffer = typename std::aligned_storage<%buffer_size%, %buffer_alignment%>::type;
+
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename... Ts>
+    struct VisitTypes
+    {};
+
+    template <typename F, typename Self>
+    static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+    {
+        return f(self);
+    }
+
+    template <typename F, typename Self, typename T, typename... Ts>
+    static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+    {
+        if (id == type_id<T>())
+            return f(self.template value_of<T>());
+        return visit_impl(f, self, id, VisitTypes<Ts...>());
+    }
+
+    template <typename T>
+    T& value_of ()
+    {
+        return static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    template <typename T>
+    const T& value_of () const
+    {
+        return static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    struct HandleBase
+    {
+        virtual ~HandleBase () {}
+        virtual const void* type_id () const noexcept = 0;
+        virtual HandleBase* clone_into (Buffer& buffer,
+                                        type_erasure::memory_resource* resource) const = 0;
+        virtual HandleBase* move_into (Buffer& buffer) noexcept = 0;
+        virtual void destroy (type_erasure::memory_resource* resource) = 0;
+
+        %pure_virtual_members%
+    };
+
+    template <typename T, bool HeapAllocated>
+    struct Handle : HandleBase
+    {
+        template <typename U,
+                  typename std::enable_if<
+                      !std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle(U&& value) noexcept :
+            value_( value )
+        {}
+
+        template <typename U,
+                  typename std::enable_if<
+                      std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle(U&& value) noexcept ( std::is_rvalue_reference<U>::value &&
+                                              std::is_nothrow_move_constructible<typename std::decay<U>::type>::value ) :
+            value_( std::forward<U>(value) )
+        {}
+
+        template <typename... Args>
+        explicit Handle(type_erasure::in_place_type_t<T>, Args&&... args) :
+            value_( std::forward<Args>(args)... )
+        {}
+
+        virtual HandleBase* clone_into (Buffer& buffer,
+                                        type_erasure::memory_resource* resource) const
+        {
+            return clone_impl(value_, buffer, resource);
+        }
+
+        virtual HandleBase* move_into (Buffer& buffer) noexcept
+        {
+            return relocate(this, buffer);
+        }
+
+        virtual void destroy (type_erasure::memory_resource* resource)
+        {
+            this->~Handle();
+            if (HeapAllocated)
+                resource->deallocate(this, sizeof(Handle), alignof(Handle));
+        }
+
+        virtual const void* type_id () const noexcept
+        {
+            return %struct_name%::type_id<T>();
+        }
+
+        %virtual_members%
+
+        T value_;
+    };
+
+    template <typename T, bool HeapAllocated>
+    struct Handle<std::reference_wrapper<T>, HeapAllocated> : Handle<T&, HeapAllocated>
+    {
+        Handle (std::reference_wrapper<T> ref) :
+            Handle<T&, HeapAllocated> (ref.get())
+        {}
+    };
+
+    template <typename T>
+    static HandleBase* clone_impl (T&& value, Buffer& buffer,
+                                   type_erasure::memory_resource* resource)
+    {
+        return emplace_impl<typename std::decay<T>::type>(buffer, resource,
+                                                          std::forward<T>(value));
+    }
+
+    // Constructs a handle for a T from args, in buffer if a T fits there,
+    // and otherwise in memory from resource.
+    template <typename T, typename... Args>
+    static HandleBase* emplace_impl (Buffer& buffer, type_erasure::memory_resource* resource,
+                                     Args&&... args)
+    {
+        using HeapHandle = Handle<T, true>;
+
+        void* buf_ptr = get_buffer_ptr<T>(buffer);
+        if (buf_ptr) {
+            new (buf_ptr) Handle<T, false>( std::forward<Args>(args)... );
+            return static_cast<HandleBase*>(buf_ptr);
+        }
+
+        void* heap_ptr = resource->allocate(sizeof(HeapHandle), alignof(HeapHandle));
+        try {
+            return new (heap_ptr) HeapHandle( std::forward<Args>(args)... );
+        } catch (...) {
+            resource->deallocate(heap_ptr, sizeof(HeapHandle), alignof(HeapHandle));
+            throw;
+        }
+    }
+
+    // Heap handles are passed over, inline handles move to the new buffer.
+    template <typename T>
+    static HandleBase* relocate (Handle<T, true>* handle, Buffer&) noexcept
+    {
+        return handle;
+    }
+
+    template <typename T>
+    static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer) noexcept
+    {
+        return relocate(handle, buffer, type_erasure::is_trivially_relocatable<T>());
+    }
+
+    template <typename T>
+    static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                 std::true_type) noexcept
+    {
+        std::memcpy(static_cast<void*>(&buffer), static_cast<void*>(handle),
+                    sizeof(Handle<T, false>));
+        return static_cast<Handle<T, false>*>(static_cast<void*>(&buffer));
+    }
+
+    template <typename T>
+    static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                 std::false_type) noexcept
+    {
+        HandleBase* const moved =
+            new (&buffer) Handle<T, false>( std::move(handle->value_) );
+        handle->~Handle();
+        return moved;
+    }
+
+    // Expects this to be empty, and leaves rhs empty.  Heap handles stay
+    // with the resource they were allocated from.
+    void move_from (%struct_name%& rhs) noexcept
+    {
+        if (rhs.handle_)
+            handle_ = rhs.handle_->move_into(buffer_);
+        rhs.handle_ = nullptr;
+        resource_ = rhs.resource_;
+    }
+
+    void reset ()
+    {
+        if (handle_)
+            handle_->destroy(resource_);
+        handle_ = nullptr;
+    }
+
+    template <class T>
+    static void* get_buffer_ptr(Buffer& buffer)
+    {
+        return stored_inline<T>() ? &buffer : nullptr;
+    }
+
+    HandleBase* handle_ = nullptr;
+    Buffer buffer_;
+    type_erasure::memory_resource* resource_ = type_erasure::default_resource();
+};
+
+// Constructs a T from args in place, in a new %struct_name%.  A leading
+// memory_resource* is used for the object's allocations instead.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
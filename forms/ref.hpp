@@ -0,0 +1,111 @@
+%struct_prefix%
+{
+public:
+    // Contructors
+    %struct_name% () = default;
+
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::remove_const<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name% (T& value) noexcept :
+        vtable_ (Thunks<T>::table()),
+        object_ (const_cast<void*>(static_cast<const void*>(std::addressof(value))))
+    {}
+
+    // T& above also binds const rvalues.  Referring to a temporary is
+    // never intended.
+    template <typename T>
+    %struct_name% (const T&& value) = delete;
+
+    // cast<const T>() succeeds for const and non-const referenced objects,
+    // cast<T>() only for non-const ones.
+    template <typename T>
+    T* cast() const
+    {
+        assert(vtable_);
+        if (vtable_->type_id() != type_id<T>() &&
+            vtable_->type_id() != type_id<typename std::remove_const<T>::type>())
+            return nullptr;
+        return static_cast<T*>(object_);
+    }
+
+    %nonvirtual_members%
+
+    %bind_members%
+
+private:
+    // One table per referenced type, built at compile time.  Every entry
+    // takes the referenced object as its object parameter.
+    struct VTable
+    {
+        const void* (*type_id) ();
+
+        %vtable_members%
+    };
+
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename T>
+    struct Thunks
+    {
+        static T& value_of (void* object_)
+        {
+            return *static_cast<T*>(object_);
+        }
+
+        static const T& value_of (const void* object_)
+        {
+            return *static_cast<const T*>(object_);
+        }
+
+        // A reference does not own its object, so even an rvalue reference
+        // never lets rvalue-qualified functions consume it.
+        static T& rvalue_of (void* object_)
+        {
+            return value_of(object_);
+        }
+
+        static const T& rvalue_of (const void* object_)
+        {
+            return value_of(object_);
+        }
+
+        %vtable_thunks%
+
+        static const VTable* table ()
+        {
+            static constexpr VTable table = {
+                &type_id<T>,
+                %vtable_initializers%
+            };
+            return &table;
+        }
+    };
+
+    const VTable& vtable () const
+    {
+        return *vtable_;
+    }
+
+    // Delegates returned by the bind_*() members call the referenced object,
+    // so they stay valid as long as it lives, whatever becomes of the
+    // reference.
+    static std::size_t bound_generation (const void*)
+    {
+        return 0;
+    }
+
+    void* object () const
+    {
+        return object_;
+    }
+
+    const VTable* vtable_ = nullptr;
+    void* object_ = nullptr;
+};
@@ -22,7 +22,15 @@
 
     %struct_name% (%struct_name%&& rhs) noexcept
     {
-        swap(rhs.handle_, rhs.buffer_);
+        move_from(rhs);
+    }
+
+    // Constructs a T from args in place.
+    template <typename T, typename... Args>
+    explicit %struct_name% (type_erasure::in_place_type_t<T>, Args&&... args)
+    {
+        handle_ = emplace_impl<T>(buffer_, type_erasure::in_place_type_t<T>(),
+                                  std::forward<Args>(args)...);
     }
 
     // Assignment
@@ -33,22 +41,29 @@
     %struct_name%& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
                                                     std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
     {
-        reset();
-        handle_ = clone_impl(std::forward<T>(value), buffer_);
+        using StoredType = decltype(Handle<typename std::decay<T>::type, false>::value_);
+        assign(std::forward<T>(value),
+               std::integral_constant<bool, assignable_in_place<StoredType, T>()>());
         return *this;
     }
 
     %struct_name%& operator= (const %struct_name%& rhs)
     {
+        if (handle_ && rhs.handle_ && rhs.handle_->assign_to(*handle_))
+            return *this;
+
         %struct_name% temp(rhs);
-        swap(temp.handle_, temp.buffer_);
+        reset();
+        move_from(temp);
         return *this;
     }
 
     %struct_name%& operator= (%struct_name%&& rhs) noexcept
     {
-        %struct_name% temp(std::move(rhs));
-        swap(temp.handle_, temp.buffer_);
+        if (this != &rhs) {
+            reset();
+            move_from(rhs);
+        }
         return *this;
     }
 
@@ -57,58 +72,131 @@
         reset();
     }
 
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        reset();
+        handle_ = emplace_impl<T>(buffer_, type_erasure::in_place_type_t<T>(),
+                                  std::forward<Args>(args)...);
+        return value_of<T>();
+    }
+
     template <typename T>
     T* cast()
     {
         assert(handle_);
-        void* buffer_ptr = get_buffer_ptr<typename std::decay<T>::type>(const_cast<Buffer&>(buffer_));
-        if(buffer_ptr)
-        {
-            Handle<T,false>* handle = dynamic_cast<Handle<T,false>*>(handle_);
-            if(handle)
-                return &handle->value_;
-        }
-        else
-        {
-            Handle<T,true>* handle = dynamic_cast<Handle<T,true>*>(handle_);
-            if(handle)
-                return &handle->value_;
-        }
-
-        return nullptr;
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
     }
 
     template <typename T>
     const T* cast() const
     {
         assert(handle_);
-        void* buffer_ptr = get_buffer_ptr<typename std::decay<T>::type>(const_cast<Buffer&>(buffer_));
-        if(buffer_ptr)
-        {
-            const Handle<T,false>* handle = dynamic_cast<const Handle<T,false>*>(handle_);
-            if(handle)
-                return &handle->value_;
-        }
-        else
-        {
-            const Handle<T,true>* handle = dynamic_cast<const Handle<T,true>*>(handle_);
-            if(handle)
-                return &handle->value_;
-        }
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    // Calls f(value) on the stored value if its type is one of those given to
+    // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+    // looked up once, so the calls f makes on value can be inlined.
+    template <typename F>
+    auto visit (F&& f) -> decltype(f(std::declval<%struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    template <typename F>
+    auto visit (F&& f) const -> decltype(f(std::declval<const %struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
+    }
 
-        return nullptr;
+    // The small buffer, and what fits in it.  inline_capacity() is the size of
+    // the largest pointer-aligned value that is stored in the buffer instead
+    // of on the heap, provided it can be moved without throwing or is
+    // trivially relocatable.
+    static constexpr std::size_t buffer_size ()
+    {
+        return sizeof(Buffer);
+    }
+
+    static constexpr std::size_t buffer_alignment ()
+    {
+        return alignof(Buffer);
+    }
+
+    static constexpr std::size_t inline_capacity ()
+    {
+        return sizeof(Buffer) - sizeof(HandleBase);
+    }
+
+    template <typename T>
+    static constexpr bool stored_inline ()
+    {
+        return sizeof(Handle<typename std::decay<T>::type, false>) <= sizeof(Buffer) &&
+               alignof(Handle<typename std::decay<T>::type, false>) <= alignof(Buffer) &&
+               (std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ||
+                type_erasure::is_trivially_relocatable<typename std::decay<T>::type>::value);
     }
 
     %nonvirtual_members%
 
     private:
-        using Buffer = std::array<unsigned char, SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE>;
+        using Buffer = typename std::aligned_storage<%buffer_size%, %buffer_alignment%>::type;
+
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename... Ts>
+    struct VisitTypes
+    {};
+
+    template <typename F, typename Self>
+    static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+    {
+        return f(self);
+    }
+
+    template <typename F, typename Self, typename T, typename... Ts>
+    static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+    {
+        if (id == type_id<T>())
+            return f(self.template value_of<T>());
+        return visit_impl(f, self, id, VisitTypes<Ts...>());
+    }
+
+    template <typename T>
+    T& value_of ()
+    {
+        return static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    template <typename T>
+    const T& value_of () const
+    {
+        return static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
 
     struct HandleBase
     {
         virtual ~HandleBase () {}
+        virtual const void* type_id () const noexcept = 0;
         virtual HandleBase* clone_into (Buffer& buffer) const = 0;
-        virtual bool heap_allocated () const = 0;
+        virtual HandleBase* move_into (Buffer& buffer) noexcept = 0;
+        virtual bool assign_to (HandleBase& handle) const = 0;
+        virtual std::size_t heap_size () const noexcept = 0;
+        virtual void* release () noexcept = 0;
         virtual void destroy () = 0;
 
         %pure_virtual_members%
@@ -134,22 +222,57 @@
             value_( std::forward<U>(value) )
         {}
 
+        template <typename... Args>
+        explicit Handle(type_erasure::in_place_type_t<T>, Args&&... args) :
+            value_( std::forward<Args>(args)... )
+        {}
+
         virtual HandleBase* clone_into (Buffer& buffer) const
         {
             return clone_impl(value_, buffer);
         }
 
-        virtual bool heap_allocated () const
+        virtual HandleBase* move_into (Buffer& buffer) noexcept
+        {
+            return relocate(this, buffer);
+        }
+
+        // Copies value_ over the value of handle, if that has the same type.
+        virtual bool assign_to (HandleBase& handle) const
         {
-            return HeapAllocated;
+            return handle.type_id() == %struct_name%::type_id<T>() &&
+                copy_assign(static_cast<Handle&>(handle).value_, value_,
+                            std::integral_constant<bool, assignable_in_place<T, const T&>()>());
+        }
+
+        // The size of the heap block holding this handle, or 0 if it is in a
+        // buffer or in an over-aligned block, which is not reused.  A reused
+        // block may be larger.
+        virtual std::size_t heap_size () const noexcept
+        {
+            return HeapAllocated && plain_block<T>() ? sizeof(Handle) : 0;
+        }
+
+        // Destroys the handle, and returns its memory without freeing it.
+        virtual void* release () noexcept
+        {
+            this->~Handle();
+            return this;
         }
 
         virtual void destroy ()
         {
-            if (HeapAllocated)
-                delete this;
-            else
+            if (!HeapAllocated)
                 this->~Handle();
+            else if (plain_block<T>())
+                ::operator delete(release());
+            else
+                delete this;
+        }
+
+        virtual const void* type_id () const noexcept
+        {
+            return %struct_name%::type_id<T>();
         }
 
         %virtual_members%
@@ -168,82 +291,170 @@
     template <typename T>
     static HandleBase* clone_impl (T&& value, Buffer& buffer)
     {
-        using PlainType = typename std::decay<T>::type;
+        return emplace_impl<typename std::decay<T>::type>(buffer, std::forward<T>(value));
+    }
 
-        void* buf_ptr = get_buffer_ptr<PlainType>(buffer);
+    // Constructs a handle for a T from args, in buffer if a T fits there.
+    template <typename T, typename... Args>
+    static HandleBase* emplace_impl (Buffer& buffer, Args&&... args)
+    {
+        void* buf_ptr = get_buffer_ptr<T>(buffer);
         if (buf_ptr) {
-            new (buf_ptr) Handle<PlainType, false>( std::forward<T>(value) );
+            new (buf_ptr) Handle<T, false>( std::forward<Args>(args)... );
             return static_cast<HandleBase*>(buf_ptr);
         }
 
-        return new Handle<PlainType, true>( std::forward<T>(value) );
-    }
-
-    void swap (HandleBase*& rhs_handle, Buffer& rhs_buffer)
-    {
-        const bool this_heap_allocated =
-                !handle_ || handle_->heap_allocated();
-        const bool rhs_heap_allocated =
-                !rhs_handle || rhs_handle->heap_allocated();
-
-        if (this_heap_allocated && rhs_heap_allocated) {
-            std::swap(handle_, rhs_handle);
-        } else if (this_heap_allocated) {
-            const std::ptrdiff_t offset = handle_offset(rhs_handle, rhs_buffer);
-            rhs_handle = handle_;
-            buffer_ = rhs_buffer;
-            handle_ = handle_ptr(char_ptr(&buffer_) + offset);
-        } else if (rhs_heap_allocated) {
-            const std::ptrdiff_t offset = handle_offset(handle_, buffer_);
-            handle_ = rhs_handle;
-            rhs_buffer = buffer_;
-            rhs_handle = handle_ptr(char_ptr(&rhs_buffer) + offset);
-        } else {
-            const std::ptrdiff_t this_offset = handle_offset(handle_, buffer_);
-            const std::ptrdiff_t rhs_offset = handle_offset(rhs_handle, rhs_buffer);
-            std::swap(buffer_, rhs_buffer);
-            handle_ = handle_ptr(char_ptr(&buffer_) + this_offset);
-            rhs_handle = handle_ptr(char_ptr(&rhs_buffer) + rhs_offset);
+        if (plain_block<T>()) {
+            return heap_handle<T>(::operator new(sizeof(Handle<T, true>)),
+                                  std::forward<Args>(args)...);
         }
+        return new Handle<T, true>(std::forward<Args>(args)...);
     }
 
-    void reset ()
+    // Whether a heap handle for T may live in a block from the plain
+    // operator new, which is only aligned for std::max_align_t.  Over-aligned
+    // handles get their own new expression, which aligns them where the
+    // language supports that, and their blocks are never reused.
+    template <typename T>
+    static constexpr bool plain_block ()
     {
-        if (handle_)
-            handle_->destroy();
+        return alignof(Handle<T, true>) <= alignof(std::max_align_t);
     }
 
-    template <class T>
-    static void* get_buffer_ptr(Buffer& buffer)
+    // Constructs a heap handle in block, and frees block if that throws.
+    template <typename T, typename... Args>
+    static HandleBase* heap_handle (void* block, Args&&... args)
+    {
+        try {
+            return ::new (block) Handle<T, true>(std::forward<Args>(args)...);
+        } catch (...) {
+            ::operator delete(block);
+            throw;
+        }
+    }
+
+    // Whether a stored T can be assigned a U in place.  Stored references,
+    // such as those from std::reference_wrapper, are not, since that would
+    // assign to the referenced object, and nor are
+    // types whose assignment may throw where construction would not.
+    template <typename T, typename U>
+    static constexpr bool assignable_in_place ()
+    {
+        return !std::is_reference<T>::value && std::is_assignable<T&, U>::value &&
+               (std::is_nothrow_assignable<T&, U>::value ||
+                !std::is_nothrow_constructible<T, U>::value);
+    }
+
+    template <typename T>
+    static bool copy_assign (T& to, const T& from, std::true_type)
+    {
+        to = from;
+        return true;
+    }
+
+    template <typename T>
+    static bool copy_assign (T&, const T&, std::false_type)
+    {
+        return false;
+    }
+
+    // Assigns value to the stored value if that has the same type.
+    template <typename T>
+    void assign (T&& value, std::true_type)
+    {
+        using PlainType = typename std::decay<T>::type;
+        if (handle_ && handle_->type_id() == type_id<PlainType>())
+            value_of<PlainType>() = std::forward<T>(value);
+        else
+            replace(std::forward<T>(value));
+    }
+
+    template <typename T>
+    void assign (T&& value, std::false_type)
+    {
+        replace(std::forward<T>(value));
+    }
+
+    // Replaces the stored value.  The heap block of the old value is reused
+    // if the new one goes on the heap too, and fits in it.
+    template <typename T>
+    void replace (T&& value)
     {
-        using BufferHandle = Handle<T,false>;
+        using PlainType = typename std::decay<T>::type;
+        using HeapHandle = Handle<PlainType, true>;
+
+        if (!stored_inline<PlainType>() && handle_ && sizeof(HeapHandle) <= handle_->heap_size() &&
+            plain_block<PlainType>()) {
+            void* const block = handle_->release();
+            handle_ = nullptr;
+            handle_ = heap_handle<PlainType>(block, std::forward<T>(value));
+            return;
+        }
 
-        void* buffer_ptr = &buffer;
-        std::size_t buffer_size = sizeof(buffer);
-        return std::align( alignof(BufferHandle),
-                           sizeof(BufferHandle),
-                           buffer_ptr,
-                           buffer_size);
+        reset();
+        handle_ = clone_impl(std::forward<T>(value), buffer_);
+    }
 
+    // Heap handles are passed over, inline handles move to the new buffer.
+    template <typename T>
+    static HandleBase* relocate (Handle<T, true>* handle, Buffer&) noexcept
+    {
+        return handle;
     }
 
     template <typename T>
-    static unsigned char* char_ptr (T* ptr)
+    static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer) noexcept
     {
-        return static_cast<unsigned char*>(static_cast<void*>(ptr));
+        return relocate(handle, buffer, type_erasure::is_trivially_relocatable<T>());
     }
 
-    static HandleBase* handle_ptr (unsigned char* ptr)
+    template <typename T>
+    static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                 std::true_type) noexcept
     {
-        return static_cast<HandleBase*>(static_cast<void*>(ptr));
+        std::memcpy(static_cast<void*>(&buffer), static_cast<void*>(handle),
+                    sizeof(Handle<T, false>));
+        return static_cast<Handle<T, false>*>(static_cast<void*>(&buffer));
     }
 
-    static std::ptrdiff_t handle_offset (HandleBase* handle, Buffer& buffer)
+    template <typename T>
+    static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                 std::false_type) noexcept
     {
-        assert(handle);
-        return char_ptr(handle) - char_ptr(&buffer);
+        HandleBase* const moved =
+            new (&buffer) Handle<T, false>( std::move(handle->value_) );
+        handle->~Handle();
+        return moved;
+    }
+
+    // Expects this to be empty, and leaves rhs empty.
+    void move_from (%struct_name%& rhs) noexcept
+    {
+        if (rhs.handle_)
+            handle_ = rhs.handle_->move_into(buffer_);
+        rhs.handle_ = nullptr;
+    }
+
+    void reset ()
+    {
+        if (handle_)
+            handle_->destroy();
+        handle_ = nullptr;
+    }
+
+    template <class T>
+    static void* get_buffer_ptr(Buffer& buffer)
+    {
+        return stored_inline<T>() ? &buffer : nullptr;
     }
 
     HandleBase* handle_ = nullptr;
     Buffer buffer_;
 };
+
+// Constructs a T from args in place, in a new %struct_name%.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
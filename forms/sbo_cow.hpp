@@ -14,23 +14,30 @@ public:
         handle_ = clone_impl(std::forward<T>(value), buffer_);
     }
 
-    %struct_name% (const %struct_name%& rhs) :
-        handle_ (
-            !rhs.handle_ || heap_allocated(rhs.handle_, rhs.buffer_) ?
-            rhs.handle_ :
-            handle_ptr(
-                char_ptr(&buffer_) + handle_offset(rhs.handle_, rhs.buffer_)
-            )
-        ),
-        buffer_ (rhs.buffer_)
+    %struct_name% (const %struct_name%& rhs)
     {
-        if (handle_)
+        if (!rhs.handle_)
+            return;
+
+        if (heap_allocated(rhs.handle_, rhs.buffer_)) {
+            handle_ = rhs.handle_;
             handle_->add_ref();
+        } else {
+            handle_ = rhs.handle_->clone_into(buffer_);
+        }
     }
 
     %struct_name% (%struct_name%&& rhs) noexcept
     {
-        swap(rhs.handle_, rhs.buffer_);
+        move_from(rhs);
+    }
+
+    // Constructs a T from args in place.
+    template <typename T, typename... Args>
+    explicit %struct_name% (type_erasure::in_place_type_t<T>, Args&&... args)
+    {
+        handle_ = emplace_impl<T>(buffer_, type_erasure::in_place_type_t<T>(),
+                                  std::forward<Args>(args)...);
     }
 
     // Assignment
@@ -41,24 +48,33 @@ public:
     %struct_name%& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
                                                     std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
     {
-        reset();
-        handle_ = clone_impl(std::forward<T>(value), buffer_);
+        using StoredType = decltype(Handle<typename std::decay<T>::type, false>::value_);
+        assign(std::forward<T>(value),
+               std::integral_constant<bool, assignable_in_place<StoredType, T>()>());
         return *this;
     }
 
     %struct_name%& operator= (const %struct_name%& rhs)
     {
+        // Heap values are shared rather than copied, so only values in the
+        // buffer are worth assigning in place.
+        if (handle_ && rhs.handle_ && !heap_allocated(rhs.handle_, rhs.buffer_) &&
+            rhs.handle_->assign_to(*handle_)) {
+            return *this;
+        }
+
         %struct_name% temp(rhs);
-        swap(temp.handle_, temp.buffer_);
-        if (handle_)
-            handle_->add_ref();
+        reset();
+        move_from(temp);
         return *this;
     }
 
     %struct_name%& operator= (%struct_name%&& rhs) noexcept
     {
-        %struct_name% temp(std::move(rhs));
-        swap(temp.handle_, temp.buffer_);
+        if (this != &rhs) {
+            reset();
+            move_from(rhs);
+        }
         return *this;
     }
 
@@ -67,57 +83,92 @@ public:
         reset();
     }
 
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.  Writing through the reference after the object is copied
+    // would change the copies too.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        reset();
+        handle_ = emplace_impl<T>(buffer_, type_erasure::in_place_type_t<T>(),
+                                  std::forward<Args>(args)...);
+        return value_of<T>();
+    }
+
     template <typename T>
     T* cast()
     {
         assert(handle_);
-        void* buffer_ptr = get_buffer_ptr<typename std::decay<T>::type>(const_cast<Buffer&>(buffer_));
-        if(buffer_ptr)
-        {
-            Handle<T,false>* handle = dynamic_cast<Handle<T,false>*>(handle_);
-            if(handle)
-                return &handle->value_;
-        }
-        else
-        {
-            Handle<T,true>* handle = dynamic_cast<Handle<T,true>*>(handle_);
-            if(handle)
-                return &handle->value_;
-        }
-
-        return nullptr;
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
     }
 
     template <typename T>
     const T* cast() const
     {
         assert(handle_);
-        void* buffer_ptr = get_buffer_ptr<typename std::decay<T>::type>(const_cast<Buffer&>(buffer_));
-        if(buffer_ptr)
-        {
-            Handle<T,false>* handle = dynamic_cast<Handle<T,false>*>(handle_);
-            if(handle)
-                return &handle->value_;
-        }
-        else
-        {
-            Handle<T,true>* handle = dynamic_cast<Handle<T,true>*>(handle_);
-            if(handle)
-                return &handle->value_;
-        }
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    // The small buffer, and what fits in it.  inline_capacity() is the size of
+    // the largest pointer-aligned value that is stored in the buffer instead
+    // of on the heap, provided it can be moved without throwing or is
+    // trivially relocatable.  Values in the buffer are copied eagerly and
+    // carry no reference count, only heap values are shared.
+    static constexpr std::size_t buffer_size ()
+    {
+        return sizeof(Buffer);
+    }
+
+    static constexpr std::size_t buffer_alignment ()
+    {
+        return alignof(Buffer);
+    }
+
+    static constexpr std::size_t inline_capacity ()
+    {
+        return sizeof(Buffer) - sizeof(HandleBase);
+    }
 
-        return nullptr;
+    template <typename T>
+    static constexpr bool stored_inline ()
+    {
+        return sizeof(Handle<typename std::decay<T>::type, false>) <= sizeof(Buffer) &&
+               alignof(Handle<typename std::decay<T>::type, false>) <= alignof(Buffer) &&
+               (std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ||
+                type_erasure::is_trivially_relocatable<typename std::decay<T>::type>::value);
     }
 
     %nonvirtual_members%
 
 private:
-    using Buffer = std::array<char, 24>;
+    using Buffer = typename std::aligned_storage<%buffer_size%, %buffer_alignment%>::type;
+
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename T>
+    T& value_of ()
+    {
+        return static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
 
     struct HandleBase
     {
         virtual ~HandleBase () {}
+        virtual const void* type_id () const noexcept = 0;
         virtual HandleBase* clone_into (Buffer & buf) const = 0;
+        virtual HandleBase* move_into (Buffer & buf) noexcept = 0;
+        virtual bool assign_to (HandleBase& handle) const = 0;
+        virtual std::size_t heap_size () const noexcept = 0;
+        virtual void* release () noexcept = 0;
         virtual bool unique () const = 0;
         virtual void add_ref () = 0;
         virtual void destroy () = 0;
@@ -125,16 +176,55 @@ private:
         %pure_virtual_members%
     };
 
+    // The reference count of a heap handle.  Handles in the buffer are never
+    // shared, so they get an empty base instead, which takes no space.
+    template <bool HeapAllocated, typename = void>
+    struct RefCount
+    {
+        RefCount () noexcept :
+            ref_count_(1)
+        {}
+
+        bool unique_ref () const
+        { return ref_count_ == 1u; }
+
+        void add_ref ()
+        { ++ref_count_; }
+
+        // Returns whether this was the last reference.
+        bool remove_ref ()
+        {
+            if (ref_count_ == 1u)
+                return true;
+            --ref_count_;
+            return false;
+        }
+
+        %ref_count% ref_count_;
+    };
+
+    template <typename Unused>
+    struct RefCount<false, Unused>
+    {
+        bool unique_ref () const
+        { return true; }
+
+        void add_ref ()
+        { assert(!"values in the buffer are copied, not shared"); }
+
+        bool remove_ref ()
+        { return true; }
+    };
+
     template <typename T, bool HeapAllocated>
-    struct Handle : HandleBase
+    struct Handle : HandleBase, RefCount<HeapAllocated>
     {
         template <typename U,
                   typename std::enable_if<
                       !std::is_same< T, typename std::decay<U>::type >::value
                                            >::type* = nullptr>
         explicit Handle( U&& value ) noexcept :
-            value_( value ),
-            ref_count_(1)
+            value_( value )
         {}
 
         template <typename U,
@@ -143,35 +233,69 @@ private:
                                            >::type* = nullptr>
         explicit Handle( U&& value ) noexcept ( std::is_rvalue_reference<U>::value &&
                                                 std::is_nothrow_move_constructible<typename std::decay<U>::type>::value ) :
-            value_( std::forward<U>(value) ),
-            ref_count_(1)
+            value_( std::forward<U>(value) )
+        {}
+
+        template <typename... Args>
+        explicit Handle(type_erasure::in_place_type_t<T>, Args&&... args) :
+            value_( std::forward<Args>(args)... )
         {}
 
         virtual HandleBase * clone_into (Buffer & buf) const
         { return clone_impl(value_, buf); }
 
+        virtual HandleBase * move_into (Buffer & buf) noexcept
+        { return relocate(this, buf); }
+
+        // Copies value_ over the value of handle, if that has the same type.
+        virtual bool assign_to (HandleBase& handle) const
+        {
+            return handle.type_id() == %struct_name%::type_id<T>() &&
+                copy_assign(static_cast<Handle&>(handle).value_, value_,
+                            std::integral_constant<bool, assignable_in_place<T, const T&>()>());
+        }
+
+        // The size of the heap block holding this handle, or 0 if it is in a
+        // buffer or in an over-aligned block, which is not reused.  A reused
+        // block may be larger.
+        virtual std::size_t heap_size () const noexcept
+        {
+            return HeapAllocated && plain_block<T>() ? sizeof(Handle) : 0;
+        }
+
+        // Destroys the handle, and returns its memory without freeing it.
+        virtual void* release () noexcept
+        {
+            this->~Handle();
+            return this;
+        }
+
         virtual bool unique () const
-        { return ref_count_ == 1u; }
+        { return this->unique_ref(); }
 
         virtual void add_ref ()
-        { ++ref_count_; }
+        { RefCount<HeapAllocated>::add_ref(); }
 
         virtual void destroy ()
         {
-            if (ref_count_ == 1u) {
-                if (HeapAllocated)
-                    delete this;
-                else
-                    this->~Handle();
-            } else {
-                --ref_count_;
-            }
+            if (!this->remove_ref())
+                return;
+            if (!HeapAllocated)
+                this->~Handle();
+            else if (plain_block<T>())
+                ::operator delete(release());
+            else
+                delete this;
+        }
+
+        virtual const void* type_id () const noexcept
+        {
+            return %struct_name%::type_id<T>();
         }
 
         %virtual_members%
 
         T value_;
-        std::atomic_size_t ref_count_;
     };
 
     template <typename T, bool HeapAllocated>
@@ -185,15 +309,141 @@ private:
     template <typename T>
     static HandleBase * clone_impl (T&& value, Buffer& buffer)
     {
-        using PlainType = typename std::decay<T>::type;
+        return emplace_impl<typename std::decay<T>::type>(buffer, std::forward<T>(value));
+    }
 
-        void* buffer_ptr = get_buffer_ptr<PlainType>(buffer);
+    // Constructs a handle for a T from args, in buffer if a T fits there.
+    template <typename T, typename... Args>
+    static HandleBase * emplace_impl (Buffer& buffer, Args&&... args)
+    {
+        void* buffer_ptr = get_buffer_ptr<T>(buffer);
         if (buffer_ptr) {
-            new (buffer_ptr) Handle<PlainType, false>(std::forward<T>(value));
+            new (buffer_ptr) Handle<T, false>(std::forward<Args>(args)...);
             return static_cast<HandleBase*>(buffer_ptr);
         }
 
-        return new Handle<PlainType, true>(std::forward<T>(value));
+        if (plain_block<T>()) {
+            return heap_handle<T>(::operator new(sizeof(Handle<T, true>)),
+                                  std::forward<Args>(args)...);
+        }
+        return new Handle<T, true>(std::forward<Args>(args)...);
+    }
+
+    // Whether a heap handle for T may live in a block from the plain
+    // operator new, which is only aligned for std::max_align_t.  Over-aligned
+    // handles get their own new expression, which aligns them where the
+    // language supports that, and their blocks are never reused.
+    template <typename T>
+    static constexpr bool plain_block ()
+    {
+        return alignof(Handle<T, true>) <= alignof(std::max_align_t);
+    }
+
+    // Constructs a heap handle in block, and frees block if that throws.
+    template <typename T, typename... Args>
+    static HandleBase * heap_handle (void* block, Args&&... args)
+    {
+        try {
+            return ::new (block) Handle<T, true>(std::forward<Args>(args)...);
+        } catch (...) {
+            ::operator delete(block);
+            throw;
+        }
+    }
+
+    // Whether a stored T can be assigned a U in place.  Stored references,
+    // such as those from std::reference_wrapper, are not, since that would
+    // assign to the referenced object, and nor are
+    // types whose assignment may throw where construction would not.
+    template <typename T, typename U>
+    static constexpr bool assignable_in_place ()
+    {
+        return !std::is_reference<T>::value && std::is_assignable<T&, U>::value &&
+               (std::is_nothrow_assignable<T&, U>::value ||
+                !std::is_nothrow_constructible<T, U>::value);
+    }
+
+    template <typename T>
+    static bool copy_assign (T& to, const T& from, std::true_type)
+    {
+        to = from;
+        return true;
+    }
+
+    template <typename T>
+    static bool copy_assign (T&, const T&, std::false_type)
+    {
+        return false;
+    }
+
+    // Assigns value to the stored value if that has the same type, and is
+    // not shared.
+    template <typename T>
+    void assign (T&& value, std::true_type)
+    {
+        using PlainType = typename std::decay<T>::type;
+        if (handle_ && handle_->unique() && handle_->type_id() == type_id<PlainType>())
+            value_of<PlainType>() = std::forward<T>(value);
+        else
+            replace(std::forward<T>(value));
+    }
+
+    template <typename T>
+    void assign (T&& value, std::false_type)
+    {
+        replace(std::forward<T>(value));
+    }
+
+    // Replaces the stored value.  The heap block of the old value is reused
+    // if the new one goes on the heap too, and fits in it.
+    template <typename T>
+    void replace (T&& value)
+    {
+        using PlainType = typename std::decay<T>::type;
+        using HeapHandle = Handle<PlainType, true>;
+
+        if (!stored_inline<PlainType>() && handle_ && handle_->unique() &&
+            sizeof(HeapHandle) <= handle_->heap_size() && plain_block<PlainType>()) {
+            void* const block = handle_->release();
+            handle_ = nullptr;
+            handle_ = heap_handle<PlainType>(block, std::forward<T>(value));
+            return;
+        }
+
+        reset();
+        handle_ = clone_impl(std::forward<T>(value), buffer_);
+    }
+
+    // Heap handles are passed over, inline handles move to the new buffer.
+    template <typename T>
+    static HandleBase * relocate (Handle<T, true>* handle, Buffer&) noexcept
+    {
+        return handle;
+    }
+
+    template <typename T>
+    static HandleBase * relocate (Handle<T, false>* handle, Buffer& buffer) noexcept
+    {
+        return relocate(handle, buffer, type_erasure::is_trivially_relocatable<T>());
+    }
+
+    template <typename T>
+    static HandleBase * relocate (Handle<T, false>* handle, Buffer& buffer,
+                                  std::true_type) noexcept
+    {
+        std::memcpy(static_cast<void*>(&buffer), static_cast<void*>(handle),
+                    sizeof(Handle<T, false>));
+        return static_cast<Handle<T, false>*>(static_cast<void*>(&buffer));
+    }
+
+    template <typename T>
+    static HandleBase * relocate (Handle<T, false>* handle, Buffer& buffer,
+                                  std::false_type) noexcept
+    {
+        HandleBase * const moved =
+            new (&buffer) Handle<T, false>(std::move(handle->value_));
+        handle->~Handle();
+        return moved;
     }
 
     static bool heap_allocated (const HandleBase* handle, const Buffer& buffer)
@@ -202,38 +452,19 @@ private:
                 handle_ptr(char_ptr(&buffer) + sizeof(buffer)) <= handle;
     }
 
-    void swap (HandleBase*& rhs_handle, Buffer& rhs_buffer)
+    // Expects this to be empty, and leaves rhs empty.
+    void move_from (%struct_name%& rhs) noexcept
     {
-        const bool this_heap_allocated = heap_allocated(handle_, buffer_);
-        const bool rhs_heap_allocated = heap_allocated(rhs_handle, rhs_buffer);
-
-        if (this_heap_allocated && rhs_heap_allocated) {
-            std::swap(handle_, rhs_handle);
-        } else if (this_heap_allocated) {
-            const std::ptrdiff_t offset = handle_offset(rhs_handle, rhs_buffer);
-            rhs_handle = handle_;
-            buffer_ = rhs_buffer;
-            handle_ = handle_ptr(char_ptr(&buffer_) + offset);
-        } else if (rhs_heap_allocated) {
-            const std::ptrdiff_t offset = handle_offset(handle_, buffer_);
-            handle_ = rhs_handle;
-            rhs_buffer = buffer_;
-            rhs_handle = handle_ptr(char_ptr(&rhs_buffer) + offset);
-        } else {
-            const std::ptrdiff_t this_offset =
-                handle_offset(handle_, buffer_);
-            const std::ptrdiff_t rhs_offset =
-                handle_offset(rhs_handle, rhs_buffer);
-            std::swap(buffer_, rhs_buffer);
-            handle_ = handle_ptr(char_ptr(&buffer_) + this_offset);
-            rhs_handle = handle_ptr(char_ptr(&rhs_buffer) + rhs_offset);
-        }
+        if (rhs.handle_)
+            handle_ = rhs.handle_->move_into(buffer_);
+        rhs.handle_ = nullptr;
     }
 
     void reset()
     {
         if (handle_)
             handle_->destroy();
+        handle_ = nullptr;
     }
 
     const HandleBase& read () const
@@ -243,21 +474,18 @@ private:
 
     HandleBase & write ()
     {
-        if (!handle_->unique())
-            handle_ = handle_->clone_into(buffer_);
+        if (!handle_->unique()) {
+            HandleBase * const handle = handle_->clone_into(buffer_);
+            handle_->destroy();
+            handle_ = handle;
+        }
         return *handle_;
     }
 
     template <class T>
     static void* get_buffer_ptr(Buffer& buffer)
     {
-        using BufferHandle  = Handle<T, false>;
-        void * buf_ptr = &buffer;
-        std::size_t buf_size = sizeof(buffer);
-        const bool memcopyable = std::is_trivially_destructible<typename std::remove_cv<T>::type>();
-        return memcopyable ? std::align( alignof(BufferHandle),
-                                         sizeof(BufferHandle),
-                                         buf_ptr, buf_size ) : nullptr;
+        return stored_inline<T>() ? &buffer : nullptr;
     }
 
     template <typename T>
@@ -273,15 +501,13 @@ private:
     static HandleBase * handle_ptr (unsigned char * ptr)
     { return static_cast<HandleBase *>(static_cast<void *>(ptr)); }
 
-    static std::ptrdiff_t handle_offset (const HandleBase * handle,
-                                         const Buffer & buffer)
-    {
-        assert(handle);
-        unsigned char * const char_handle = char_ptr(handle);
-        unsigned char * const char_buffer = char_ptr(&buffer);
-        return char_handle - char_buffer;
-    }
-
     HandleBase* handle_ = nullptr;
     Buffer buffer_;
 };
+
+// Constructs a T from args in place, in a new %struct_name%.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
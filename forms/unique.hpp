@@ -0,0 +1,207 @@
+%struct_prefix%
+{
+public:
+    // Contructors
+    %struct_name% () = default;
+
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name% ( T&& value ) noexcept ( std::is_rvalue_reference<T>::value &&
+                                           std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ) :
+        handle_ (
+            new Handle<typename std::decay<T>::type>(
+                std::forward<T>( value )
+            )
+        )
+    {}
+
+    %struct_name% ( const %struct_name% & rhs ) = delete;
+
+    %struct_name% ( %struct_name%&& rhs ) noexcept
+        : handle_ ( std::move(rhs.handle_) )
+    {}
+
+    // Constructs a T from args in place.
+    template <typename T, typename... Args>
+    explicit %struct_name% ( type_erasure::in_place_type_t<T>, Args&&... args ) :
+        handle_ (
+            new Handle<T>(
+                type_erasure::in_place_type_t<T>(), std::forward<Args>( args )...
+            )
+        )
+    {}
+
+    // Assignment
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name%& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                    std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+    {
+        handle_.reset(
+            new Handle<typename std::decay<T>::type>(
+                std::forward<T>( value )
+            )
+        );
+        return *this;
+    }
+
+    %struct_name%& operator= (const %struct_name%& rhs) = delete;
+
+    %struct_name%& operator= (%struct_name%&& rhs) noexcept
+    {
+        handle_ = std::move(rhs.handle_);
+        return *this;
+    }
+
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        handle_.reset(
+            new Handle<T>(
+                type_erasure::in_place_type_t<T>(), std::forward<Args>( args )...
+            )
+        );
+        return value_of<T>();
+    }
+
+    template <typename T>
+    T* cast()
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<Handle<T>*>( handle_.get() )->value_;
+    }
+
+    template <typename T>
+    const T* cast() const
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<const Handle<T>*>( handle_.get() )->value_;
+    }
+
+    // Calls f(value) on the stored value if its type is one of those given to
+    // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+    // looked up once, so the calls f makes on value can be inlined.
+    template <typename F>
+    auto visit (F&& f) -> decltype(f(std::declval<%struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    template <typename F>
+    auto visit (F&& f) const -> decltype(f(std::declval<const %struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    %nonvirtual_members%
+
+private:
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename... Ts>
+    struct VisitTypes
+    {};
+
+    template <typename F, typename Self>
+    static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+    {
+        return f(self);
+    }
+
+    template <typename F, typename Self, typename T, typename... Ts>
+    static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+    {
+        if (id == type_id<T>())
+            return f(self.template value_of<T>());
+        return visit_impl(f, self, id, VisitTypes<Ts...>());
+    }
+
+    template <typename T>
+    T& value_of ()
+    {
+        return static_cast<Handle<T>*>(handle_.get())->value_;
+    }
+
+    template <typename T>
+    const T& value_of () const
+    {
+        return static_cast<const Handle<T>*>(handle_.get())->value_;
+    }
+
+    struct HandleBase
+    {
+        virtual ~HandleBase () {}
+        virtual const void* type_id () const noexcept = 0;
+
+        %pure_virtual_members%
+    };
+
+    template <typename T>
+    struct Handle : HandleBase
+    {
+        template <typename U,
+                  typename std::enable_if<
+                      !std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle( U&& value ) noexcept
+            : value_( value )
+        {}
+
+        template <typename U,
+                  typename std::enable_if<
+                      std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle( U&& value ) noexcept ( std::is_rvalue_reference<U>::value &&
+                                                std::is_nothrow_move_constructible<typename std::decay<U>::type>::value )
+            : value_( std::forward<U>(value) )
+        {}
+
+        template <typename... Args>
+        explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+            : value_( std::forward<Args>(args)... )
+        {}
+
+        virtual const void* type_id () const noexcept
+        {
+            return %struct_name%::type_id<T>();
+        }
+
+        %virtual_members%
+
+        T value_;
+    };
+
+    template <typename T>
+    struct Handle< std::reference_wrapper<T> > : Handle<T&>
+    {
+        Handle (std::reference_wrapper<T> ref)
+            : Handle<T&> (ref.get())
+        {}
+    };
+
+    std::unique_ptr<HandleBase> handle_;
+};
+
+// Constructs a T from args in place, in a new %struct_name%.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
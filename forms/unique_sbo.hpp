@@ -0,0 +1,324 @@
+%struct_prefix%
+{
+    public:
+    // Contructors
+    %struct_name% () = default;
+
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name% (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                         std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+    {
+        handle_ = construct_impl( std::forward<T>(value), buffer_ );
+    }
+
+    %struct_name% (const %struct_name%& rhs) = delete;
+
+    %struct_name% (%struct_name%&& rhs) noexcept
+    {
+        move_from(rhs);
+    }
+
+    // Constructs a T from args in place.
+    template <typename T, typename... Args>
+    explicit %struct_name% (type_erasure::in_place_type_t<T>, Args&&... args)
+    {
+        handle_ = emplace_impl<T>(buffer_, type_erasure::in_place_type_t<T>(),
+                                  std::forward<Args>(args)...);
+    }
+
+    // Assignment
+    template <typename T,
+              typename std::enable_if<
+                  !std::is_same< %struct_name%, typename std::decay<T>::type >::value
+                  >::type* = nullptr>
+    %struct_name%& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                    std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+    {
+        reset();
+        handle_ = construct_impl(std::forward<T>(value), buffer_);
+        return *this;
+    }
+
+    %struct_name%& operator= (const %struct_name%& rhs) = delete;
+
+    %struct_name%& operator= (%struct_name%&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            reset();
+            move_from(rhs);
+        }
+        return *this;
+    }
+
+    ~%struct_name% ()
+    {
+        reset();
+    }
+
+    // Replaces the value with a T constructed from args in place, and
+    // returns it.
+    template <typename T, typename... Args>
+    T& emplace (Args&&... args)
+    {
+        reset();
+        handle_ = emplace_impl<T>(buffer_, type_erasure::in_place_type_t<T>(),
+                                  std::forward<Args>(args)...);
+        return value_of<T>();
+    }
+
+    template <typename T>
+    T* cast()
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    template <typename T>
+    const T* cast() const
+    {
+        assert(handle_);
+        if (handle_->type_id() != type_id<T>())
+            return nullptr;
+        return &static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    // Calls f(value) on the stored value if its type is one of those given to
+    // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+    // looked up once, so the calls f makes on value can be inlined.
+    template <typename F>
+    auto visit (F&& f) -> decltype(f(std::declval<%struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    template <typename F>
+    auto visit (F&& f) const -> decltype(f(std::declval<const %struct_name%&>()))
+    {
+        assert(handle_);
+        return visit_impl(f, *this, handle_->type_id(), VisitTypes<%visit_types%>());
+    }
+
+    // The small buffer, and what fits in it.  inline_capacity() is the size of
+    // the largest pointer-aligned value that is stored in the buffer instead
+    // of on the heap, provided it can be moved without throwing or is
+    // trivially relocatable.
+    static constexpr std::size_t buffer_size ()
+    {
+        return sizeof(Buffer);
+    }
+
+    static constexpr std::size_t buffer_alignment ()
+    {
+        return alignof(Buffer);
+    }
+
+    static constexpr std::size_t inline_capacity ()
+    {
+        return sizeof(Buffer) - sizeof(HandleBase);
+    }
+
+    template <typename T>
+    static constexpr bool stored_inline ()
+    {
+        return sizeof(Handle<typename std::decay<T>::type, false>) <= sizeof(Buffer) &&
+               alignof(Handle<typename std::decay<T>::type, false>) <= alignof(Buffer) &&
+               (std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ||
+                type_erasure::is_trivially_relocatable<typename std::decay<T>::type>::value);
+    }
+
+    %nonvirtual_members%
+
+    private:
+        using Buffer = typename std::aligned_storage<%buffer_size%, %buffer_alignment%>::type;
+
+    template <typename T>
+    static const void* type_id ()
+    {
+        static char id;
+        return &id;
+    }
+
+    template <typename... Ts>
+    struct VisitTypes
+    {};
+
+    template <typename F, typename Self>
+    static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+    {
+        return f(self);
+    }
+
+    template <typename F, typename Self, typename T, typename... Ts>
+    static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+    {
+        if (id == type_id<T>())
+            return f(self.template value_of<T>());
+        return visit_impl(f, self, id, VisitTypes<Ts...>());
+    }
+
+    template <typename T>
+    T& value_of ()
+    {
+        return static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    template <typename T>
+    const T& value_of () const
+    {
+        return static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+    }
+
+    struct HandleBase
+    {
+        virtual ~HandleBase () {}
+        virtual const void* type_id () const noexcept = 0;
+        virtual HandleBase* move_into (Buffer& buffer) noexcept = 0;
+        virtual void destroy () = 0;
+
+        %pure_virtual_members%
+    };
+
+    template <typename T, bool HeapAllocated>
+    struct Handle : HandleBase
+    {
+        template <typename U,
+                  typename std::enable_if<
+                      !std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle(U&& value) noexcept :
+            value_( value )
+        {}
+
+        template <typename U,
+                  typename std::enable_if<
+                      std::is_same< T, typename std::decay<U>::type >::value
+                                           >::type* = nullptr>
+        explicit Handle(U&& value) noexcept ( std::is_rvalue_reference<U>::value &&
+                                              std::is_nothrow_move_constructible<typename std::decay<U>::type>::value ) :
+            value_( std::forward<U>(value) )
+        {}
+
+        template <typename... Args>
+        explicit Handle(type_erasure::in_place_type_t<T>, Args&&... args) :
+            value_( std::forward<Args>(args)... )
+        {}
+
+        virtual HandleBase* move_into (Buffer& buffer) noexcept
+        {
+            return relocate(this, buffer);
+        }
+
+        virtual void destroy ()
+        {
+            if (HeapAllocated)
+                delete this;
+            else
+                this->~Handle();
+        }
+
+        virtual const void* type_id () const noexcept
+        {
+            return %struct_name%::type_id<T>();
+        }
+
+        %virtual_members%
+
+        T value_;
+    };
+
+    template <typename T, bool HeapAllocated>
+    struct Handle<std::reference_wrapper<T>, HeapAllocated> : Handle<T&, HeapAllocated>
+    {
+        Handle (std::reference_wrapper<T> ref) :
+            Handle<T&, HeapAllocated> (ref.get())
+        {}
+    };
+
+    template <typename T>
+    static HandleBase* construct_impl (T&& value, Buffer& buffer)
+    {
+        return emplace_impl<typename std::decay<T>::type>(buffer, std::forward<T>(value));
+    }
+
+    // Constructs a handle for a T from args, in buffer if a T fits there.
+    template <typename T, typename... Args>
+    static HandleBase* emplace_impl (Buffer& buffer, Args&&... args)
+    {
+        void* buf_ptr = get_buffer_ptr<T>(buffer);
+        if (buf_ptr) {
+            new (buf_ptr) Handle<T, false>( std::forward<Args>(args)... );
+            return static_cast<HandleBase*>(buf_ptr);
+        }
+
+        return new Handle<T, true>( std::forward<Args>(args)... );
+    }
+
+    // Heap handles are passed over, inline handles move to the new buffer.
+    template <typename T>
+    static HandleBase* relocate (Handle<T, true>* handle, Buffer&) noexcept
+    {
+        return handle;
+    }
+
+    template <typename T>
+    static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer) noexcept
+    {
+        return relocate(handle, buffer, type_erasure::is_trivially_relocatable<T>());
+    }
+
+    template <typename T>
+    static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                 std::true_type) noexcept
+    {
+        std::memcpy(static_cast<void*>(&buffer), static_cast<void*>(handle),
+                    sizeof(Handle<T, false>));
+        return static_cast<Handle<T, false>*>(static_cast<void*>(&buffer));
+    }
+
+    template <typename T>
+    static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                 std::false_type) noexcept
+    {
+        HandleBase* const moved =
+            new (&buffer) Handle<T, false>( std::move(handle->value_) );
+        handle->~Handle();
+        return moved;
+    }
+
+    // Expects this to be empty, and leaves rhs empty.
+    void move_from (%struct_name%& rhs) noexcept
+    {
+        if (rhs.handle_)
+            handle_ = rhs.handle_->move_into(buffer_);
+        rhs.handle_ = nullptr;
+    }
+
+    void reset ()
+    {
+        if (handle_)
+            handle_->destroy();
+        handle_ = nullptr;
+    }
+
+    template <class T>
+    static void* get_buffer_ptr(Buffer& buffer)
+    {
+        return stored_inline<T>() ? &buffer : nullptr;
+    }
+
+    HandleBase* handle_ = nullptr;
+    Buffer buffer_;
+};
+
+// Constructs a T from args in place, in a new %struct_name%.
+template <typename T, typename... Args>
+%struct_name% make_%snake_case_name% (Args&&... args)
+{
+    return %struct_name%(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+}
@@ -17,6 +17,14 @@
 #define alignof __alignof
 #endif
 
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT alignof(void*)
+#endif
+
 #if !defined(__clang__) && defined(__GNUC__) && __GNUC__ <= 4 && __GNUC_MINOR__ <= 9
 /*
 This implementation is taken from libc++, since GCC <= 4.9 is missing it.
@@ -124,7 +132,10 @@ public:
     }
 
 private:
-    typedef std::array<unsigned char, 24> buffer;
+    typedef std::aligned_storage<
+        SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE,
+        SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT
+    >::type buffer;
 
     struct handle_base
     {
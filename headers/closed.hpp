@@ -0,0 +1,121 @@
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#define alignof __alignof
+#endif
+
+#ifndef TYPE_ERASURE_CLOSED_SET
+#define TYPE_ERASURE_CLOSED_SET
+namespace type_erasure
+{
+    // The special member functions of a value whose type is one of Ts...,
+    // chosen by a runtime index counting from 1, with 0 meaning no value.
+    // Each one walks the list from the front; the compiler folds that into a
+    // chain of comparisons or a jump table.
+    template <typename... Ts>
+    struct closed_set;
+
+    template <>
+    struct closed_set<>
+    {
+        static constexpr std::size_t max_size ()
+        { return 1; }
+
+        static constexpr std::size_t max_alignment ()
+        { return 1; }
+
+        static constexpr bool nothrow_movable ()
+        { return true; }
+
+        template <typename U>
+        static constexpr std::size_t index_of ()
+        { return 0; }
+
+        static void copy (std::size_t, const void*, void*)
+        {}
+
+        static void move (std::size_t, void*, void*) noexcept
+        {}
+
+        static void destroy (std::size_t, void*) noexcept
+        {}
+    };
+
+    template <typename T, typename... Ts>
+    struct closed_set<T, Ts...>
+    {
+        using rest = closed_set<Ts...>;
+
+        static constexpr std::size_t max_size ()
+        { return rest::max_size() < sizeof(T) ? sizeof(T) : rest::max_size(); }
+
+        static constexpr std::size_t max_alignment ()
+        { return rest::max_alignment() < alignof(T) ? alignof(T) : rest::max_alignment(); }
+
+        static constexpr bool nothrow_movable ()
+        { return std::is_nothrow_move_constructible<T>::value && rest::nothrow_movable(); }
+
+        template <typename U>
+        static constexpr std::size_t index_of ()
+        {
+            return std::is_same<T, U>::value ?
+                1 :
+                rest::template index_of<U>() ? rest::template index_of<U>() + 1 : 0;
+        }
+
+        static void copy (std::size_t index, const void* from, void* to)
+        {
+            if (index == 1)
+                ::new (to) T(*static_cast<const T*>(from));
+            else
+                rest::copy(index - 1, from, to);
+        }
+
+        static void move (std::size_t index, void* from, void* to) noexcept(nothrow_movable())
+        {
+            if (index == 1)
+                ::new (to) T(std::move(*static_cast<T*>(from)));
+            else
+                rest::move(index - 1, from, to);
+        }
+
+        static void destroy (std::size_t index, void* value) noexcept
+        {
+            if (index == 1)
+                static_cast<T*>(value)->~T();
+            else
+                rest::destroy(index - 1, value);
+        }
+    };
+}
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
@@ -0,0 +1,178 @@
+
+#ifndef TYPE_ERASURE_COLLECTION
+#define TYPE_ERASURE_COLLECTION
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace type_erasure
+{
+    // A container for values of any types that bind to Ref, a reference type
+    // generated from forms/ref.hpp.  The values of each type are kept in
+    // their own std::vector, a segment, so iteration walks memory in order
+    // and calls through Ref go to the same function for a whole segment.
+    // for_each<Ts...>() goes further, and calls its function object on the
+    // values of the types Ts... directly, in loops the compiler can inline.
+    // Inserting or erasing invalidates references into the affected segment
+    // only.  Segments are visited in the order their types were first
+    // inserted.
+    template <typename Ref>
+    class collection
+    {
+    public:
+        template <typename T>
+        typename std::decay<T>::type& insert (T&& value)
+        {
+            std::vector<typename std::decay<T>::type>& values =
+                segment<typename std::decay<T>::type>();
+            values.push_back(std::forward<T>(value));
+            return values.back();
+        }
+
+        // The values of type T, in insertion order.  Erase or reorder them as
+        // in any std::vector.
+        template <typename T>
+        std::vector<T>& segment ()
+        {
+            for (const std::unique_ptr<SegmentBase>& segment : segments_) {
+                if (segment->type_id() == type_id<T>())
+                    return static_cast<Segment<T>&>(*segment).values_;
+            }
+            segments_.emplace_back(new Segment<T>);
+            return static_cast<Segment<T>&>(*segments_.back()).values_;
+        }
+
+        // Calls f(value) for each value of one of the types Ts..., and f(Ref)
+        // for all others.
+        template <typename... Ts, typename F>
+        F for_each (F f)
+        {
+            for (const std::unique_ptr<SegmentBase>& segment : segments_) {
+                if (!for_each_in(*segment, f, Types<Ts...>()))
+                    segment->for_each(&call<F>, &f);
+            }
+            return f;
+        }
+
+        // Erases every value for which pred(Ref) is true.  Returns the number
+        // of values erased.
+        template <typename Pred>
+        std::size_t erase_if (Pred pred)
+        {
+            std::size_t retval = 0;
+            for (const std::unique_ptr<SegmentBase>& segment : segments_) {
+                retval += segment->erase_if(&test<Pred>, &pred);
+            }
+            return retval;
+        }
+
+        std::size_t size () const noexcept
+        {
+            std::size_t retval = 0;
+            for (const std::unique_ptr<SegmentBase>& segment : segments_) {
+                retval += segment->size();
+            }
+            return retval;
+        }
+
+        bool empty () const noexcept
+        {
+            return size() == 0;
+        }
+
+        void clear () noexcept
+        {
+            segments_.clear();
+        }
+
+    private:
+        template <typename... Ts>
+        struct Types
+        {};
+
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+
+        struct SegmentBase
+        {
+            virtual ~SegmentBase () {}
+            virtual const void* type_id () const noexcept = 0;
+            virtual std::size_t size () const noexcept = 0;
+            virtual void for_each (void (*f) (void*, Ref), void* context) = 0;
+            virtual std::size_t erase_if (bool (*pred) (void*, Ref), void* context) = 0;
+        };
+
+        template <typename T>
+        struct Segment : SegmentBase
+        {
+            virtual const void* type_id () const noexcept
+            {
+                return collection::type_id<T>();
+            }
+
+            virtual std::size_t size () const noexcept
+            {
+                return values_.size();
+            }
+
+            virtual void for_each (void (*f) (void*, Ref), void* context)
+            {
+                for (T& value : values_) {
+                    f(context, Ref(value));
+                }
+            }
+
+            virtual std::size_t erase_if (bool (*pred) (void*, Ref), void* context)
+            {
+                const std::size_t size = values_.size();
+                values_.erase(
+                    std::remove_if(values_.begin(), values_.end(),
+                                   [=](T& value) { return pred(context, Ref(value)); }),
+                    values_.end()
+                );
+                return size - values_.size();
+            }
+
+            std::vector<T> values_;
+        };
+
+        template <typename F>
+        static bool for_each_in (SegmentBase&, F&, Types<>)
+        {
+            return false;
+        }
+
+        template <typename F, typename T, typename... Ts>
+        static bool for_each_in (SegmentBase& segment, F& f, Types<T, Ts...>)
+        {
+            if (segment.type_id() != type_id<T>())
+                return for_each_in(segment, f, Types<Ts...>());
+            for (T& value : static_cast<Segment<T>&>(segment).values_) {
+                f(value);
+            }
+            return true;
+        }
+
+        template <typename F>
+        static void call (void* f, Ref ref)
+        {
+            (*static_cast<F*>(f))(ref);
+        }
+
+        template <typename Pred>
+        static bool test (void* pred, Ref ref)
+        {
+            return (*static_cast<Pred*>(pred))(ref);
+        }
+
+        std::vector<std::unique_ptr<SegmentBase>> segments_;
+    };
+}
+#endif
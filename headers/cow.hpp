@@ -7,3 +7,27 @@
 #if defined(_MSC_VER) && _MSC_VER == 1800
 #define noexcept
 #endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
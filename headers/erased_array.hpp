@@ -0,0 +1,366 @@
+
+#ifndef TYPE_ERASURE_ERASED_ARRAY
+#define TYPE_ERASURE_ERASED_ARRAY
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace type_erasure
+{
+    // A sequence of values of any types that bind to Ref, a reference type
+    // generated from forms/ref.hpp, laid out end to end in one block of
+    // memory.  Each value is preceded by a header of a pointer to a table of
+    // operations for its type and the distance to the next header, and takes
+    // only the space its type needs, padded to its alignment.  Iterating
+    // yields a Ref bound to each value in turn.  If every value is trivially
+    // copyable, copying and growing the array copy the whole block at once.
+    // Stored types must be nothrow move constructible and may not be
+    // over-aligned.  Appending invalidates iterators and references.
+    template <typename Ref>
+    class erased_array
+    {
+        struct Ops
+        {
+            Ref (*bind) (void* value);
+            void (*copy) (const void* from, void* to);
+            void (*relocate) (void* from, void* to);
+            void (*destroy) (void* value);
+            std::size_t size;
+            std::size_t alignment;
+        };
+
+        using Header = const Ops*;
+        using Stride = std::uint32_t;
+
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Ref;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Ref;
+
+            iterator () = default;
+
+            Ref operator* () const
+            {
+                return ops()->bind(data_ + value_offset(pos_, *ops()));
+            }
+
+            iterator& operator++ ()
+            {
+                pos_ += *reinterpret_cast<const Stride*>(data_ + pos_ + sizeof(Header));
+                return *this;
+            }
+
+            iterator operator++ (int)
+            {
+                iterator retval = *this;
+                ++*this;
+                return retval;
+            }
+
+            friend bool operator== (iterator lhs, iterator rhs)
+            {
+                return lhs.pos_ == rhs.pos_;
+            }
+
+            friend bool operator!= (iterator lhs, iterator rhs)
+            {
+                return lhs.pos_ != rhs.pos_;
+            }
+
+        private:
+            iterator (unsigned char* data, std::size_t pos) :
+                data_ (data),
+                pos_ (pos)
+            {}
+
+            const Ops* ops () const
+            {
+                return *reinterpret_cast<const Header*>(data_ + pos_);
+            }
+
+            unsigned char* data_ = nullptr;
+            std::size_t pos_ = 0;
+
+            friend class erased_array;
+        };
+
+        erased_array () = default;
+
+        erased_array (const erased_array& rhs)
+        {
+            if (!rhs.used_)
+                return;
+            allocate(rhs.used_);
+            if (rhs.trivial_) {
+                std::memcpy(data_, rhs.data_, rhs.used_);
+            } else {
+                trivial_ = false;
+                try {
+                    for (std::size_t pos = 0; pos < rhs.used_; ) {
+                        const Ops& ops = rhs.ops_at(pos);
+                        const std::size_t value = value_offset(pos, ops);
+                        ops.copy(rhs.data_ + value, data_ + value);
+                        pos = used_ = write_header(data_, pos, ops);
+                        ++size_;
+                    }
+                } catch (...) {
+                    reset();
+                    throw;
+                }
+            }
+            used_ = rhs.used_;
+            size_ = rhs.size_;
+            trivial_ = rhs.trivial_;
+        }
+
+        erased_array (erased_array&& rhs) noexcept
+        {
+            steal(rhs);
+        }
+
+        erased_array& operator= (const erased_array& rhs)
+        {
+            erased_array temp(rhs);
+            reset();
+            steal(temp);
+            return *this;
+        }
+
+        erased_array& operator= (erased_array&& rhs) noexcept
+        {
+            if (this != &rhs) {
+                reset();
+                steal(rhs);
+            }
+            return *this;
+        }
+
+        ~erased_array ()
+        {
+            reset();
+        }
+
+        template <typename T>
+        typename std::decay<T>::type& push_back (T&& value)
+        {
+            using U = typename std::decay<T>::type;
+            static_assert(alignof(U) <= alignof(std::max_align_t),
+                          "over-aligned types cannot be stored in an erased_array");
+            static_assert(sizeof(U) < (1u << 31),
+                          "types stored in an erased_array must be smaller than 2 GB");
+            static_assert(std::is_nothrow_move_constructible<U>::value,
+                          "types stored in an erased_array must be nothrow move constructible");
+
+            const Ops& ops = *ops_for<U>();
+            const std::size_t offset = value_offset(used_, ops);
+            const std::size_t next = next_offset(used_, ops);
+            if (capacity_ < next)
+                grow(next);
+
+            U* retval = ::new (data_ + offset) U(std::forward<T>(value));
+            write_header(data_, used_, ops);
+            used_ = next;
+            ++size_;
+            trivial_ = trivial_ && std::is_trivially_copyable<U>::value;
+            return *retval;
+        }
+
+        iterator begin () noexcept
+        {
+            return iterator(data_, 0);
+        }
+
+        iterator end () noexcept
+        {
+            return iterator(data_, used_);
+        }
+
+        // The number of values.
+        std::size_t size () const noexcept
+        {
+            return size_;
+        }
+
+        bool empty () const noexcept
+        {
+            return size_ == 0;
+        }
+
+        // The number of bytes taken by the values and their headers.
+        std::size_t bytes () const noexcept
+        {
+            return used_;
+        }
+
+        std::size_t capacity_bytes () const noexcept
+        {
+            return capacity_;
+        }
+
+        void reserve_bytes (std::size_t bytes)
+        {
+            if (capacity_ < bytes)
+                reallocate(bytes);
+        }
+
+        void clear () noexcept
+        {
+            destroy_all();
+            used_ = 0;
+            size_ = 0;
+            trivial_ = true;
+        }
+
+    private:
+        template <typename T>
+        struct OpsFor
+        {
+            static Ref bind (void* value)
+            {
+                return Ref(*static_cast<T*>(value));
+            }
+
+            static void copy (const void* from, void* to)
+            {
+                ::new (to) T(*static_cast<const T*>(from));
+            }
+
+            static void relocate (void* from, void* to)
+            {
+                T& value = *static_cast<T*>(from);
+                ::new (to) T(std::move(value));
+                value.~T();
+            }
+
+            static void destroy (void* value)
+            {
+                static_cast<T*>(value)->~T();
+            }
+        };
+
+        template <typename T>
+        static const Ops* ops_for ()
+        {
+            static constexpr Ops ops = {
+                &OpsFor<T>::bind,
+                &OpsFor<T>::copy,
+                &OpsFor<T>::relocate,
+                &OpsFor<T>::destroy,
+                sizeof(T),
+                alignof(T)
+            };
+            return &ops;
+        }
+
+        // The block starts at an address aligned for any type, so offsets
+        // into it are as aligned as the addresses they lead to.  Alignments
+        // are powers of two.
+        static std::size_t align (std::size_t offset, std::size_t alignment)
+        {
+            return (offset + alignment - 1) & ~(alignment - 1);
+        }
+
+        static std::size_t value_offset (std::size_t pos, const Ops& ops)
+        {
+            return align(pos + sizeof(Header) + sizeof(Stride), ops.alignment);
+        }
+
+        static std::size_t next_offset (std::size_t pos, const Ops& ops)
+        {
+            return align(value_offset(pos, ops) + ops.size, alignof(Header));
+        }
+
+        // Returns the offset of the next header.
+        static std::size_t write_header (unsigned char* data, std::size_t pos, const Ops& ops)
+        {
+            const std::size_t next = next_offset(pos, ops);
+            ::new (data + pos) Header(&ops);
+            ::new (data + pos + sizeof(Header)) Stride(static_cast<Stride>(next - pos));
+            return next;
+        }
+
+        const Ops& ops_at (std::size_t pos) const
+        {
+            return **reinterpret_cast<const Header*>(data_ + pos);
+        }
+
+        void allocate (std::size_t bytes)
+        {
+            data_ = static_cast<unsigned char*>(::operator new(bytes));
+            capacity_ = bytes;
+        }
+
+        void grow (std::size_t bytes)
+        {
+            reallocate(capacity_ * 2 < bytes ? bytes : capacity_ * 2);
+        }
+
+        void reallocate (std::size_t bytes)
+        {
+            unsigned char* const data = static_cast<unsigned char*>(::operator new(bytes));
+            if (trivial_) {
+                if (used_)
+                    std::memcpy(data, data_, used_);
+            } else {
+                for (std::size_t pos = 0; pos < used_; ) {
+                    const Ops& ops = ops_at(pos);
+                    const std::size_t value = value_offset(pos, ops);
+                    ops.relocate(data_ + value, data + value);
+                    pos = write_header(data, pos, ops);
+                }
+            }
+            ::operator delete(data_);
+            data_ = data;
+            capacity_ = bytes;
+        }
+
+        void destroy_all () noexcept
+        {
+            if (trivial_)
+                return;
+            for (std::size_t pos = 0; pos < used_; ) {
+                const Ops& ops = ops_at(pos);
+                ops.destroy(data_ + value_offset(pos, ops));
+                pos = next_offset(pos, ops);
+            }
+        }
+
+        void reset () noexcept
+        {
+            clear();
+            ::operator delete(data_);
+            data_ = nullptr;
+            capacity_ = 0;
+        }
+
+        void steal (erased_array& rhs) noexcept
+        {
+            data_ = rhs.data_;
+            capacity_ = rhs.capacity_;
+            used_ = rhs.used_;
+            size_ = rhs.size_;
+            trivial_ = rhs.trivial_;
+            rhs.data_ = nullptr;
+            rhs.capacity_ = 0;
+            rhs.used_ = 0;
+            rhs.size_ = 0;
+            rhs.trivial_ = true;
+        }
+
+        unsigned char* data_ = nullptr;
+        std::size_t capacity_ = 0;
+        std::size_t used_ = 0;
+        std::size_t size_ = 0;
+        bool trivial_ = true;
+    };
+}
+#endif
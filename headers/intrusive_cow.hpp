@@ -0,0 +1,89 @@
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#endif
+
+#ifndef TYPE_ERASURE_LOCAL_REF_COUNT
+#define TYPE_ERASURE_LOCAL_REF_COUNT
+namespace type_erasure
+{
+    // A reference count without atomic operations, for erased objects that
+    // are only ever used by one thread.  In debug builds it asserts that it
+    // is not touched by any other thread than the one that created it.  Only
+    // what reads or changes the count is checked: copying, assigning or
+    // destroying an erased object, and non-const calls on it.  Const calls
+    // are not, and neither are values kept without a count, such as those in
+    // the sbo_cow buffer.
+    class local_ref_count
+    {
+    public:
+        local_ref_count (std::size_t count) noexcept :
+            count_ (count)
+        {}
+
+        local_ref_count& operator++ () noexcept
+        {
+            check_thread();
+            ++count_;
+            return *this;
+        }
+
+        local_ref_count& operator-- () noexcept
+        {
+            check_thread();
+            --count_;
+            return *this;
+        }
+
+        operator std::size_t () const noexcept
+        {
+            check_thread();
+            return count_;
+        }
+
+    private:
+        void check_thread () const noexcept
+        {
+            assert(owner_ == std::this_thread::get_id() &&
+                   "erased object used by more than one thread");
+        }
+
+        std::size_t count_;
+#ifndef NDEBUG
+        std::thread::id owner_ = std::this_thread::get_id();
+#endif
+    };
+}
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
@@ -0,0 +1,133 @@
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#endif
+
+#ifndef TYPE_ERASURE_MEMORY_RESOURCE
+#define TYPE_ERASURE_MEMORY_RESOURCE
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#define TYPE_ERASURE_STD_PMR
+#endif
+#endif
+
+#ifdef TYPE_ERASURE_STD_PMR
+#include <memory_resource>
+
+namespace type_erasure
+{
+    using memory_resource = std::pmr::memory_resource;
+
+    inline memory_resource* default_resource () noexcept
+    {
+        return std::pmr::get_default_resource();
+    }
+}
+#else
+namespace type_erasure
+{
+    // The part of C++17's std::pmr::memory_resource used by the erased types.
+    // With C++17, this is std::pmr::memory_resource itself.
+    class memory_resource
+    {
+    public:
+        virtual ~memory_resource () {}
+
+        void* allocate (std::size_t bytes,
+                        std::size_t alignment = alignof(std::max_align_t))
+        {
+            return do_allocate(bytes, alignment);
+        }
+
+        void deallocate (void* ptr, std::size_t bytes,
+                         std::size_t alignment = alignof(std::max_align_t))
+        {
+            do_deallocate(ptr, bytes, alignment);
+        }
+
+        bool is_equal (const memory_resource& other) const noexcept
+        {
+            return do_is_equal(other);
+        }
+
+    private:
+        virtual void* do_allocate (std::size_t bytes, std::size_t alignment) = 0;
+        virtual void do_deallocate (void* ptr, std::size_t bytes, std::size_t alignment) = 0;
+        virtual bool do_is_equal (const memory_resource& other) const noexcept = 0;
+    };
+
+    // Uses the global operator new and operator delete.
+    inline memory_resource* default_resource () noexcept
+    {
+        struct new_delete_resource : memory_resource
+        {
+            void* do_allocate (std::size_t bytes, std::size_t alignment) override
+            {
+                assert(alignment <= alignof(std::max_align_t));
+                return ::operator new(bytes);
+            }
+
+            void do_deallocate (void* ptr, std::size_t, std::size_t) override
+            {
+                ::operator delete(ptr);
+            }
+
+            bool do_is_equal (const memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+        static new_delete_resource resource;
+        return &resource;
+    }
+}
+#endif
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
+
+#ifndef TYPE_ERASURE_LEADS_WITH_RESOURCE
+#define TYPE_ERASURE_LEADS_WITH_RESOURCE
+namespace type_erasure
+{
+    // Whether the first of Args is a memory_resource*.  Such arguments select
+    // the in-place constructors that take a resource, so that it is never
+    // passed on to the constructor of the stored type.
+    template <typename... Args>
+    struct leads_with_resource : std::false_type
+    {};
+
+    template <typename Arg, typename... Args>
+    struct leads_with_resource<Arg, Args...> : std::is_convertible<Arg, memory_resource*>
+    {};
+}
+#endif
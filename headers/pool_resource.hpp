@@ -0,0 +1,327 @@
+
+#ifndef TYPE_ERASURE_POOL_RESOURCE
+#define TYPE_ERASURE_POOL_RESOURCE
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace type_erasure
+{
+    // A memory_resource that keeps one free list per size class, and recycles
+    // freed blocks instead of returning them to its upstream resource.  Blocks
+    // of up to max_block_size() bytes are carved out of chunks allocated from
+    // upstream; larger or over-aligned requests go to upstream directly.
+    // release() returns all chunks to upstream at once, and so must only be
+    // called when no block handed out by the pool is in use anymore.  Not
+    // thread safe; see thread_local_pool_resource().
+    class pool_resource : public memory_resource
+    {
+    public:
+        explicit pool_resource (memory_resource* upstream = default_resource()) noexcept :
+            upstream_ (upstream)
+        {}
+
+        pool_resource (const pool_resource&) = delete;
+        pool_resource& operator= (const pool_resource&) = delete;
+
+        ~pool_resource ()
+        {
+            release();
+        }
+
+        void release () noexcept
+        {
+            while (chunks_) {
+                Chunk* const next = chunks_->next;
+                upstream_->deallocate(chunks_, chunk_size, granularity);
+                chunks_ = next;
+            }
+            for (Block*& free_list : free_lists_) {
+                free_list = nullptr;
+            }
+        }
+
+        memory_resource* upstream_resource () const noexcept
+        {
+            return upstream_;
+        }
+
+        static constexpr std::size_t max_block_size ()
+        {
+            return max_size;
+        }
+
+        static constexpr std::size_t chunk_bytes ()
+        {
+            return chunk_size;
+        }
+
+    private:
+        enum : std::size_t {
+            granularity = alignof(std::max_align_t),
+            max_size = 256,
+            chunk_size = 16384,
+            size_classes = max_size / granularity
+        };
+
+        struct Block
+        {
+            Block* next;
+        };
+
+        // Stored at the start of each chunk, in front of its first block.
+        struct Chunk
+        {
+            Chunk* next;
+        };
+
+        static bool pooled (std::size_t bytes, std::size_t alignment) noexcept
+        {
+            return bytes <= max_size && alignment <= granularity;
+        }
+
+        static std::size_t size_class (std::size_t bytes) noexcept
+        {
+            return bytes ? (bytes - 1) / granularity : 0;
+        }
+
+        void* do_allocate (std::size_t bytes, std::size_t alignment) override
+        {
+            if (!pooled(bytes, alignment))
+                return upstream_->allocate(bytes, alignment);
+
+            Block*& free_list = free_lists_[size_class(bytes)];
+            if (!free_list)
+                refill(size_class(bytes));
+
+            Block* const block = free_list;
+            free_list = block->next;
+            return block;
+        }
+
+        void do_deallocate (void* ptr, std::size_t bytes, std::size_t alignment) override
+        {
+            if (!pooled(bytes, alignment)) {
+                upstream_->deallocate(ptr, bytes, alignment);
+                return;
+            }
+
+            Block*& free_list = free_lists_[size_class(bytes)];
+            free_list = new (ptr) Block{free_list};
+        }
+
+        bool do_is_equal (const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        // Carves a new chunk into blocks of the given size class.
+        void refill (std::size_t size_class)
+        {
+            unsigned char* const chunk = static_cast<unsigned char*>(
+                upstream_->allocate(chunk_size, granularity)
+            );
+            chunks_ = new (chunk) Chunk{chunks_};
+
+            const std::size_t block_size = (size_class + 1) * granularity;
+            Block*& free_list = free_lists_[size_class];
+            for (std::size_t offset = granularity;
+                 offset + block_size <= chunk_size;
+                 offset += block_size) {
+                free_list = new (chunk + offset) Block{free_list};
+            }
+        }
+
+        memory_resource* upstream_;
+        Block* free_lists_[size_classes] = {};
+        Chunk* chunks_ = nullptr;
+    };
+
+    // What thread_local_pool_resource() keeps for one thread: its pool, and
+    // the blocks other threads have freed.  Those are pushed onto a lock-free
+    // list, which the owning thread moves into its pool on its next
+    // allocation.  Each block records its owner in front of the bytes handed
+    // out.  The state outlives its thread for as long as any of its blocks
+    // are in use; whichever thread frees the last one deletes it.
+    class thread_local_pool_state
+    {
+    public:
+        thread_local_pool_state (const thread_local_pool_state&) = delete;
+        thread_local_pool_state& operator= (const thread_local_pool_state&) = delete;
+
+        // The calling thread's state, created on first use.
+        static thread_local_pool_state& current ()
+        {
+            static thread_local Owner owner;
+            return *owner.state;
+        }
+
+        // Returns all of the pool's chunks to upstream at once.  Blocks that
+        // other threads have freed are dropped first, since they live in
+        // those chunks.  Must be called on the owning thread, once no block
+        // from the pool is in use on any thread.
+        void release () noexcept
+        {
+            remote_frees_.store(nullptr, std::memory_order_relaxed);
+            pool_.release();
+        }
+
+        // Must be called on the owning thread.
+        void* allocate (std::size_t bytes, std::size_t alignment)
+        {
+            drain();
+
+            const std::size_t header = header_size(alignment);
+            unsigned char* const payload = static_cast<unsigned char*>(
+                pool_.allocate(block_size(bytes, alignment), alignment)
+            ) + header;
+            new (payload - sizeof(thread_local_pool_state*)) thread_local_pool_state*(this);
+            users_.fetch_add(1, std::memory_order_relaxed);
+            return payload;
+        }
+
+        // May be called on any thread.
+        static void deallocate (void* ptr, std::size_t bytes, std::size_t alignment)
+        {
+            unsigned char* const payload = static_cast<unsigned char*>(ptr);
+            const std::size_t header = header_size(alignment);
+            thread_local_pool_state* const owner =
+                *reinterpret_cast<thread_local_pool_state**>(payload - sizeof(thread_local_pool_state*));
+
+            if (owner == running()) {
+                owner->pool_.deallocate(payload - header, block_size(bytes, alignment), alignment);
+                owner->users_.fetch_sub(1, std::memory_order_relaxed);
+            } else {
+                owner->free_remote(payload - header, block_size(bytes, alignment), alignment);
+            }
+        }
+
+    private:
+        // A block freed by another thread than its owner.
+        struct RemoteBlock
+        {
+            RemoteBlock* next;
+            std::size_t bytes;
+            std::size_t alignment;
+        };
+
+        // Ends the owning thread's use of the state.
+        struct Owner
+        {
+            Owner () :
+                state (new thread_local_pool_state)
+            {
+                running() = state;
+            }
+
+            ~Owner ()
+            {
+                running() = nullptr;
+                state->release_user();
+            }
+
+            thread_local_pool_state* state;
+        };
+
+        thread_local_pool_state () = default;
+
+        // The state of the calling thread, or null once that thread is ending.
+        // A plain pointer, so it can still be read while thread_local objects
+        // are being destroyed.
+        static thread_local_pool_state*& running () noexcept
+        {
+            static thread_local thread_local_pool_state* state = nullptr;
+            return state;
+        }
+
+        // Room for the owner in front of the bytes handed out, keeping them
+        // aligned.
+        static std::size_t header_size (std::size_t alignment) noexcept
+        {
+            return alignof(std::max_align_t) < alignment ? alignment : alignof(std::max_align_t);
+        }
+
+        // The whole block, which becomes a RemoteBlock if another thread
+        // frees it.
+        static std::size_t block_size (std::size_t bytes, std::size_t alignment) noexcept
+        {
+            return header_size(alignment) + bytes < sizeof(RemoteBlock) ?
+                sizeof(RemoteBlock) : header_size(alignment) + bytes;
+        }
+
+        void free_remote (void* block, std::size_t bytes, std::size_t alignment) noexcept
+        {
+            RemoteBlock* const remote = new (block) RemoteBlock{
+                remote_frees_.load(std::memory_order_relaxed), bytes, alignment
+            };
+            while (!remote_frees_.compare_exchange_weak(remote->next, remote,
+                                                        std::memory_order_release,
+                                                        std::memory_order_relaxed)) {
+            }
+            release_user();
+        }
+
+        void drain () noexcept
+        {
+            if (!remote_frees_.load(std::memory_order_relaxed))
+                return;
+
+            RemoteBlock* remote = remote_frees_.exchange(nullptr, std::memory_order_acquire);
+            while (remote) {
+                RemoteBlock* const next = remote->next;
+                pool_.deallocate(remote, remote->bytes, remote->alignment);
+                remote = next;
+            }
+        }
+
+        void release_user () noexcept
+        {
+            if (users_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                drain();
+                delete this;
+            }
+        }
+
+        pool_resource pool_;
+        std::atomic<RemoteBlock*> remote_frees_{nullptr};
+        // The owning thread while it runs, plus each block in use.
+        std::atomic<std::size_t> users_{1};
+    };
+
+    // The calling thread's pool.  Call release() on it to free everything it
+    // holds at once, once no block from it is in use on any thread.
+    inline thread_local_pool_state& thread_local_pool () noexcept
+    {
+        return thread_local_pool_state::current();
+    }
+
+    // Allocates from thread_local_pool() of the calling thread, so allocation
+    // takes no locks.  A block may be freed on any thread: one freed by
+    // another thread than the one that allocated it goes back to its own
+    // pool, which lives on after its thread ends until all of its blocks
+    // have been freed.
+    inline memory_resource* thread_local_pool_resource () noexcept
+    {
+        struct thread_local_pool_dispatch : memory_resource
+        {
+            void* do_allocate (std::size_t bytes, std::size_t alignment) override
+            {
+                return thread_local_pool_state::current().allocate(bytes, alignment);
+            }
+
+            void do_deallocate (void* ptr, std::size_t bytes, std::size_t alignment) override
+            {
+                thread_local_pool_state::deallocate(ptr, bytes, alignment);
+            }
+
+            bool do_is_equal (const memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+        static thread_local_pool_dispatch resource;
+        return &resource;
+    }
+}
+#endif
@@ -0,0 +1,80 @@
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#endif
+
+#ifndef TYPE_ERASURE_DELEGATE
+#define TYPE_ERASURE_DELEGATE
+namespace type_erasure
+{
+    // A member function of an erased object bound to that object, as
+    // returned by the generated bind_*() members: a pointer to the object's
+    // storage, and the function pointer its table holds for the stored type.
+    // Calling it makes no lookup.  It is trivially copyable, and two pointers
+    // in size.
+    //
+    // It is invalidated when the erased object is destroyed or moved from, or
+    // given a new value by assignment or emplace(), even one of the same type.
+    // When TYPE_ERASURE_CHECK_DELEGATES is defined, delegates and erased
+    // objects grow by a count of these changes, and calls assert that none
+    // has happened since the delegate was bound while the erased object
+    // lives.  Define it in every translation unit or in none, since it
+    // changes the layout of both.  Calling a delegate after the erased object
+    // is destroyed cannot be checked.
+    template <typename Signature>
+    class delegate;
+
+    template <typename R, typename Object, typename... Args>
+    class delegate<R (Object*, Args...)>
+    {
+    public:
+        using function_type = R (*) (Object*, Args...);
+
+        delegate () = default;
+
+        delegate (Object* object, function_type function,
+                  const void* owner, std::size_t (*generation_of) (const void*)) noexcept :
+            object_ (object),
+            function_ (function)
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            ,
+            owner_ (owner),
+            generation_ (generation_of(owner)),
+            generation_of_ (generation_of)
+#endif
+        {
+            (void)owner;
+            (void)generation_of;
+        }
+
+        R operator() (Args... args) const
+        {
+            assert(function_);
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            assert(generation_of_(owner_) == generation_ &&
+                   "delegate used after its object was given a new value or moved from");
+#endif
+            return function_(object_, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool () const noexcept
+        {
+            return function_ != nullptr;
+        }
+
+    private:
+        Object* object_ = nullptr;
+        function_type function_ = nullptr;
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+        const void* owner_ = nullptr;
+        std::size_t generation_ = 0;
+        std::size_t (*generation_of_) (const void*) = nullptr;
+#endif
+    };
+}
+#endif
@@ -1,6 +1,8 @@
 #include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -9,3 +11,48 @@
 #define noexcept
 #define alignof __alignof
 #endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT alignof(void*)
+#endif
+
+#ifndef TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+#define TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+namespace type_erasure
+{
+    // Values of types for which this is true are moved by copying their bytes,
+    // without calling the move constructor or the destructor.  True for
+    // trivially copyable types; specialize it for other types that allow this.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T>
+    {};
+}
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
@@ -0,0 +1,220 @@
+
+#ifndef TYPE_ERASURE_SLOT_MAP
+#define TYPE_ERASURE_SLOT_MAP
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace type_erasure
+{
+    // A container of values of type T, usually a generated erased type, that
+    // hands out a handle for each value inserted.  Values are kept in one
+    // contiguous std::vector, so iterating over them walks memory in order.
+    // Erasing moves the last value into the erased one's place, so values
+    // move, but handles stay valid until their own value is erased.  A
+    // handle is a slot index and a generation packed into 64 bits.  Erasing
+    // bumps the generation of the slot, so stale handles are detected even
+    // after the slot is reused.
+    template <typename T>
+    class slot_map
+    {
+    public:
+        class handle
+        {
+        public:
+            handle () = default;
+
+            explicit handle (std::uint64_t value) noexcept :
+                value_ (value)
+            {}
+
+            std::uint64_t value () const noexcept
+            {
+                return value_;
+            }
+
+            friend bool operator== (handle lhs, handle rhs) noexcept
+            {
+                return lhs.value_ == rhs.value_;
+            }
+
+            friend bool operator!= (handle lhs, handle rhs) noexcept
+            {
+                return lhs.value_ != rhs.value_;
+            }
+
+        private:
+            handle (std::uint32_t slot, std::uint32_t generation) noexcept :
+                value_ (std::uint64_t(generation) << 32 | slot)
+            {}
+
+            std::uint32_t slot () const noexcept
+            {
+                return static_cast<std::uint32_t>(value_);
+            }
+
+            std::uint32_t generation () const noexcept
+            {
+                return static_cast<std::uint32_t>(value_ >> 32);
+            }
+
+            // Generation 0 is never live, so a default handle is never
+            // valid.
+            std::uint64_t value_ = 0;
+
+            friend class slot_map;
+        };
+
+        using iterator = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        template <typename U>
+        handle insert (U&& value)
+        {
+            const bool reuse = free_ != no_slot;
+            const std::uint32_t slot_index =
+                reuse ? free_ : static_cast<std::uint32_t>(slots_.size());
+
+            values_.emplace_back(std::forward<U>(value));
+            try {
+                slot_of_.push_back(slot_index);
+                if (!reuse)
+                    slots_.push_back(Slot());
+            } catch (...) {
+                if (slot_of_.size() == values_.size())
+                    slot_of_.pop_back();
+                values_.pop_back();
+                throw;
+            }
+
+            Slot& slot = slots_[slot_index];
+            if (reuse)
+                free_ = slot.index;
+            slot.index = static_cast<std::uint32_t>(values_.size() - 1);
+            ++slot.generation;
+            return handle(slot_index, slot.generation);
+        }
+
+        // Returns whether h referred to a value.
+        bool erase (handle h)
+        {
+            if (!contains(h))
+                return false;
+
+            Slot& slot = slots_[h.slot()];
+            const std::uint32_t index = slot.index;
+            const std::uint32_t last = static_cast<std::uint32_t>(values_.size() - 1);
+            if (index != last) {
+                values_[index] = std::move(values_[last]);
+                slot_of_[index] = slot_of_[last];
+                slots_[slot_of_[index]].index = index;
+            }
+            values_.pop_back();
+            slot_of_.pop_back();
+
+            ++slot.generation;
+            slot.index = free_;
+            free_ = h.slot();
+            return true;
+        }
+
+        bool contains (handle h) const noexcept
+        {
+            return h.slot() < slots_.size() &&
+                slots_[h.slot()].generation == h.generation() &&
+                (h.generation() & 1);
+        }
+
+        // Returns nullptr if h does not refer to a value.  The pointer is
+        // invalidated by the next insert or erase.
+        T* find (handle h) noexcept
+        {
+            return contains(h) ? &values_[slots_[h.slot()].index] : nullptr;
+        }
+
+        const T* find (handle h) const noexcept
+        {
+            return contains(h) ? &values_[slots_[h.slot()].index] : nullptr;
+        }
+
+        T& operator[] (handle h) noexcept
+        {
+            assert(contains(h));
+            return values_[slots_[h.slot()].index];
+        }
+
+        const T& operator[] (handle h) const noexcept
+        {
+            assert(contains(h));
+            return values_[slots_[h.slot()].index];
+        }
+
+        iterator begin () noexcept
+        {
+            return values_.begin();
+        }
+
+        iterator end () noexcept
+        {
+            return values_.end();
+        }
+
+        const_iterator begin () const noexcept
+        {
+            return values_.begin();
+        }
+
+        const_iterator end () const noexcept
+        {
+            return values_.end();
+        }
+
+        std::size_t size () const noexcept
+        {
+            return values_.size();
+        }
+
+        bool empty () const noexcept
+        {
+            return values_.empty();
+        }
+
+        void reserve (std::size_t size)
+        {
+            values_.reserve(size);
+            slot_of_.reserve(size);
+            slots_.reserve(size);
+        }
+
+        void clear () noexcept
+        {
+            for (std::uint32_t slot_index : slot_of_) {
+                Slot& slot = slots_[slot_index];
+                ++slot.generation;
+                slot.index = free_;
+                free_ = slot_index;
+            }
+            values_.clear();
+            slot_of_.clear();
+        }
+
+    private:
+        enum : std::uint32_t { no_slot = 0xffffffff };
+
+        // A live slot has an odd generation, and holds the index of its
+        // value.  A free slot holds the index of the next free slot.
+        struct Slot
+        {
+            std::uint32_t index = 0;
+            std::uint32_t generation = 0;
+        };
+
+        std::vector<T> values_;
+        std::vector<std::uint32_t> slot_of_;
+        std::vector<Slot> slots_;
+        std::uint32_t free_ = no_slot;
+    };
+}
+#endif
@@ -0,0 +1,128 @@
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#define alignof __alignof
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT alignof(void*)
+#endif
+
+#ifndef TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+#define TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+namespace type_erasure
+{
+    // Values of types for which this is true are moved by copying their bytes,
+    // without calling the move constructor or the destructor.  True for
+    // trivially copyable types; specialize it for other types that allow this.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T>
+    {};
+}
+#endif
+
+#ifndef TYPE_ERASURE_DELEGATE
+#define TYPE_ERASURE_DELEGATE
+namespace type_erasure
+{
+    // A member function of an erased object bound to that object, as
+    // returned by the generated bind_*() members: a pointer to the object's
+    // storage, and the function pointer its table holds for the stored type.
+    // Calling it makes no lookup.  It is trivially copyable, and two pointers
+    // in size.
+    //
+    // It is invalidated when the erased object is destroyed or moved from, or
+    // given a new value by assignment or emplace(), even one of the same type.
+    // When TYPE_ERASURE_CHECK_DELEGATES is defined, delegates and erased
+    // objects grow by a count of these changes, and calls assert that none
+    // has happened since the delegate was bound while the erased object
+    // lives.  Define it in every translation unit or in none, since it
+    // changes the layout of both.  Calling a delegate after the erased object
+    // is destroyed cannot be checked.
+    template <typename Signature>
+    class delegate;
+
+    template <typename R, typename Object, typename... Args>
+    class delegate<R (Object*, Args...)>
+    {
+    public:
+        using function_type = R (*) (Object*, Args...);
+
+        delegate () = default;
+
+        delegate (Object* object, function_type function,
+                  const void* owner, std::size_t (*generation_of) (const void*)) noexcept :
+            object_ (object),
+            function_ (function)
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            ,
+            owner_ (owner),
+            generation_ (generation_of(owner)),
+            generation_of_ (generation_of)
+#endif
+        {
+            (void)owner;
+            (void)generation_of;
+        }
+
+        R operator() (Args... args) const
+        {
+            assert(function_);
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            assert(generation_of_(owner_) == generation_ &&
+                   "delegate used after its object was given a new value or moved from");
+#endif
+            return function_(object_, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool () const noexcept
+        {
+            return function_ != nullptr;
+        }
+
+    private:
+        Object* object_ = nullptr;
+        function_type function_ = nullptr;
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+        const void* owner_ = nullptr;
+        std::size_t generation_ = 0;
+        std::size_t (*generation_of_) (const void*) = nullptr;
+#endif
+    };
+}
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
@@ -0,0 +1,94 @@
+// Built with -std=c++17 where the compiler supports it, so that new
+// expressions honour the alignment of over-aligned types.  Values too large
+// for the buffer must still be aligned once they are on the heap.  The erased
+// types here are also compiled as C++11 into unit_tests, so this file is a
+// test program of its own, aligned_new_tests.
+
+#include <gtest/gtest.h>
+
+#include "sbo/interface.hh"
+#include "sbo_cow/interface.hh"
+
+#include <array>
+#include <cstdint>
+
+#if defined(__cpp_aligned_new)
+
+namespace
+{
+    struct alignas(64) OverAligned
+    {
+        int foo() const
+        {
+            return value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_ = 1;
+        std::array<char, 100> buffer_;
+    };
+
+    struct Other
+    {
+        int foo() const
+        {
+            return 2;
+        }
+
+        void set_value(int)
+        {}
+
+    private:
+        std::array<double, 32> buffer_;
+    };
+
+    template <typename Fooable>
+    bool aligned (Fooable& fooable)
+    {
+        const auto address =
+            reinterpret_cast<std::uintptr_t>(fooable.template cast<OverAligned>());
+        return address != 0 && address % alignof(OverAligned) == 0;
+    }
+
+    template <typename Fooable>
+    void test_alignment ()
+    {
+        ASSERT_FALSE( Fooable::template stored_inline<OverAligned>() );
+
+        for (int i = 0; i < 50; ++i) {
+            Fooable fooable = OverAligned();
+            EXPECT_TRUE( aligned(fooable) );
+
+            Fooable copy = fooable;
+            copy.set_value(i);
+            EXPECT_TRUE( aligned(copy) );
+            EXPECT_EQ( copy.foo(), i );
+
+            // Neither block is reused for a value of a different alignment.
+            copy = Other();
+            EXPECT_EQ( copy.foo(), 2 );
+            copy = OverAligned();
+            EXPECT_TRUE( aligned(copy) );
+
+            fooable.template emplace<OverAligned>();
+            EXPECT_TRUE( aligned(fooable) );
+        }
+    }
+}
+
+TEST( TestAlignedNew, SBO )
+{
+    test_alignment<SBO::Fooable>();
+}
+
+TEST( TestAlignedNew, SBOCOW )
+{
+    test_alignment<SBOCOW::Fooable>();
+}
+
+#endif
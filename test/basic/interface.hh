@@ -4,6 +4,39 @@
 #include <cassert>
 #include <memory>
 #include <utility>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
 
 
 namespace Basic {
@@ -35,6 +68,16 @@ namespace Basic {
             : handle_ ( std::move(rhs.handle_) )
         {}
     
+        // Constructs a T from args in place.
+        template <typename T, typename... Args>
+        explicit Fooable ( type_erasure::in_place_type_t<T>, Args&&... args ) :
+            handle_ (
+                new Handle<T>(
+                    type_erasure::in_place_type_t<T>(), std::forward<Args>( args )...
+                )
+            )
+        {}
+    
         // Assignment
         template <typename T,
                   typename std::enable_if<
@@ -61,24 +104,52 @@ namespace Basic {
             return *this;
         }
     
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.
+        template <typename T, typename... Args>
+        T& emplace (Args&&... args)
+        {
+            handle_.reset(
+                new Handle<T>(
+                    type_erasure::in_place_type_t<T>(), std::forward<Args>( args )...
+                )
+            );
+            return value_of<T>();
+        }
+    
         template <typename T>
         T* cast()
         {
             assert(handle_);
-            Handle<T>* handle = dynamic_cast<Handle<T>*>( handle_.get() );
-            if(handle)
-                return &handle->value_;
-            return nullptr;
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<Handle<T>*>( handle_.get() )->value_;
         }
     
         template <typename T>
         const T* cast() const
         {
             assert(handle_);
-            const Handle<T>* handle = dynamic_cast<const Handle<T>*>( handle_.get() );
-            if(handle)
-                return &handle->value_;
-            return nullptr;
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<const Handle<T>*>( handle_.get() )->value_;
+        }
+    
+        // Calls f(value) on the stored value if its type is one of those given to
+        // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+        // looked up once, so the calls f makes on value can be inlined.
+        template <typename F>
+        auto visit (F&& f) -> decltype(f(std::declval<Fooable&>()))
+        {
+            assert(handle_);
+            return visit_impl(f, *this, handle_->type_id(), VisitTypes<>());
+        }
+    
+        template <typename F>
+        auto visit (F&& f) const -> decltype(f(std::declval<const Fooable&>()))
+        {
+            assert(handle_);
+            return visit_impl(f, *this, handle_->type_id(), VisitTypes<>());
         }
     
         int foo ( ) const
@@ -93,9 +164,47 @@ namespace Basic {
         }
     
     private:
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename... Ts>
+        struct VisitTypes
+        {};
+    
+        template <typename F, typename Self>
+        static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+        {
+            return f(self);
+        }
+    
+        template <typename F, typename Self, typename T, typename... Ts>
+        static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+        {
+            if (id == type_id<T>())
+                return f(self.template value_of<T>());
+            return visit_impl(f, self, id, VisitTypes<Ts...>());
+        }
+    
+        template <typename T>
+        T& value_of ()
+        {
+            return static_cast<Handle<T>*>(handle_.get())->value_;
+        }
+    
+        template <typename T>
+        const T& value_of () const
+        {
+            return static_cast<const Handle<T>*>(handle_.get())->value_;
+        }
+    
         struct HandleBase
         {
             virtual ~HandleBase () {}
+            virtual const void* type_id () const noexcept = 0;
             virtual HandleBase * clone () const = 0;
     
             virtual int foo ( ) const = 0;
@@ -122,11 +231,21 @@ namespace Basic {
                 : value_( std::forward<U>(value) )
             {}
     
+            template <typename... Args>
+            explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+                : value_( std::forward<Args>(args)... )
+            {}
+    
             virtual HandleBase* clone () const
             { 
               return new Handle(value_);
             }
     
+            virtual const void* type_id () const noexcept
+            {
+                return Fooable::type_id<T>();
+            }
+    
             virtual int foo ( ) const {
                 return value_.foo( );
             }
@@ -147,6 +266,13 @@ namespace Basic {
     
         std::unique_ptr<HandleBase> handle_;
     };
+    
+    // Constructs a T from args in place, in a new Fooable.
+    template <typename T, typename... Args>
+    Fooable make_fooable (Args&&... args)
+    {
+        return Fooable(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
 
 }
 #endif
@@ -186,3 +186,19 @@ TEST( TestBasicFooable, ConstCast )
     EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::value );
 }
 
+TEST( TestBasicFooable, InPlace )
+{
+    using Mock::MockValueFooable;
+    MockValueFooable::transfers() = 0;
+
+    Fooable fooable( type_erasure::in_place_type_t<MockValueFooable>(), Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    MockValueFooable& value = fooable.emplace<MockValueFooable>( Mock::value );
+    EXPECT_EQ( &value, fooable.cast<MockValueFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    Fooable made = Basic::make_fooable<MockValueFooable>( Mock::other_value );
+    EXPECT_EQ( made.foo(), Mock::other_value );
+    EXPECT_EQ( MockValueFooable::transfers(), 0 );
+}
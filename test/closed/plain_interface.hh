@@ -0,0 +1,15 @@
+#ifndef CLOSED_FOOABLE_HH
+#define CLOSED_FOOABLE_HH
+
+#include "../mock_fooable.hh"
+
+namespace Closed
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
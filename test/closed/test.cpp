@@ -0,0 +1,335 @@
+#include <gtest/gtest.h>
+
+#include "interface.hh"
+#include "../mock_fooable.hh"
+
+#include <type_traits>
+
+namespace
+{
+    using Closed::Fooable;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::MockNonTrivialFooable;
+
+    void death_tests( Fooable& fooable )
+    {
+#ifndef NDEBUG
+        EXPECT_DEATH( fooable.foo(), "" );
+        EXPECT_DEATH( fooable.set_value( Mock::other_value ), "" );
+#endif
+    }
+
+    void test_interface( Fooable& fooable, int initial_value, int new_value )
+    {
+        EXPECT_EQ( fooable.foo(), initial_value );
+        fooable.set_value( new_value );
+        EXPECT_EQ( fooable.foo(), new_value );
+    }
+
+    void test_copies( Fooable& copy, const Fooable& fooable, int new_value )
+    {
+        auto value = fooable.foo();
+        test_interface( copy, value, new_value );
+        EXPECT_EQ( fooable.foo(), value );
+        ASSERT_NE( value, new_value );
+        EXPECT_NE( fooable.foo(), copy.foo() );
+    }
+}
+
+
+TEST( TestClosedFooable, Empty )
+{
+    Fooable fooable;
+    death_tests(fooable);
+
+    Fooable copy(fooable);
+    death_tests(copy);
+
+    Fooable move( std::move(fooable) );
+    death_tests(move);
+
+    Fooable copy_assign;
+    copy_assign = move;
+    death_tests(copy_assign);
+
+    Fooable move_assign;
+    move_assign = std::move(fooable);
+    death_tests(move_assign);
+}
+
+
+TEST( TestClosedFooable, CopyFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+TEST( TestClosedFooable, CopyFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+
+TEST( TestClosedFooable, CopyConstruction_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    Fooable other( fooable );
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestClosedFooable, CopyConstruction_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    Fooable other( fooable );
+    test_copies( other, fooable, Mock::other_value );
+}
+
+
+TEST( TestClosedFooable, MoveFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+TEST( TestClosedFooable, MoveFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+
+TEST( TestClosedFooable, MoveConstruction_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestClosedFooable, MoveConstruction_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+
+TEST( TestClosedFooable, CopyAssignFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = mock_fooable;
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestClosedFooable, CopyAssignFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = mock_fooable;
+    test_interface(fooable, value, Mock::other_value);
+}
+
+
+TEST( TestClosedFooable, CopyAssignment_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    Fooable other;
+    other = fooable;
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestClosedFooable, CopyAssignment_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    Fooable other;
+    other = fooable;
+    test_copies( other, fooable, Mock::other_value );
+}
+
+
+TEST( TestClosedFooable, MoveAssignFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = std::move(mock_fooable);
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestClosedFooable, MoveAssignFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = std::move(mock_fooable);
+    test_interface(fooable, value, Mock::other_value);
+}
+
+
+TEST( TestClosedFooable, MoveAssignment_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other;
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestClosedFooable, MoveAssignment_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    auto value = fooable.foo();
+    Fooable other;
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+
+TEST( TestClosedFooable, Cast_SmallObject )
+{
+    Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+
+    fooable.set_value(Mock::other_value);
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::other_value );
+}
+
+TEST( TestClosedFooable, Cast_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockLargeFooable>() == nullptr );
+
+    fooable.set_value(Mock::other_value);
+    EXPECT_EQ( fooable.cast<MockLargeFooable>()->foo(), Mock::other_value );
+}
+
+
+TEST( TestClosedFooable, ConstCast_SmallObject )
+{
+    const Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::value );
+}
+
+TEST( TestClosedFooable, ConstCast_LargeObject )
+{
+    const Fooable fooable = MockLargeFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockLargeFooable>() == nullptr );
+
+    EXPECT_EQ( fooable.cast<MockLargeFooable>()->foo(), Mock::value );
+}
+
+
+TEST( TestClosedFooable, ClosedSet )
+{
+    EXPECT_TRUE( (std::is_constructible<Fooable, MockFooable>::value) );
+    EXPECT_TRUE( (std::is_constructible<Fooable, const MockLargeFooable&>::value) );
+    EXPECT_FALSE( (std::is_constructible<Fooable, Mock::MockAlignedFooable>::value) );
+    EXPECT_FALSE( (std::is_constructible<Fooable, int>::value) );
+
+    // The largest type is stored in place, next to the index.
+    EXPECT_GE( sizeof(Fooable), sizeof(MockLargeFooable) );
+    EXPECT_LE( sizeof(Fooable), sizeof(MockLargeFooable) + alignof(MockLargeFooable) +
+                                sizeof(std::size_t) );
+}
+
+TEST( TestClosedFooable, ChangeType )
+{
+    Fooable fooable = MockFooable();
+    fooable = MockLargeFooable();
+    EXPECT_TRUE( fooable.cast<MockFooable>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockLargeFooable>() == nullptr );
+    test_interface( fooable, Mock::value, Mock::other_value );
+
+    fooable = MockNonTrivialFooable();
+    EXPECT_TRUE( fooable.cast<MockLargeFooable>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockNonTrivialFooable>() == nullptr );
+    test_interface( fooable, Mock::value, Mock::other_value );
+}
+
+TEST( TestClosedFooable, NonTrivialObject )
+{
+    {
+        Fooable fooable = MockNonTrivialFooable();
+        ASSERT_FALSE( fooable.cast<MockNonTrivialFooable>() == nullptr );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 1 );
+
+        Fooable copy( fooable );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 2 );
+        test_copies( copy, fooable, Mock::other_value );
+
+        Fooable moved( std::move(copy) );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 2 );
+        EXPECT_EQ( moved.foo(), Mock::other_value );
+
+        Fooable large = MockLargeFooable();
+        large = std::move(moved);
+        EXPECT_EQ( large.foo(), Mock::other_value );
+
+        fooable = large;
+        EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+        Fooable small = MockFooable();
+        small = std::move(fooable);
+        EXPECT_EQ( small.foo(), Mock::other_value );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
+
+TEST( TestClosedFooable, InPlace )
+{
+    {
+        Fooable fooable{ type_erasure::in_place_type_t<MockNonTrivialFooable>() };
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 1 );
+        EXPECT_EQ( fooable.foo(), Mock::value );
+
+        MockFooable& value = fooable.emplace<MockFooable>();
+        EXPECT_EQ( &value, fooable.cast<MockFooable>() );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+
+        Fooable made = Closed::make_fooable<MockNonTrivialFooable>();
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 1 );
+        EXPECT_EQ( made.foo(), Mock::value );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "../ref/interface.hh"
+#include "../mock_fooable.hh"
+#include "../util.hh"
+
+namespace
+{
+    using Ref::FooableRef;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+
+    using Collection = type_erasure::collection<FooableRef>;
+
+    struct Visitor
+    {
+        void operator() (MockFooable& value)
+        {
+            sum += value.foo();
+        }
+
+        void operator() (FooableRef value)
+        {
+            sum += value.foo();
+        }
+
+        int sum = 0;
+    };
+}
+
+TEST( TestCollection_HeapAllocations, ForEach )
+{
+    auto expected_heap_allocations = 0u;
+
+    Collection collection;
+    collection.insert( MockFooable() );
+    collection.insert( MockLargeFooable() );
+
+    CHECK_HEAP_ALLOC( collection.for_each( Visitor() ),
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( collection.for_each<MockFooable>( Visitor() ),
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( collection.erase_if( []( FooableRef value ) { return value.foo() < 0; } ),
+                      expected_heap_allocations );
+}
+
+TEST( TestCollection_HeapAllocations, Insert )
+{
+    auto expected_heap_allocations = 3u;
+
+    // The list of segments, the new segment, and its vector's storage.
+    Collection collection;
+    CHECK_HEAP_ALLOC( collection.insert( MockLargeFooable() ),
+                      expected_heap_allocations );
+
+    collection.segment<MockFooable>().reserve(2);
+
+    expected_heap_allocations = 0u;
+    CHECK_HEAP_ALLOC( collection.insert( MockFooable() );
+                      collection.insert( MockFooable() ),
+                      expected_heap_allocations );
+}
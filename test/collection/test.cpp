@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include "../ref/interface.hh"
+#include "../mock_fooable.hh"
+
+#include <vector>
+
+namespace
+{
+    using Ref::FooableRef;
+    using Ref::FooableView;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::MockNonTrivialFooable;
+
+    using Collection = type_erasure::collection<FooableRef>;
+
+    // Counts its calls by the type of its argument.
+    struct CountingVisitor
+    {
+        void operator() (MockFooable& value)
+        {
+            ++small;
+            sum += value.foo();
+        }
+
+        void operator() (MockLargeFooable& value)
+        {
+            ++large;
+            sum += value.foo();
+        }
+
+        void operator() (FooableRef value)
+        {
+            ++erased;
+            sum += value.foo();
+        }
+
+        int small = 0;
+        int large = 0;
+        int erased = 0;
+        int sum = 0;
+    };
+
+    Collection make_collection ()
+    {
+        Collection retval;
+        retval.insert( MockFooable() );
+        retval.insert( MockLargeFooable() );
+        retval.insert( MockFooable() );
+        retval.insert( MockNonTrivialFooable() );
+        retval.insert( MockLargeFooable() );
+        retval.insert( MockFooable() );
+        return retval;
+    }
+}
+
+
+TEST( TestCollection, Empty )
+{
+    Collection collection;
+    EXPECT_TRUE( collection.empty() );
+    EXPECT_EQ( collection.size(), 0u );
+
+    CountingVisitor visitor = collection.for_each( CountingVisitor() );
+    EXPECT_EQ( visitor.erased, 0 );
+}
+
+TEST( TestCollection, Insert )
+{
+    Collection collection;
+    MockFooable& inserted = collection.insert( MockFooable() );
+    inserted.set_value( Mock::other_value );
+
+    EXPECT_FALSE( collection.empty() );
+    EXPECT_EQ( collection.size(), 1u );
+    ASSERT_EQ( collection.segment<MockFooable>().size(), 1u );
+    EXPECT_EQ( collection.segment<MockFooable>()[0].foo(), Mock::other_value );
+}
+
+TEST( TestCollection, Segments )
+{
+    Collection collection = make_collection();
+
+    EXPECT_EQ( collection.size(), 6u );
+    EXPECT_EQ( collection.segment<MockFooable>().size(), 3u );
+    EXPECT_EQ( collection.segment<MockLargeFooable>().size(), 2u );
+    EXPECT_EQ( collection.segment<MockNonTrivialFooable>().size(), 1u );
+    EXPECT_TRUE( collection.segment<Mock::MockAlignedFooable>().empty() );
+}
+
+TEST( TestCollection, ForEach )
+{
+    Collection collection = make_collection();
+
+    CountingVisitor visitor = collection.for_each( CountingVisitor() );
+    EXPECT_EQ( visitor.small, 0 );
+    EXPECT_EQ( visitor.large, 0 );
+    EXPECT_EQ( visitor.erased, 6 );
+    EXPECT_EQ( visitor.sum, 6 * Mock::value );
+
+    // Values are visited segment by segment, in the order in which their
+    // types were first inserted.
+    std::vector<int> order;
+    collection.segment<MockLargeFooable>()[0].set_value( 1 );
+    collection.segment<MockNonTrivialFooable>()[0].set_value( 2 );
+    collection.for_each( [&order]( FooableRef value ) { order.push_back(value.foo()); } );
+    std::vector<int> expected = {
+        Mock::value, Mock::value, Mock::value, 1, Mock::value, 2
+    };
+    EXPECT_EQ( order, expected );
+}
+
+TEST( TestCollection, ForEachKnownTypes )
+{
+    Collection collection = make_collection();
+
+    CountingVisitor visitor =
+        collection.for_each<MockFooable, MockLargeFooable>( CountingVisitor() );
+    EXPECT_EQ( visitor.small, 3 );
+    EXPECT_EQ( visitor.large, 2 );
+    EXPECT_EQ( visitor.erased, 1 );
+    EXPECT_EQ( visitor.sum, 6 * Mock::value );
+}
+
+TEST( TestCollection, ForEachModifies )
+{
+    Collection collection = make_collection();
+
+    collection.for_each( []( FooableRef value ) { value.set_value( Mock::other_value ); } );
+    for (const MockFooable& value : collection.segment<MockFooable>()) {
+        EXPECT_EQ( value.foo(), Mock::other_value );
+    }
+    EXPECT_EQ( collection.segment<MockNonTrivialFooable>()[0].foo(), Mock::other_value );
+}
+
+TEST( TestCollection, EraseIf )
+{
+    Collection collection = make_collection();
+    collection.segment<MockFooable>()[1].set_value( Mock::other_value );
+    collection.segment<MockLargeFooable>()[0].set_value( Mock::other_value );
+
+    EXPECT_EQ( collection.erase_if( []( FooableRef value ) {
+                   return value.foo() == Mock::other_value;
+               } ), 2u );
+    EXPECT_EQ( collection.size(), 4u );
+    EXPECT_EQ( collection.segment<MockFooable>().size(), 2u );
+    EXPECT_EQ( collection.segment<MockLargeFooable>().size(), 1u );
+
+    collection.segment<MockFooable>().pop_back();
+    EXPECT_EQ( collection.size(), 3u );
+}
+
+TEST( TestCollection, Clear )
+{
+    {
+        Collection collection = make_collection();
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 1 );
+        collection.clear();
+        EXPECT_TRUE( collection.empty() );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+
+        collection.insert( MockNonTrivialFooable() );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
@@ -0,0 +1,41 @@
+#ifndef COUNTING_RESOURCE_HH
+#define COUNTING_RESOURCE_HH
+
+#include <cstddef>
+#include <cstdlib>
+
+// Include after a generated header that declares type_erasure::memory_resource.
+
+namespace Mock
+{
+    // Counts what is allocated from it.  The memory comes from malloc, so it
+    // does not show up in heap_allocations().
+    struct CountingResource : type_erasure::memory_resource
+    {
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+        std::size_t bytes_in_use = 0;
+
+    private:
+        void* do_allocate (std::size_t bytes, std::size_t) override
+        {
+            ++allocations;
+            bytes_in_use += bytes;
+            return std::malloc(bytes);
+        }
+
+        void do_deallocate (void* ptr, std::size_t bytes, std::size_t) override
+        {
+            ++deallocations;
+            bytes_in_use -= bytes;
+            std::free(ptr);
+        }
+
+        bool do_is_equal (const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
+#endif // COUNTING_RESOURCE_HH
@@ -14,6 +14,248 @@
 #define noexcept
 #endif
 
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
+
+#ifndef TYPE_ERASURE_PERSISTENT_VECTOR
+#define TYPE_ERASURE_PERSISTENT_VECTOR
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace type_erasure
+{
+    // A sequence that shares its storage with its copies, so copying it takes
+    // constant time no matter how many values it holds.  Values live in
+    // chunks of 32, which are the leaves of a tree with 32 children per
+    // node.  Changing a value first copies each chunk and node on the way to
+    // it that is still shared with another vector, so a change costs at most
+    // one chunk plus one node per level.  Nodes that are not shared are
+    // changed in place.  Copies may be used from different threads, but each
+    // one by one thread at a time.  That relies on std::shared_ptr releasing
+    // a reference with release semantics, as the common standard libraries
+    // do, so that a node found unshared is no longer being read elsewhere.
+    template <typename T>
+    class persistent_vector
+    {
+        struct Node;
+        using NodePtr = std::shared_ptr<Node>;
+
+    public:
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            const_iterator () = default;
+
+            const T& operator* () const
+            {
+                return chunk_[index_ & mask];
+            }
+
+            const T* operator-> () const
+            {
+                return &**this;
+            }
+
+            const_iterator& operator++ ()
+            {
+                if ((++index_ & mask) == 0 && index_ < vector_->size_)
+                    chunk_ = vector_->chunk_for(index_);
+                return *this;
+            }
+
+            const_iterator operator++ (int)
+            {
+                const_iterator retval = *this;
+                ++*this;
+                return retval;
+            }
+
+            friend bool operator== (const const_iterator& lhs, const const_iterator& rhs)
+            {
+                return lhs.index_ == rhs.index_;
+            }
+
+            friend bool operator!= (const const_iterator& lhs, const const_iterator& rhs)
+            {
+                return lhs.index_ != rhs.index_;
+            }
+
+        private:
+            const_iterator (const persistent_vector* vector, std::size_t index) :
+                vector_ (vector),
+                index_ (index)
+            {
+                if (index_ < vector_->size_)
+                    chunk_ = vector_->chunk_for(index_);
+            }
+
+            const persistent_vector* vector_ = nullptr;
+            const T* chunk_ = nullptr;
+            std::size_t index_ = 0;
+
+            friend class persistent_vector;
+        };
+
+        persistent_vector () = default;
+
+        std::size_t size () const noexcept
+        {
+            return size_;
+        }
+
+        bool empty () const noexcept
+        {
+            return size_ == 0;
+        }
+
+        const T& operator[] (std::size_t index) const
+        {
+            assert(index < size_);
+            return chunk_for(index)[index & mask];
+        }
+
+        const_iterator begin () const
+        {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end () const
+        {
+            return const_iterator(this, size_);
+        }
+
+        void push_back (T value)
+        {
+            if (!root_) {
+                root_ = std::make_shared<Node>();
+                root_->values.reserve(branching);
+            } else if (size_ == std::size_t(branching) << shift_) {
+                NodePtr root = std::make_shared<Node>();
+                root->children.reserve(branching);
+                root->children.push_back(std::move(root_));
+                root_ = std::move(root);
+                shift_ += bits;
+            }
+
+            Node* node = unshare(root_);
+            for (unsigned int shift = shift_; shift; shift -= bits) {
+                const std::size_t child = (size_ >> shift) & mask;
+                if (child == node->children.size()) {
+                    node->children.push_back(std::make_shared<Node>());
+                    if (shift == bits)
+                        node->children.back()->values.reserve(branching);
+                    else
+                        node->children.back()->children.reserve(branching);
+                }
+                node = unshare(node->children[child]);
+            }
+            node->values.push_back(std::move(value));
+            ++size_;
+        }
+
+        void set (std::size_t index, T value)
+        {
+            mutable_at(index) = std::move(value);
+        }
+
+        // Calls f(value) on the value at index, after unsharing it.
+        template <typename F>
+        void update (std::size_t index, F f)
+        {
+            f(mutable_at(index));
+        }
+
+        void clear () noexcept
+        {
+            root_.reset();
+            size_ = 0;
+            shift_ = 0;
+        }
+
+    private:
+        enum : unsigned int {
+            bits = 5,
+            branching = 1u << bits,
+            mask = branching - 1
+        };
+
+        // Inner nodes have children, leaves have values.
+        struct Node
+        {
+            std::vector<NodePtr> children;
+            std::vector<T> values;
+        };
+
+        // use_count() is a relaxed load.  Once it finds node unshared, the
+        // fence makes the reads other threads made through their copies,
+        // before dropping them, happen before the writes that follow.
+        static Node* unshare (NodePtr& node)
+        {
+            if (node.use_count() != 1)
+                node = std::make_shared<Node>(*node);
+            else
+                std::atomic_thread_fence(std::memory_order_acquire);
+            return node.get();
+        }
+
+        const T* chunk_for (std::size_t index) const
+        {
+            const Node* node = root_.get();
+            for (unsigned int shift = shift_; shift; shift -= bits) {
+                node = node->children[(index >> shift) & mask].get();
+            }
+            return node->values.data();
+        }
+
+        T& mutable_at (std::size_t index)
+        {
+            assert(index < size_);
+            Node* node = unshare(root_);
+            for (unsigned int shift = shift_; shift; shift -= bits) {
+                node = unshare(node->children[(index >> shift) & mask]);
+            }
+            return node->values[index & mask];
+        }
+
+        NodePtr root_;
+        std::size_t size_ = 0;
+        unsigned int shift_ = 0;
+    };
+}
+#endif
+
 
 namespace COW {
     
@@ -36,6 +278,16 @@ namespace COW {
             )
         {}
     
+        // Constructs a T from args in place.
+        template <typename T, typename... Args>
+        explicit Fooable (type_erasure::in_place_type_t<T>, Args&&... args) :
+            handle_ (
+                std::make_shared< Handle<T> >(
+                    type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+                )
+            )
+        {}
+    
         // Assignment
         template <typename T,
                   typename std::enable_if<
@@ -49,24 +301,34 @@ namespace COW {
             return *this;
         }
     
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.  Writing through the reference after the object is copied
+        // would change the copies too.
+        template <typename T, typename... Args>
+        T& emplace (Args&&... args)
+        {
+            handle_ = std::make_shared< Handle<T> >(
+                type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+            );
+            return value_of<T>();
+        }
+    
         template <typename T>
         T* cast()
         {
             assert(handle_);
-            Handle<T>* handle = dynamic_cast<Handle<T>*>( handle_.get() );
-            if(handle)
-                return &handle->value_;
-            return nullptr;
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<Handle<T>*>( handle_.get() )->value_;
         }
     
         template <typename T>
         const T* cast() const
         {
             assert(handle_);
-            const Handle<T>* handle = dynamic_cast<const Handle<T>*>( handle_.get() );
-            if(handle)
-                return &handle->value_;
-            return nullptr;
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<const Handle<T>*>( handle_.get() )->value_;
         }
     
         int foo ( ) const
@@ -81,9 +343,23 @@ namespace COW {
         }
     
     private:
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename T>
+        T& value_of ()
+        {
+            return static_cast<Handle<T>*>(handle_.get())->value_;
+        }
+    
         struct HandleBase
         {
             virtual ~HandleBase () {}
+            virtual const void* type_id () const noexcept = 0;
             virtual std::shared_ptr<HandleBase> clone () const = 0;
     
             virtual int foo ( ) const = 0;
@@ -110,11 +386,21 @@ namespace COW {
                 : value_( std::forward<U>(value) )
             {}
     
+            template <typename... Args>
+            explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+                : value_( std::forward<Args>(args)... )
+            {}
+    
             virtual std::shared_ptr<HandleBase> clone () const
             {
                 return std::make_shared<Handle>(value_);
             }
     
+            virtual const void* type_id () const noexcept
+            {
+                return Fooable::type_id<T>();
+            }
+    
             virtual int foo ( ) const {
                 return value_.foo( );
             }
@@ -147,6 +433,13 @@ namespace COW {
     
         std::shared_ptr<HandleBase> handle_;
     };
+    
+    // Constructs a T from args in place, in a new Fooable.
+    template <typename T, typename... Args>
+    Fooable make_fooable (Args&&... args)
+    {
+        return Fooable(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
 
 }
 #endif
@@ -185,3 +185,20 @@ TEST( TestCOWFooable, ConstCast )
     ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
     EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::value );
 }
+
+TEST( TestCOWFooable, InPlace )
+{
+    using Mock::MockValueFooable;
+    MockValueFooable::transfers() = 0;
+
+    Fooable fooable( type_erasure::in_place_type_t<MockValueFooable>(), Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    MockValueFooable& value = fooable.emplace<MockValueFooable>( Mock::value );
+    EXPECT_EQ( &value, fooable.cast<MockValueFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    Fooable made = COW::make_fooable<MockValueFooable>( Mock::other_value );
+    EXPECT_EQ( made.foo(), Mock::other_value );
+    EXPECT_EQ( MockValueFooable::transfers(), 0 );
+}
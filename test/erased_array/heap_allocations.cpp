@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "../ref/interface.hh"
+#include "../mock_fooable.hh"
+#include "../util.hh"
+
+namespace
+{
+    using Ref::FooableRef;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+
+    using ErasedArray = type_erasure::erased_array<FooableRef>;
+}
+
+TEST( TestErasedArray_HeapAllocations, PushBack )
+{
+    auto expected_heap_allocations = 0u;
+
+    ErasedArray array;
+    array.reserve_bytes( 1u << 16 );
+
+    // Large values live in the array, like small ones.
+    CHECK_HEAP_ALLOC( array.push_back( MockFooable() );
+                      array.push_back( MockLargeFooable() );
+                      array.push_back( MockFooable() ),
+                      expected_heap_allocations );
+}
+
+TEST( TestErasedArray_HeapAllocations, Iteration )
+{
+    auto expected_heap_allocations = 0u;
+
+    ErasedArray array;
+    array.push_back( MockFooable() );
+    array.push_back( MockLargeFooable() );
+
+    int sum = 0;
+    CHECK_HEAP_ALLOC( for (FooableRef fooable : array) sum += fooable.foo(),
+                      expected_heap_allocations );
+    EXPECT_EQ( sum, 2 * Mock::value );
+}
+
+TEST( TestErasedArray_HeapAllocations, Copy )
+{
+    auto expected_heap_allocations = 1u;
+
+    ErasedArray array;
+    array.push_back( MockFooable() );
+    array.push_back( MockLargeFooable() );
+
+    CHECK_HEAP_ALLOC( ErasedArray copy( array ),
+                      expected_heap_allocations );
+}
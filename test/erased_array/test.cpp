@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include "../ref/interface.hh"
+#include "../mock_fooable.hh"
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    using Ref::FooableRef;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::MockAlignedFooable;
+    using Mock::MockNonTrivialFooable;
+    using Mock::MockStringFooable;
+
+    using ErasedArray = type_erasure::erased_array<FooableRef>;
+
+    std::vector<int> values( ErasedArray& array )
+    {
+        std::vector<int> retval;
+        for (FooableRef fooable : array) {
+            retval.push_back( fooable.foo() );
+        }
+        return retval;
+    }
+
+    // Gives each element its own value.
+    void number( ErasedArray& array )
+    {
+        int i = 0;
+        for (FooableRef fooable : array) {
+            fooable.set_value( i++ );
+        }
+    }
+}
+
+
+TEST( TestErasedArray, Empty )
+{
+    ErasedArray array;
+    EXPECT_TRUE( array.empty() );
+    EXPECT_EQ( array.size(), 0u );
+    EXPECT_EQ( array.bytes(), 0u );
+    EXPECT_TRUE( array.begin() == array.end() );
+
+    ErasedArray copy( array );
+    EXPECT_TRUE( copy.empty() );
+
+    ErasedArray move( std::move(array) );
+    EXPECT_TRUE( move.empty() );
+}
+
+TEST( TestErasedArray, PushBack )
+{
+    ErasedArray array;
+    MockFooable& small = array.push_back( MockFooable() );
+    EXPECT_EQ( small.foo(), Mock::value );
+    array.push_back( MockLargeFooable() );
+    array.push_back( MockAlignedFooable() );
+    array.push_back( MockFooable() );
+
+    EXPECT_FALSE( array.empty() );
+    EXPECT_EQ( array.size(), 4u );
+
+    std::vector<int> expected( 4, Mock::value );
+    EXPECT_EQ( values(array), expected );
+
+    number( array );
+    expected = { 0, 1, 2, 3 };
+    EXPECT_EQ( values(array), expected );
+}
+
+TEST( TestErasedArray, PackedLayout )
+{
+    ErasedArray array;
+    for (int i = 0; i < 10; ++i) {
+        array.push_back( MockFooable() );
+    }
+
+    // A header of a table pointer and a 32-bit stride, then the int, with no
+    // fixed slot size.
+    const std::size_t small_bytes = sizeof(void*) + 4 + sizeof(int);
+    EXPECT_EQ( array.bytes(), 10 * small_bytes );
+
+    // The header is padded to the alignment of the value that follows it.
+    array.push_back( MockLargeFooable() );
+    EXPECT_EQ( array.bytes(), 10 * small_bytes +
+                              2 * sizeof(void*) + sizeof(MockLargeFooable) );
+}
+
+TEST( TestErasedArray, Alignment )
+{
+    ErasedArray array;
+    array.push_back( MockFooable() );
+    array.push_back( MockAlignedFooable() );
+    array.push_back( MockFooable() );
+    array.push_back( MockAlignedFooable() );
+
+    for (FooableRef fooable : array) {
+        if (const MockAlignedFooable* aligned = fooable.cast<const MockAlignedFooable>()) {
+            EXPECT_EQ( reinterpret_cast<std::uintptr_t>(aligned) % alignof(MockAlignedFooable), 0u );
+        }
+    }
+}
+
+TEST( TestErasedArray, Cast )
+{
+    ErasedArray array;
+    array.push_back( MockFooable() );
+    array.push_back( MockLargeFooable() );
+
+    ErasedArray::iterator it = array.begin();
+    EXPECT_FALSE( (*it).cast<MockFooable>() == nullptr );
+    EXPECT_TRUE( (*it).cast<MockLargeFooable>() == nullptr );
+    ++it;
+    EXPECT_FALSE( (*it).cast<MockLargeFooable>() == nullptr );
+    EXPECT_TRUE( ++it == array.end() );
+}
+
+TEST( TestErasedArray, Copy_TriviallyCopyable )
+{
+    ErasedArray array;
+    array.push_back( MockFooable() );
+    array.push_back( MockLargeFooable() );
+    number( array );
+
+    ErasedArray copy( array );
+    EXPECT_EQ( values(copy), values(array) );
+    EXPECT_EQ( copy.bytes(), array.bytes() );
+
+    (*copy.begin()).set_value( Mock::other_value );
+    EXPECT_EQ( (*array.begin()).foo(), 0 );
+    EXPECT_EQ( (*copy.begin()).foo(), Mock::other_value );
+
+    ErasedArray copy_assign;
+    copy_assign.push_back( MockFooable() );
+    copy_assign = array;
+    EXPECT_EQ( values(copy_assign), values(array) );
+}
+
+TEST( TestErasedArray, Copy_NonTrivial )
+{
+    {
+        ErasedArray array;
+        array.push_back( MockFooable() );
+        array.push_back( MockNonTrivialFooable() );
+        array.push_back( MockStringFooable() );
+        array.push_back( MockNonTrivialFooable() );
+        number( array );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 2 );
+
+        ErasedArray copy( array );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 4 );
+        EXPECT_EQ( values(copy), values(array) );
+
+        ErasedArray move( std::move(copy) );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 4 );
+        EXPECT_EQ( values(move), values(array) );
+        EXPECT_TRUE( copy.empty() );
+
+        array = move;
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 4 );
+
+        move.clear();
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 2 );
+        EXPECT_TRUE( move.empty() );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
+
+TEST( TestErasedArray, Growth )
+{
+    {
+        ErasedArray array;
+        for (int i = 0; i < 1000; ++i) {
+            if (i % 3)
+                array.push_back( MockFooable() );
+            else
+                array.push_back( MockNonTrivialFooable() );
+        }
+        number( array );
+
+        EXPECT_EQ( array.size(), 1000u );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 334 );
+
+        std::vector<int> expected;
+        for (int i = 0; i < 1000; ++i) {
+            expected.push_back( i );
+        }
+        EXPECT_EQ( values(array), expected );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
@@ -0,0 +1,311 @@
+#ifndef FORWARDING_CLOSED_SINK_HH
+#define FORWARDING_CLOSED_SINK_HH
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include "../mock_fooable.hh"
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#define alignof __alignof
+#endif
+
+#ifndef TYPE_ERASURE_CLOSED_SET
+#define TYPE_ERASURE_CLOSED_SET
+namespace type_erasure
+{
+    // The special member functions of a value whose type is one of Ts...,
+    // chosen by a runtime index counting from 1, with 0 meaning no value.
+    // Each one walks the list from the front; the compiler folds that into a
+    // chain of comparisons or a jump table.
+    template <typename... Ts>
+    struct closed_set;
+
+    template <>
+    struct closed_set<>
+    {
+        static constexpr std::size_t max_size ()
+        { return 1; }
+
+        static constexpr std::size_t max_alignment ()
+        { return 1; }
+
+        static constexpr bool nothrow_movable ()
+        { return true; }
+
+        template <typename U>
+        static constexpr std::size_t index_of ()
+        { return 0; }
+
+        static void copy (std::size_t, const void*, void*)
+        {}
+
+        static void move (std::size_t, void*, void*) noexcept
+        {}
+
+        static void destroy (std::size_t, void*) noexcept
+        {}
+    };
+
+    template <typename T, typename... Ts>
+    struct closed_set<T, Ts...>
+    {
+        using rest = closed_set<Ts...>;
+
+        static constexpr std::size_t max_size ()
+        { return rest::max_size() < sizeof(T) ? sizeof(T) : rest::max_size(); }
+
+        static constexpr std::size_t max_alignment ()
+        { return rest::max_alignment() < alignof(T) ? alignof(T) : rest::max_alignment(); }
+
+        static constexpr bool nothrow_movable ()
+        { return std::is_nothrow_move_constructible<T>::value && rest::nothrow_movable(); }
+
+        template <typename U>
+        static constexpr std::size_t index_of ()
+        {
+            return std::is_same<T, U>::value ?
+                1 :
+                rest::template index_of<U>() ? rest::template index_of<U>() + 1 : 0;
+        }
+
+        static void copy (std::size_t index, const void* from, void* to)
+        {
+            if (index == 1)
+                ::new (to) T(*static_cast<const T*>(from));
+            else
+                rest::copy(index - 1, from, to);
+        }
+
+        static void move (std::size_t index, void* from, void* to) noexcept(nothrow_movable())
+        {
+            if (index == 1)
+                ::new (to) T(std::move(*static_cast<T*>(from)));
+            else
+                rest::move(index - 1, from, to);
+        }
+
+        static void destroy (std::size_t index, void* value) noexcept
+        {
+            if (index == 1)
+                static_cast<T*>(value)->~T();
+            else
+                rest::destroy(index - 1, value);
+        }
+    };
+}
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
+
+
+namespace ForwardingClosed {
+    
+    class Sink
+    {
+    private:
+        // The types that can be stored, in the order of their index.
+        using Types = type_erasure::closed_set<Mock::MockSink>;
+    
+    public:
+        // Contructors
+        Sink () = default;
+    
+        template <typename T,
+                  typename std::enable_if<
+                      Types::template index_of<typename std::decay<T>::type>() != 0
+                      >::type* = nullptr>
+        Sink (T&& value) noexcept ( std::is_nothrow_constructible<typename std::decay<T>::type, T&&>::value )
+        {
+            ::new (static_cast<void*>(&storage_)) typename std::decay<T>::type(std::forward<T>(value));
+            index_ = Types::template index_of<typename std::decay<T>::type>();
+        }
+    
+        // Constructs a T from args in place.
+        template <typename T, typename... Args,
+                  typename std::enable_if<
+                      Types::template index_of<T>() != 0
+                      >::type* = nullptr>
+        explicit Sink (type_erasure::in_place_type_t<T>, Args&&... args)
+        {
+            ::new (static_cast<void*>(&storage_)) T(std::forward<Args>(args)...);
+            index_ = Types::template index_of<T>();
+        }
+    
+        Sink (const Sink& rhs)
+        {
+            if (rhs.index_) {
+                Types::copy(rhs.index_, &rhs.storage_, &storage_);
+                index_ = rhs.index_;
+            }
+        }
+    
+        Sink (Sink&& rhs) noexcept ( Types::nothrow_movable() )
+        {
+            move_from(rhs);
+        }
+    
+        // Assignment
+        template <typename T,
+                  typename std::enable_if<
+                      Types::template index_of<typename std::decay<T>::type>() != 0
+                      >::type* = nullptr>
+        Sink& operator= (T&& value)
+        {
+            Sink temp(std::forward<T>(value));
+            reset();
+            move_from(temp);
+            return *this;
+        }
+    
+        Sink& operator= (const Sink& rhs)
+        {
+            Sink temp(rhs);
+            reset();
+            move_from(temp);
+            return *this;
+        }
+    
+        Sink& operator= (Sink&& rhs) noexcept ( Types::nothrow_movable() )
+        {
+            if (this != &rhs) {
+                reset();
+                move_from(rhs);
+            }
+            return *this;
+        }
+    
+        ~Sink ()
+        {
+            reset();
+        }
+    
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.
+        template <typename T, typename... Args,
+                  typename std::enable_if<
+                      Types::template index_of<T>() != 0
+                      >::type* = nullptr>
+        T& emplace (Args&&... args)
+        {
+            reset();
+            ::new (static_cast<void*>(&storage_)) T(std::forward<Args>(args)...);
+            index_ = Types::template index_of<T>();
+            return value_of<T>();
+        }
+    
+        template <typename T>
+        T* cast()
+        {
+            assert(index_);
+            if (index_ != Types::template index_of<T>())
+                return nullptr;
+            return &value_of<T>();
+        }
+    
+        template <typename T>
+        const T* cast() const
+        {
+            assert(index_);
+            if (index_ != Types::template index_of<T>())
+                return nullptr;
+            return &value_of<T>();
+        }
+    
+        void take ( Mock :: CopyCounter value )
+        {
+                assert(index_);
+                switch (index_) {
+                default: return value_of< Mock::MockSink >().take(std::move(value) );
+                }
+        }
+        void take_rvalue ( Mock :: CopyCounter && value )
+        {
+                assert(index_);
+                switch (index_) {
+                default: return value_of< Mock::MockSink >().take_rvalue(std::move(value) );
+                }
+        }
+        void take_ref ( const Mock :: CopyCounter & value )
+        {
+                assert(index_);
+                switch (index_) {
+                default: return value_of< Mock::MockSink >().take_ref(value );
+                }
+        }
+    
+    private:
+        using Storage = typename std::aligned_storage<Types::max_size(), Types::max_alignment()>::type;
+    
+        template <typename T>
+        T& value_of ()
+        {
+            return *static_cast<T*>(static_cast<void*>(&storage_));
+        }
+    
+        template <typename T>
+        const T& value_of () const
+        {
+            return *static_cast<const T*>(static_cast<const void*>(&storage_));
+        }
+    
+        void move_from (Sink& rhs) noexcept ( Types::nothrow_movable() )
+        {
+            if (rhs.index_) {
+                Types::move(rhs.index_, &rhs.storage_, &storage_);
+                index_ = rhs.index_;
+                rhs.reset();
+            }
+        }
+    
+        void reset () noexcept
+        {
+            if (index_) {
+                Types::destroy(index_, &storage_);
+                index_ = 0;
+            }
+        }
+    
+        Storage storage_;
+        std::size_t index_ = 0;
+    };
+    
+    // Constructs a T from args in place, in a new Sink.
+    template <typename T, typename... Args>
+    Sink make_sink (Args&&... args)
+    {
+        return Sink(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
+
+}
+#endif
+
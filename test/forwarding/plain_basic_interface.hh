@@ -0,0 +1,16 @@
+#ifndef FORWARDING_BASIC_SINK_HH
+#define FORWARDING_BASIC_SINK_HH
+
+#include "../mock_fooable.hh"
+
+namespace ForwardingBasic
+{
+    class Sink
+    {
+    public:
+        void take(Mock::CopyCounter value);
+        void take_rvalue(Mock::CopyCounter&& value);
+        void take_ref(const Mock::CopyCounter& value);
+    };
+}
+#endif
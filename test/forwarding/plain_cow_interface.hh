@@ -0,0 +1,16 @@
+#ifndef FORWARDING_COW_SINK_HH
+#define FORWARDING_COW_SINK_HH
+
+#include "../mock_fooable.hh"
+
+namespace ForwardingCOW
+{
+    class Sink
+    {
+    public:
+        void take(Mock::CopyCounter value);
+        void take_rvalue(Mock::CopyCounter&& value);
+        void take_ref(const Mock::CopyCounter& value);
+    };
+}
+#endif
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include "basic_interface.hh"
+#include "cow_interface.hh"
+#include "vtable_interface.hh"
+#include "closed_interface.hh"
+#include "../mock_fooable.hh"
+
+namespace
+{
+    using Mock::CopyCounter;
+    using Mock::MockSink;
+
+    // Arguments must reach the stored value with no more copies than a
+    // direct call would make.
+    template <typename Sink>
+    void test_copies ()
+    {
+        Sink sink = MockSink();
+        CopyCounter counter;
+        CopyCounter::copies() = 0;
+
+        sink.take( counter );
+        EXPECT_EQ( CopyCounter::copies(), 1 );
+
+        sink.take( CopyCounter() );
+        EXPECT_EQ( CopyCounter::copies(), 1 );
+
+        sink.take( std::move(counter) );
+        EXPECT_EQ( CopyCounter::copies(), 1 );
+
+        sink.take_rvalue( CopyCounter() );
+        EXPECT_EQ( CopyCounter::copies(), 1 );
+
+        // MockSink keeps a copy of a const& argument, but no other copy is
+        // made.
+        sink.take_ref( counter );
+        EXPECT_EQ( CopyCounter::copies(), 2 );
+    }
+}
+
+TEST( TestForwarding, Basic )
+{
+    test_copies<ForwardingBasic::Sink>();
+}
+
+TEST( TestForwarding, COW )
+{
+    test_copies<ForwardingCOW::Sink>();
+}
+
+TEST( TestForwarding, StaticVTable )
+{
+    test_copies<ForwardingVTable::Sink>();
+}
+
+TEST( TestForwarding, Closed )
+{
+    test_copies<ForwardingClosed::Sink>();
+}
+
+TEST( TestForwarding, Delegate )
+{
+    ForwardingVTable::Sink sink = MockSink();
+    auto take = sink.bind_take();
+    CopyCounter counter;
+    CopyCounter::copies() = 0;
+
+    take( counter );
+    EXPECT_EQ( CopyCounter::copies(), 1 );
+
+    take( CopyCounter() );
+    EXPECT_EQ( CopyCounter::copies(), 1 );
+}
@@ -0,0 +1,1104 @@
+#ifndef INLINE_VTABLE_FOOABLE_HH
+#define INLINE_VTABLE_FOOABLE_HH
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#define alignof __alignof
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT alignof(void*)
+#endif
+
+#ifndef TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+#define TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+namespace type_erasure
+{
+    // Values of types for which this is true are moved by copying their bytes,
+    // without calling the move constructor or the destructor.  True for
+    // trivially copyable types; specialize it for other types that allow this.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T>
+    {};
+}
+#endif
+
+#ifndef TYPE_ERASURE_DELEGATE
+#define TYPE_ERASURE_DELEGATE
+namespace type_erasure
+{
+    // A member function of an erased object bound to that object, as
+    // returned by the generated bind_*() members: a pointer to the object's
+    // storage, and the function pointer its table holds for the stored type.
+    // Calling it makes no lookup.  It is trivially copyable, and two pointers
+    // in size.
+    //
+    // It is invalidated when the erased object is destroyed or moved from, or
+    // given a new value by assignment or emplace(), even one of the same type.
+    // When TYPE_ERASURE_CHECK_DELEGATES is defined, delegates and erased
+    // objects grow by a count of these changes, and calls assert that none
+    // has happened since the delegate was bound while the erased object
+    // lives.  Define it in every translation unit or in none, since it
+    // changes the layout of both.  Calling a delegate after the erased object
+    // is destroyed cannot be checked.
+    template <typename Signature>
+    class delegate;
+
+    template <typename R, typename Object, typename... Args>
+    class delegate<R (Object*, Args...)>
+    {
+    public:
+        using function_type = R (*) (Object*, Args...);
+
+        delegate () = default;
+
+        delegate (Object* object, function_type function,
+                  const void* owner, std::size_t (*generation_of) (const void*)) noexcept :
+            object_ (object),
+            function_ (function)
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            ,
+            owner_ (owner),
+            generation_ (generation_of(owner)),
+            generation_of_ (generation_of)
+#endif
+        {
+            (void)owner;
+            (void)generation_of;
+        }
+
+        R operator() (Args... args) const
+        {
+            assert(function_);
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            assert(generation_of_(owner_) == generation_ &&
+                   "delegate used after its object was given a new value or moved from");
+#endif
+            return function_(object_, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool () const noexcept
+        {
+            return function_ != nullptr;
+        }
+
+    private:
+        Object* object_ = nullptr;
+        function_type function_ = nullptr;
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+        const void* owner_ = nullptr;
+        std::size_t generation_ = 0;
+        std::size_t (*generation_of_) (const void*) = nullptr;
+#endif
+    };
+}
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
+
+
+namespace InlineVTable {
+    
+    class Fooable
+    {
+    public:
+        // Contructors
+        Fooable () = default;
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                             std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            construct<typename std::decay<T>::type>(std::forward<T>(value));
+        }
+    
+        // Constructs a T from args in place.
+        template <typename T, typename... Args>
+        explicit Fooable (type_erasure::in_place_type_t<T>, Args&&... args)
+        {
+            construct<T>(std::forward<Args>(args)...);
+        }
+    
+        Fooable (const Fooable& rhs) :
+            vtable_ (rhs.vtable_)
+        {
+            if (vtable_)
+                vtable_.table->copy(rhs.object(), object());
+        }
+    
+        Fooable (Fooable&& rhs) noexcept :
+            vtable_ (rhs.vtable_),
+            storage_ (rhs.storage_)
+        {
+            rhs.vtable_.set(nullptr);
+            rhs.invalidate_delegates();
+        }
+    
+        // Assignment
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                        std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            Fooable temp(std::forward<T>(value));
+            swap(temp);
+            return *this;
+        }
+    
+        Fooable& operator= (const Fooable& rhs)
+        {
+            Fooable temp(rhs);
+            swap(temp);
+            return *this;
+        }
+    
+        Fooable& operator= (Fooable&& rhs) noexcept
+        {
+            Fooable temp(std::move(rhs));
+            swap(temp);
+            return *this;
+        }
+    
+        ~Fooable ()
+        {
+            reset();
+        }
+    
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.
+        template <typename T, typename... Args>
+        T& emplace (Args&&... args)
+        {
+            reset();
+            construct<T>(std::forward<Args>(args)...);
+            return Thunks<T, !stored_inline<T>()>::stored(object());
+        }
+    
+        template <typename T>
+        T* cast()
+        {
+            assert(vtable_);
+            if (vtable_.table->type_id != &type_id<T>)
+                return nullptr;
+            return &Thunks<T, !stored_inline<T>()>::stored(object());
+        }
+    
+        template <typename T>
+        const T* cast() const
+        {
+            assert(vtable_);
+            if (vtable_.table->type_id != &type_id<T>)
+                return nullptr;
+            return &Thunks<T, !stored_inline<T>()>::stored(object());
+        }
+    
+        // Calls f(value) on the stored value if its type is one of those given to
+        // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+        // looked up once, so the calls f makes on value can be inlined.
+        template <typename F>
+        auto visit (F&& f) -> decltype(f(std::declval<Fooable&>()))
+        {
+            assert(vtable_);
+            return visit_impl(f, *this, vtable_.table->type_id(), VisitTypes<>());
+        }
+    
+        template <typename F>
+        auto visit (F&& f) const -> decltype(f(std::declval<const Fooable&>()))
+        {
+            assert(vtable_);
+            return visit_impl(f, *this, vtable_.table->type_id(), VisitTypes<>());
+        }
+    
+        // The storage slot, and what fits in it.  Values are kept in the slot only
+        // if they are trivially relocatable, so that moving is a plain memberwise
+        // copy; everything else lives on the heap, with the slot holding the
+        // pointer.
+        static constexpr std::size_t buffer_size ()
+        {
+            return sizeof(Storage);
+        }
+    
+        static constexpr std::size_t buffer_alignment ()
+        {
+            return alignof(Storage);
+        }
+    
+        static constexpr std::size_t inline_capacity ()
+        {
+            return sizeof(Storage);
+        }
+    
+        template <typename T>
+        static constexpr bool stored_inline ()
+        {
+            return sizeof(T) <= sizeof(Storage) &&
+                   alignof(T) <= alignof(Storage) &&
+                   type_erasure::is_trivially_relocatable<T>::value;
+        }
+    
+        int foo ( ) const
+        {
+                assert(vtable_);
+                return vtable().foo(object() );
+        }
+        void set_value ( int value )
+        {
+                assert(vtable_);
+                vtable().set_value(object(), value );
+        }
+    
+        type_erasure::delegate<int (const void* object_)> bind_foo () const
+        {
+                assert(vtable_);
+                return type_erasure::delegate<int (const void* object_)>(object(), vtable().foo, this, &bound_generation);
+        }
+        type_erasure::delegate<void (void* object_, int value)> bind_set_value ()
+        {
+                assert(vtable_);
+                return type_erasure::delegate<void (void* object_, int value)>(object(), vtable().set_value, this, &bound_generation);
+        }
+    
+    private:
+        using Storage = typename std::aligned_storage<SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE, SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT>::type;
+    
+        // The entries used by the forwarding functions.  Every entry takes a
+        // pointer to storage_ as its object parameter.
+        struct Members
+        {
+            int (*foo) (const void* object_);
+            void (*set_value) (void* object_, int value);
+        };
+    
+        // One table per stored type and storage location, built at compile time.
+        struct VTable
+        {
+            // cast() compares this with &type_id<T>, so it makes no indirect call.
+            const void* (*type_id) ();
+            void (*copy) (const void* from, void* to);
+            void (*destroy) (void* object_);
+            Members members;
+        };
+    
+        // Points to the shared table, and for small interfaces also keeps a copy
+        // of its Members, so that a call is a single indirect call with no table
+        // load.
+        template <bool Inline, typename Dummy = void>
+        struct Dispatch
+        {
+            void set (const VTable* vtable)
+            {
+                table = vtable;
+                if (table)
+                    members = table->members;
+            }
+    
+            const Members& get () const
+            {
+                return members;
+            }
+    
+            explicit operator bool () const
+            {
+                return table != nullptr;
+            }
+    
+            const VTable* table = nullptr;
+            Members members;
+        };
+    
+        template <typename Dummy>
+        struct Dispatch<false, Dummy>
+        {
+            void set (const VTable* vtable)
+            {
+                table = vtable;
+            }
+    
+            const Members& get () const
+            {
+                return table->members;
+            }
+    
+            explicit operator bool () const
+            {
+                return table != nullptr;
+            }
+    
+            const VTable* table = nullptr;
+        };
+    
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename... Ts>
+        struct VisitTypes
+        {};
+    
+        template <typename F, typename Self>
+        static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+        {
+            return f(self);
+        }
+    
+        template <typename F, typename Self, typename T, typename... Ts>
+        static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+        {
+            if (id == type_id<T>())
+                return f(self.template value_of<T>());
+            return visit_impl(f, self, id, VisitTypes<Ts...>());
+        }
+    
+        template <typename T>
+        struct Unwrap
+        {
+            using type = T;
+    
+            static T& get (T& value)
+            {
+                return value;
+            }
+    
+            static const T& get (const T& value)
+            {
+                return value;
+            }
+        };
+    
+        template <typename T>
+        struct Unwrap<std::reference_wrapper<T>>
+        {
+            using type = T;
+    
+            static T& get (std::reference_wrapper<T> ref)
+            {
+                return ref.get();
+            }
+        };
+    
+        template <typename T, bool HeapAllocated>
+        struct Thunks
+        {
+            template <typename... Args>
+            static void construct (void* object_, Args&&... args)
+            {
+                if (HeapAllocated)
+                    *static_cast<T**>(object_) = new T(std::forward<Args>(args)...);
+                else
+                    new (object_) T(std::forward<Args>(args)...);
+            }
+    
+            static T& stored (void* object_)
+            {
+                return HeapAllocated ?
+                    **static_cast<T**>(object_) :
+                    *static_cast<T*>(object_);
+            }
+    
+            static const T& stored (const void* object_)
+            {
+                return HeapAllocated ?
+                    **static_cast<T* const*>(object_) :
+                    *static_cast<const T*>(object_);
+            }
+    
+            static typename Unwrap<T>::type& value_of (void* object_)
+            {
+                return Unwrap<T>::get(stored(object_));
+            }
+    
+            static const typename Unwrap<T>::type& value_of (const void* object_)
+            {
+                return Unwrap<T>::get(stored(object_));
+            }
+    
+            // For rvalue-qualified functions, which may consume the value.
+            static typename Unwrap<T>::type&& rvalue_of (void* object_)
+            {
+                return std::move(value_of(object_));
+            }
+    
+            static const typename Unwrap<T>::type&& rvalue_of (const void* object_)
+            {
+                return std::move(value_of(object_));
+            }
+    
+            static void copy (const void* from, void* to)
+            {
+                construct(to, stored(from));
+            }
+    
+            static void destroy (void* object_)
+            {
+                if (HeapAllocated)
+                    delete &stored(object_);
+                else
+                    stored(object_).~T();
+            }
+    
+            static int foo (const void* object_)
+            {
+                return value_of(object_).foo( );
+            }
+            static void set_value (void* object_, int value)
+            {
+                value_of(object_).set_value(value );
+            }
+    
+            static const VTable* table ()
+            {
+                static constexpr VTable table = {
+                    &type_id<T>,
+                    &copy,
+                    &destroy,
+                    {
+                        &foo,
+                        &set_value,
+                    }
+                };
+                return &table;
+            }
+        };
+    
+        // Expects this to be empty.
+        template <typename T, typename... Args>
+        void construct (Args&&... args)
+        {
+            using StoredThunks = Thunks<T, !stored_inline<T>()>;
+    
+            StoredThunks::construct(object(), std::forward<Args>(args)...);
+            vtable_.set(StoredThunks::table());
+        }
+    
+        void swap (Fooable& rhs) noexcept
+        {
+            std::swap(vtable_, rhs.vtable_);
+            std::swap(storage_, rhs.storage_);
+            invalidate_delegates();
+            rhs.invalidate_delegates();
+        }
+    
+        void reset ()
+        {
+            if (vtable_)
+                vtable_.table->destroy(object());
+            vtable_.set(nullptr);
+            invalidate_delegates();
+        }
+    
+        const Members& vtable () const
+        {
+            return vtable_.get();
+        }
+    
+        // With TYPE_ERASURE_CHECK_DELEGATES defined, counts the times this object
+        // has been given a new value or moved from, and the delegates returned by
+        // the bind_*() members check that the count has not changed since they
+        // were bound.
+        static std::size_t bound_generation (const void* owner)
+        {
+    #ifdef TYPE_ERASURE_CHECK_DELEGATES
+            return static_cast<const Fooable*>(owner)->generation_;
+    #else
+            (void)owner;
+            return 0;
+    #endif
+        }
+    
+        void invalidate_delegates () noexcept
+        {
+    #ifdef TYPE_ERASURE_CHECK_DELEGATES
+            ++generation_;
+    #endif
+        }
+    
+        // Each stored type has its own table, so comparing the table pointer
+        // identifies it without an indirect call.
+        template <typename T>
+        bool holds () const
+        {
+            return vtable_.table == Thunks<T, !stored_inline<T>()>::table();
+        }
+    
+        template <typename T>
+        typename Unwrap<T>::type& value_of ()
+        {
+            return Thunks<T, !stored_inline<T>()>::value_of(object());
+        }
+    
+        template <typename T>
+        const typename Unwrap<T>::type& value_of () const
+        {
+            return Thunks<T, !stored_inline<T>()>::value_of(object());
+        }
+    
+        void* object ()
+        {
+            return &storage_;
+        }
+    
+        const void* object () const
+        {
+            return &storage_;
+        }
+    
+        Dispatch<true> vtable_;
+        Storage storage_;
+    #ifdef TYPE_ERASURE_CHECK_DELEGATES
+        std::size_t generation_ = 0;
+    #endif
+    };
+    
+    // Constructs a T from args in place, in a new Fooable.
+    template <typename T, typename... Args>
+    Fooable make_fooable (Args&&... args)
+    {
+        return Fooable(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
+
+    
+    class WideFooable
+    {
+    public:
+        // Contructors
+        WideFooable () = default;
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< WideFooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        WideFooable (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                             std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            construct<typename std::decay<T>::type>(std::forward<T>(value));
+        }
+    
+        // Constructs a T from args in place.
+        template <typename T, typename... Args>
+        explicit WideFooable (type_erasure::in_place_type_t<T>, Args&&... args)
+        {
+            construct<T>(std::forward<Args>(args)...);
+        }
+    
+        WideFooable (const WideFooable& rhs) :
+            vtable_ (rhs.vtable_)
+        {
+            if (vtable_)
+                vtable_.table->copy(rhs.object(), object());
+        }
+    
+        WideFooable (WideFooable&& rhs) noexcept :
+            vtable_ (rhs.vtable_),
+            storage_ (rhs.storage_)
+        {
+            rhs.vtable_.set(nullptr);
+            rhs.invalidate_delegates();
+        }
+    
+        // Assignment
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< WideFooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        WideFooable& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                        std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            WideFooable temp(std::forward<T>(value));
+            swap(temp);
+            return *this;
+        }
+    
+        WideFooable& operator= (const WideFooable& rhs)
+        {
+            WideFooable temp(rhs);
+            swap(temp);
+            return *this;
+        }
+    
+        WideFooable& operator= (WideFooable&& rhs) noexcept
+        {
+            WideFooable temp(std::move(rhs));
+            swap(temp);
+            return *this;
+        }
+    
+        ~WideFooable ()
+        {
+            reset();
+        }
+    
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.
+        template <typename T, typename... Args>
+        T& emplace (Args&&... args)
+        {
+            reset();
+            construct<T>(std::forward<Args>(args)...);
+            return Thunks<T, !stored_inline<T>()>::stored(object());
+        }
+    
+        template <typename T>
+        T* cast()
+        {
+            assert(vtable_);
+            if (vtable_.table->type_id != &type_id<T>)
+                return nullptr;
+            return &Thunks<T, !stored_inline<T>()>::stored(object());
+        }
+    
+        template <typename T>
+        const T* cast() const
+        {
+            assert(vtable_);
+            if (vtable_.table->type_id != &type_id<T>)
+                return nullptr;
+            return &Thunks<T, !stored_inline<T>()>::stored(object());
+        }
+    
+        // Calls f(value) on the stored value if its type is one of those given to
+        // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+        // looked up once, so the calls f makes on value can be inlined.
+        template <typename F>
+        auto visit (F&& f) -> decltype(f(std::declval<WideFooable&>()))
+        {
+            assert(vtable_);
+            return visit_impl(f, *this, vtable_.table->type_id(), VisitTypes<>());
+        }
+    
+        template <typename F>
+        auto visit (F&& f) const -> decltype(f(std::declval<const WideFooable&>()))
+        {
+            assert(vtable_);
+            return visit_impl(f, *this, vtable_.table->type_id(), VisitTypes<>());
+        }
+    
+        // The storage slot, and what fits in it.  Values are kept in the slot only
+        // if they are trivially relocatable, so that moving is a plain memberwise
+        // copy; everything else lives on the heap, with the slot holding the
+        // pointer.
+        static constexpr std::size_t buffer_size ()
+        {
+            return sizeof(Storage);
+        }
+    
+        static constexpr std::size_t buffer_alignment ()
+        {
+            return alignof(Storage);
+        }
+    
+        static constexpr std::size_t inline_capacity ()
+        {
+            return sizeof(Storage);
+        }
+    
+        template <typename T>
+        static constexpr bool stored_inline ()
+        {
+            return sizeof(T) <= sizeof(Storage) &&
+                   alignof(T) <= alignof(Storage) &&
+                   type_erasure::is_trivially_relocatable<T>::value;
+        }
+    
+        int foo ( ) const
+        {
+                assert(vtable_);
+                return vtable().foo(object() );
+        }
+        int foo ( )
+        {
+                assert(vtable_);
+                return vtable().foo_1(object() );
+        }
+        void set_value ( int value )
+        {
+                assert(vtable_);
+                vtable().set_value(object(), value );
+        }
+        void set_value ( long value )
+        {
+                assert(vtable_);
+                vtable().set_value_1(object(), value );
+        }
+    
+        type_erasure::delegate<int (const void* object_)> bind_foo () const
+        {
+                assert(vtable_);
+                return type_erasure::delegate<int (const void* object_)>(object(), vtable().foo, this, &bound_generation);
+        }
+        type_erasure::delegate<int (void* object_)> bind_foo_1 ()
+        {
+                assert(vtable_);
+                return type_erasure::delegate<int (void* object_)>(object(), vtable().foo_1, this, &bound_generation);
+        }
+        type_erasure::delegate<void (void* object_, int value)> bind_set_value ()
+        {
+                assert(vtable_);
+                return type_erasure::delegate<void (void* object_, int value)>(object(), vtable().set_value, this, &bound_generation);
+        }
+        type_erasure::delegate<void (void* object_, long value)> bind_set_value_1 ()
+        {
+                assert(vtable_);
+                return type_erasure::delegate<void (void* object_, long value)>(object(), vtable().set_value_1, this, &bound_generation);
+        }
+    
+    private:
+        using Storage = typename std::aligned_storage<SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE, SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT>::type;
+    
+        // The entries used by the forwarding functions.  Every entry takes a
+        // pointer to storage_ as its object parameter.
+        struct Members
+        {
+            int (*foo) (const void* object_);
+            int (*foo_1) (void* object_);
+            void (*set_value) (void* object_, int value);
+            void (*set_value_1) (void* object_, long value);
+        };
+    
+        // One table per stored type and storage location, built at compile time.
+        struct VTable
+        {
+            // cast() compares this with &type_id<T>, so it makes no indirect call.
+            const void* (*type_id) ();
+            void (*copy) (const void* from, void* to);
+            void (*destroy) (void* object_);
+            Members members;
+        };
+    
+        // Points to the shared table, and for small interfaces also keeps a copy
+        // of its Members, so that a call is a single indirect call with no table
+        // load.
+        template <bool Inline, typename Dummy = void>
+        struct Dispatch
+        {
+            void set (const VTable* vtable)
+            {
+                table = vtable;
+                if (table)
+                    members = table->members;
+            }
+    
+            const Members& get () const
+            {
+                return members;
+            }
+    
+            explicit operator bool () const
+            {
+                return table != nullptr;
+            }
+    
+            const VTable* table = nullptr;
+            Members members;
+        };
+    
+        template <typename Dummy>
+        struct Dispatch<false, Dummy>
+        {
+            void set (const VTable* vtable)
+            {
+                table = vtable;
+            }
+    
+            const Members& get () const
+            {
+                return table->members;
+            }
+    
+            explicit operator bool () const
+            {
+                return table != nullptr;
+            }
+    
+            const VTable* table = nullptr;
+        };
+    
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename... Ts>
+        struct VisitTypes
+        {};
+    
+        template <typename F, typename Self>
+        static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+        {
+            return f(self);
+        }
+    
+        template <typename F, typename Self, typename T, typename... Ts>
+        static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+        {
+            if (id == type_id<T>())
+                return f(self.template value_of<T>());
+            return visit_impl(f, self, id, VisitTypes<Ts...>());
+        }
+    
+        template <typename T>
+        struct Unwrap
+        {
+            using type = T;
+    
+            static T& get (T& value)
+            {
+                return value;
+            }
+    
+            static const T& get (const T& value)
+            {
+                return value;
+            }
+        };
+    
+        template <typename T>
+        struct Unwrap<std::reference_wrapper<T>>
+        {
+            using type = T;
+    
+            static T& get (std::reference_wrapper<T> ref)
+            {
+                return ref.get();
+            }
+        };
+    
+        template <typename T, bool HeapAllocated>
+        struct Thunks
+        {
+            template <typename... Args>
+            static void construct (void* object_, Args&&... args)
+            {
+                if (HeapAllocated)
+                    *static_cast<T**>(object_) = new T(std::forward<Args>(args)...);
+                else
+                    new (object_) T(std::forward<Args>(args)...);
+            }
+    
+            static T& stored (void* object_)
+            {
+                return HeapAllocated ?
+                    **static_cast<T**>(object_) :
+                    *static_cast<T*>(object_);
+            }
+    
+            static const T& stored (const void* object_)
+            {
+                return HeapAllocated ?
+                    **static_cast<T* const*>(object_) :
+                    *static_cast<const T*>(object_);
+            }
+    
+            static typename Unwrap<T>::type& value_of (void* object_)
+            {
+                return Unwrap<T>::get(stored(object_));
+            }
+    
+            static const typename Unwrap<T>::type& value_of (const void* object_)
+            {
+                return Unwrap<T>::get(stored(object_));
+            }
+    
+            // For rvalue-qualified functions, which may consume the value.
+            static typename Unwrap<T>::type&& rvalue_of (void* object_)
+            {
+                return std::move(value_of(object_));
+            }
+    
+            static const typename Unwrap<T>::type&& rvalue_of (const void* object_)
+            {
+                return std::move(value_of(object_));
+            }
+    
+            static void copy (const void* from, void* to)
+            {
+                construct(to, stored(from));
+            }
+    
+            static void destroy (void* object_)
+            {
+                if (HeapAllocated)
+                    delete &stored(object_);
+                else
+                    stored(object_).~T();
+            }
+    
+            static int foo (const void* object_)
+            {
+                return value_of(object_).foo( );
+            }
+            static int foo_1 (void* object_)
+            {
+                return value_of(object_).foo( );
+            }
+            static void set_value (void* object_, int value)
+            {
+                value_of(object_).set_value(value );
+            }
+            static void set_value_1 (void* object_, long value)
+            {
+                value_of(object_).set_value(value );
+            }
+    
+            static const VTable* table ()
+            {
+                static constexpr VTable table = {
+                    &type_id<T>,
+                    &copy,
+                    &destroy,
+                    {
+                        &foo,
+                        &foo_1,
+                        &set_value,
+                        &set_value_1,
+                    }
+                };
+                return &table;
+            }
+        };
+    
+        // Expects this to be empty.
+        template <typename T, typename... Args>
+        void construct (Args&&... args)
+        {
+            using StoredThunks = Thunks<T, !stored_inline<T>()>;
+    
+            StoredThunks::construct(object(), std::forward<Args>(args)...);
+            vtable_.set(StoredThunks::table());
+        }
+    
+        void swap (WideFooable& rhs) noexcept
+        {
+            std::swap(vtable_, rhs.vtable_);
+            std::swap(storage_, rhs.storage_);
+            invalidate_delegates();
+            rhs.invalidate_delegates();
+        }
+    
+        void reset ()
+        {
+            if (vtable_)
+                vtable_.table->destroy(object());
+            vtable_.set(nullptr);
+            invalidate_delegates();
+        }
+    
+        const Members& vtable () const
+        {
+            return vtable_.get();
+        }
+    
+        // With TYPE_ERASURE_CHECK_DELEGATES defined, counts the times this object
+        // has been given a new value or moved from, and the delegates returned by
+        // the bind_*() members check that the count has not changed since they
+        // were bound.
+        static std::size_t bound_generation (const void* owner)
+        {
+    #ifdef TYPE_ERASURE_CHECK_DELEGATES
+            return static_cast<const WideFooable*>(owner)->generation_;
+    #else
+            (void)owner;
+            return 0;
+    #endif
+        }
+    
+        void invalidate_delegates () noexcept
+        {
+    #ifdef TYPE_ERASURE_CHECK_DELEGATES
+            ++generation_;
+    #endif
+        }
+    
+        // Each stored type has its own table, so comparing the table pointer
+        // identifies it without an indirect call.
+        template <typename T>
+        bool holds () const
+        {
+            return vtable_.table == Thunks<T, !stored_inline<T>()>::table();
+        }
+    
+        template <typename T>
+        typename Unwrap<T>::type& value_of ()
+        {
+            return Thunks<T, !stored_inline<T>()>::value_of(object());
+        }
+    
+        template <typename T>
+        const typename Unwrap<T>::type& value_of () const
+        {
+            return Thunks<T, !stored_inline<T>()>::value_of(object());
+        }
+    
+        void* object ()
+        {
+            return &storage_;
+        }
+    
+        const void* object () const
+        {
+            return &storage_;
+        }
+    
+        Dispatch<false> vtable_;
+        Storage storage_;
+    #ifdef TYPE_ERASURE_CHECK_DELEGATES
+        std::size_t generation_ = 0;
+    #endif
+    };
+    
+    // Constructs a T from args in place, in a new WideFooable.
+    template <typename T, typename... Args>
+    WideFooable make_wide_fooable (Args&&... args)
+    {
+        return WideFooable(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
+
+}
+#endif
+
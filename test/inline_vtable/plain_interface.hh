@@ -0,0 +1,22 @@
+#ifndef INLINE_VTABLE_FOOABLE_HH
+#define INLINE_VTABLE_FOOABLE_HH
+
+namespace InlineVTable
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+
+    class WideFooable
+    {
+    public:
+        int foo() const;
+        int foo();
+        void set_value(int value);
+        void set_value(long value);
+    };
+}
+#endif
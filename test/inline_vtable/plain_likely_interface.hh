@@ -0,0 +1,15 @@
+#ifndef INLINE_VTABLE_LIKELY_FOOABLE_HH
+#define INLINE_VTABLE_LIKELY_FOOABLE_HH
+
+#include "../mock_fooable.hh"
+
+namespace InlineVTableLikely
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
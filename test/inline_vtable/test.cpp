@@ -0,0 +1,459 @@
+#include <gtest/gtest.h>
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "interface.hh"
+#include "likely_interface.hh"
+#include "../mock_fooable.hh"
+
+namespace
+{
+    using InlineVTable::Fooable;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::MockRelocatableFooable;
+
+    void death_tests( Fooable& fooable )
+    {
+#ifndef NDEBUG
+        EXPECT_DEATH( fooable.foo(), "" );
+        EXPECT_DEATH( fooable.set_value( Mock::other_value ), "" );
+#endif
+    }
+
+    void test_interface( Fooable& fooable, int initial_value, int new_value )
+    {
+        EXPECT_EQ( fooable.foo(), initial_value );
+        fooable.set_value( new_value );
+        EXPECT_EQ( fooable.foo(), new_value );
+    }
+
+    void test_ref_interface( Fooable& fooable, const MockFooable& mock_fooable,
+                             int new_value )
+    {
+        test_interface(fooable, mock_fooable.foo(), new_value);
+        EXPECT_EQ( mock_fooable.foo(), new_value );
+    }
+
+    void test_copies( Fooable& copy, const Fooable& fooable, int new_value )
+    {
+        auto value = fooable.foo();
+        test_interface( copy, value, new_value );
+        EXPECT_EQ( fooable.foo(), value );
+        ASSERT_NE( value, new_value );
+        EXPECT_NE( fooable.foo(), copy.foo() );
+    }
+}
+
+
+TEST( TestInlineVTableFooable, Empty )
+{
+    Fooable fooable;
+    death_tests(fooable);
+
+    Fooable copy(fooable);
+    death_tests(copy);
+
+    Fooable move( std::move(fooable) );
+    death_tests(move);
+
+    Fooable copy_assign;
+    copy_assign = move;
+    death_tests(copy_assign);
+
+    Fooable move_assign;
+    move_assign = std::move(fooable);
+    death_tests(move_assign);
+}
+
+
+TEST( TestInlineVTableFooable, CopyFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+TEST( TestInlineVTableFooable, CopyFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, CopyConstruction_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    Fooable other( fooable );
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestInlineVTableFooable, CopyConstruction_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    Fooable other( fooable );
+    test_copies( other, fooable, Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, CopyFromValueWithReferenceWrapper_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable( std::ref(mock_fooable) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, CopyFromValueWithReferenceWrapper_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable( std::ref(mock_fooable) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, MoveFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+TEST( TestInlineVTableFooable, MoveFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, MoveConstruction_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestInlineVTableFooable, MoveConstruction_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+
+TEST( TestInlineVTableFooable, MoveFromValueWithReferenceWrapper_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable( std::move(std::ref(mock_fooable)) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestInlineVTableFooable, MoveFromValueWithReferenceWrapper_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable( std::move(std::ref(mock_fooable)) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, CopyAssignFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = mock_fooable;
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestInlineVTableFooable, CopyAssignFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = mock_fooable;
+    test_interface(fooable, value, Mock::other_value);
+}
+
+
+TEST( TestInlineVTableFooable, CopyAssignment_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    Fooable other;
+    other = fooable;
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestInlineVTableFooable, CopyAssignment_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    Fooable other;
+    other = fooable;
+    test_copies( other, fooable, Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, CopyAssignFromValueWithReferenceWrapper_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::ref(mock_fooable);
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestInlineVTableFooable, CopyAssignFromValueWithReferenceWrapper_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::ref(mock_fooable);
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, MoveAssignFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = std::move(mock_fooable);
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestInlineVTableFooable, MoveAssignFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = std::move(mock_fooable);
+    test_interface(fooable, value, Mock::other_value);
+}
+
+
+TEST( TestInlineVTableFooable, MoveAssignment_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other;
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestInlineVTableFooable, MoveAssignment_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    auto value = fooable.foo();
+    Fooable other;
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+
+TEST( TestInlineVTableFooable, MoveAssignFromValueWithReferenceWrapper_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::move(std::ref(mock_fooable));
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestInlineVTableFooable, MoveAssignFromValueWithReferenceWrapper_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::move(std::ref(mock_fooable));
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, Cast_SmallObject )
+{
+    Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+
+    fooable.set_value(Mock::other_value);
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::other_value );
+}
+
+TEST( TestInlineVTableFooable, Cast_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockLargeFooable>() == nullptr );
+
+    fooable.set_value(Mock::other_value);
+    EXPECT_EQ( fooable.cast<MockLargeFooable>()->foo(), Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, ConstCast_SmallObject )
+{
+    const Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::value );
+}
+
+TEST( TestInlineVTableFooable, ConstCast_LargeObject )
+{
+    const Fooable fooable = MockLargeFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockLargeFooable>() == nullptr );
+
+    EXPECT_EQ( fooable.cast<MockLargeFooable>()->foo(), Mock::value );
+}
+
+
+TEST( TestInlineVTableFooable, Size )
+{
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+    // Each object counts the values it has held, for the checks made by
+    // bound delegates.
+    const std::size_t generation = sizeof(std::size_t);
+#else
+    const std::size_t generation = 0;
+#endif
+
+    // One table pointer plus copies of the two entries.
+    EXPECT_EQ( sizeof(Fooable), 3 * sizeof(void*) + SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE + generation );
+
+    // Four functions exceed the limit, so only the table pointer is kept.
+    EXPECT_EQ( sizeof(InlineVTable::WideFooable),
+               sizeof(void*) + SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE + generation );
+}
+
+TEST( TestInlineVTableFooable, SharedTableFallback )
+{
+    using InlineVTable::WideFooable;
+
+    WideFooable fooable = MockFooable();
+    const WideFooable& const_fooable = fooable;
+    EXPECT_EQ( const_fooable.foo(), Mock::value );
+
+    fooable.set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    fooable.set_value( static_cast<long>(Mock::value) );
+    EXPECT_EQ( const_fooable.foo(), Mock::value );
+
+    WideFooable copy( fooable );
+    copy.set_value( Mock::other_value );
+    EXPECT_EQ( const_fooable.foo(), Mock::value );
+    EXPECT_EQ( copy.foo(), Mock::other_value );
+}
+
+
+TEST( TestInlineVTableFooable, BufferConfiguration )
+{
+    EXPECT_EQ( Fooable::buffer_size(), 24u );
+    EXPECT_EQ( Fooable::buffer_alignment(), alignof(void*) );
+    EXPECT_EQ( Fooable::inline_capacity(), 24u );
+    EXPECT_TRUE( Fooable::stored_inline<MockFooable>() );
+    EXPECT_FALSE( Fooable::stored_inline<MockLargeFooable>() );
+}
+
+TEST( TestInlineVTableFooable, TriviallyRelocatableObject )
+{
+    EXPECT_TRUE( Fooable::stored_inline<MockRelocatableFooable>() );
+
+    Fooable fooable = MockRelocatableFooable();
+    MockRelocatableFooable::moves() = 0;
+
+    Fooable moved( std::move(fooable) );
+    EXPECT_EQ( moved.foo(), Mock::value );
+    moved.set_value( Mock::other_value );
+    EXPECT_EQ( moved.foo(), Mock::other_value );
+    EXPECT_EQ( MockRelocatableFooable::moves(), 0 );
+}
+
+// The likely type, Mock::MockFooable, is called directly; everything else
+// goes through the table.
+TEST( TestInlineVTableLikelyFooable, LikelyType )
+{
+    InlineVTableLikely::Fooable fooable = MockFooable();
+    EXPECT_EQ( fooable.foo(), Mock::value );
+    fooable.set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::other_value );
+
+    InlineVTableLikely::Fooable copy = fooable;
+    EXPECT_EQ( copy.foo(), Mock::other_value );
+}
+
+TEST( TestInlineVTableLikelyFooable, OtherTypes )
+{
+    InlineVTableLikely::Fooable large = MockLargeFooable();
+    EXPECT_EQ( large.foo(), Mock::value );
+    large.set_value( Mock::other_value );
+    EXPECT_EQ( large.cast<MockLargeFooable>()->foo(), Mock::other_value );
+
+    MockFooable mock_fooable;
+    InlineVTableLikely::Fooable ref = std::ref(mock_fooable);
+    ref.set_value( Mock::other_value );
+    EXPECT_EQ( ref.foo(), Mock::other_value );
+    EXPECT_EQ( mock_fooable.foo(), Mock::other_value );
+}
+
+TEST( TestInlineVTableFooable, InPlace )
+{
+    using Mock::MockValueFooable;
+    MockValueFooable::transfers() = 0;
+
+    Fooable fooable( type_erasure::in_place_type_t<MockValueFooable>(), Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    MockValueFooable& value = fooable.emplace<MockValueFooable>( Mock::value );
+    EXPECT_EQ( &value, fooable.cast<MockValueFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    Fooable made = InlineVTable::make_fooable<MockValueFooable>( Mock::other_value );
+    EXPECT_EQ( made.foo(), Mock::other_value );
+    EXPECT_EQ( MockValueFooable::transfers(), 0 );
+}
+
+TEST( TestInlineVTableFooable, InPlace_LargeObject )
+{
+    Fooable fooable{ type_erasure::in_place_type_t<Mock::MockLargeFooable>() };
+    ASSERT_FALSE( fooable.cast<Mock::MockLargeFooable>() == nullptr );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    fooable.emplace<Mock::MockLargeFooable>().set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    fooable.emplace<MockFooable>();
+    EXPECT_EQ( fooable.foo(), Mock::value );
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include "interface.hh"
+#include "../mock_fooable.hh"
+#include "../util.hh"
+
+namespace
+{
+    using IntrusiveCOW::Fooable;
+    using Mock::MockFooable;
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, Empty )
+{
+    auto expected_heap_allocations = 0u;
+
+    CHECK_HEAP_ALLOC( Fooable fooable,
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable copy(fooable),
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable move( std::move(fooable) ),
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable copy_assign;
+                      copy_assign = move,
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable move_assign;
+                      move_assign = std::move(fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, CopyFromValue )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( mock_fooable ),
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, CopyConstruction )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockFooable();
+    CHECK_HEAP_ALLOC( Fooable other( fooable ),
+                      expected_heap_allocations );
+
+    expected_heap_allocations = 1u;
+    CHECK_HEAP_ALLOC( other.set_value(Mock::other_value),
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, CopyFromValueWithReferenceWrapper )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( std::ref(mock_fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, MoveFromValue )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( std::move(mock_fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, MoveConstruction )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockFooable();
+    CHECK_HEAP_ALLOC( Fooable other( std::move(fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, MoveFromValueWithReferenceWrapper )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( std::move(std::ref(mock_fooable)) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, CopyAssignFromValue )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable;
+                      fooable = mock_fooable,
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, CopyAssignment )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockFooable();
+    CHECK_HEAP_ALLOC( Fooable other;
+                      other = fooable,
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, CopyAssignFromValuenWithReferenceWrapper )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable;
+                      fooable = std::ref(mock_fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, MoveAssignFromValue )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable;
+                      fooable = std::move(mock_fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, MoveAssignment )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockFooable();
+    CHECK_HEAP_ALLOC( Fooable other;
+                      other = std::move(fooable),
+                      expected_heap_allocations );
+}
+
+
+TEST( TestIntrusiveCOWFooable_HeapAllocations, MoveAssignFromValueWithReferenceWrapper )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable;
+                      fooable = std::move(std::ref(mock_fooable)),
+                      expected_heap_allocations );
+}
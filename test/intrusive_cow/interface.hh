@@ -0,0 +1,335 @@
+#ifndef INTRUSIVE_COW_FOOABLE_HH
+#define INTRUSIVE_COW_FOOABLE_HH
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#endif
+
+#ifndef TYPE_ERASURE_LOCAL_REF_COUNT
+#define TYPE_ERASURE_LOCAL_REF_COUNT
+namespace type_erasure
+{
+    // A reference count without atomic operations, for erased objects that
+    // are only ever used by one thread.  In debug builds it asserts that it
+    // is not touched by any other thread than the one that created it.  Only
+    // what reads or changes the count is checked: copying, assigning or
+    // destroying an erased object, and non-const calls on it.  Const calls
+    // are not, and neither are values kept without a count, such as those in
+    // the sbo_cow buffer.
+    class local_ref_count
+    {
+    public:
+        local_ref_count (std::size_t count) noexcept :
+            count_ (count)
+        {}
+
+        local_ref_count& operator++ () noexcept
+        {
+            check_thread();
+            ++count_;
+            return *this;
+        }
+
+        local_ref_count& operator-- () noexcept
+        {
+            check_thread();
+            --count_;
+            return *this;
+        }
+
+        operator std::size_t () const noexcept
+        {
+            check_thread();
+            return count_;
+        }
+
+    private:
+        void check_thread () const noexcept
+        {
+            assert(owner_ == std::this_thread::get_id() &&
+                   "erased object used by more than one thread");
+        }
+
+        std::size_t count_;
+#ifndef NDEBUG
+        std::thread::id owner_ = std::this_thread::get_id();
+#endif
+    };
+}
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
+
+
+namespace IntrusiveCOW {
+    
+    class Fooable
+    {
+    public:
+        // Contructors
+        Fooable () = default;
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable (T&& value) :
+            handle_ (
+                new Handle<typename std::decay<T>::type>(
+                    std::forward<T>(value)
+                )
+            )
+        {}
+    
+        Fooable (const Fooable & rhs) noexcept :
+            handle_ (rhs.handle_)
+        {
+            if (handle_)
+                ++handle_->ref_count_;
+        }
+    
+        Fooable (Fooable && rhs) noexcept :
+            handle_ (rhs.handle_)
+        {
+            rhs.handle_ = nullptr;
+        }
+    
+        ~Fooable ()
+        {
+            release();
+        }
+    
+        // Constructs a T from args in place.
+        template <typename T, typename... Args>
+        explicit Fooable (type_erasure::in_place_type_t<T>, Args&&... args) :
+            handle_ (
+                new Handle<T>(
+                    type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+                )
+            )
+        {}
+    
+        // Assignment
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable& operator= (T&& value)
+        {
+            Fooable temp( std::forward<T>(value) );
+            std::swap(temp.handle_, handle_);
+            return *this;
+        }
+    
+        Fooable & operator= (const Fooable & rhs) noexcept
+        {
+            Fooable temp(rhs);
+            std::swap(temp.handle_, handle_);
+            return *this;
+        }
+    
+        Fooable & operator= (Fooable && rhs) noexcept
+        {
+            Fooable temp(std::move(rhs));
+            std::swap(temp.handle_, handle_);
+            return *this;
+        }
+    
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.  Writing through the reference after the object is copied
+        // would change the copies too.
+        template <typename T, typename... Args>
+        T& emplace (Args&&... args)
+        {
+            HandleBase* const handle = new Handle<T>(
+                type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+            );
+            release();
+            handle_ = handle;
+            return value_of<T>();
+        }
+    
+        template <typename T>
+        T* cast()
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<Handle<T>*>( handle_ )->value_;
+        }
+    
+        template <typename T>
+        const T* cast() const
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<const Handle<T>*>( handle_ )->value_;
+        }
+    
+        int foo ( ) const
+        {
+                assert(handle_);
+                return read().foo( );
+        }
+        void set_value ( int value )
+        {
+                assert(handle_);
+                write().set_value(value );
+        }
+    
+    private:
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename T>
+        T& value_of ()
+        {
+            return static_cast<Handle<T>*>(handle_)->value_;
+        }
+    
+        // The reference count lives in the handle, so that the erased object is a
+        // single pointer, and checking for sharing needs no virtual call.
+        struct HandleBase
+        {
+            HandleBase () noexcept :
+                ref_count_(1)
+            {}
+    
+            virtual ~HandleBase () {}
+            virtual const void* type_id () const noexcept = 0;
+            virtual HandleBase* clone () const = 0;
+    
+            virtual int foo ( ) const = 0;
+            virtual void set_value ( int value ) = 0;
+    
+            std::atomic_size_t ref_count_;
+        };
+    
+        template <typename T>
+        struct Handle : HandleBase
+        {
+            template <typename U,
+                      typename std::enable_if<
+                          !std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle( U&& value ) noexcept
+                : value_( value )
+            {}
+    
+            template <typename U,
+                      typename std::enable_if<
+                          std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle( U&& value ) noexcept ( std::is_rvalue_reference<U>::value &&
+                                                    std::is_nothrow_move_constructible<typename std::decay<U>::type>::value )
+                : value_( std::forward<U>(value) )
+            {}
+    
+            template <typename... Args>
+            explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+                : value_( std::forward<Args>(args)... )
+            {}
+    
+            virtual HandleBase* clone () const
+            {
+                return new Handle(value_);
+            }
+    
+            virtual const void* type_id () const noexcept
+            {
+                return Fooable::type_id<T>();
+            }
+    
+            virtual int foo ( ) const {
+                return value_.foo( );
+            }
+            virtual void set_value ( int value ) {
+                value_.set_value(value );
+            }
+    
+            T value_;
+        };
+    
+        template <typename T>
+        struct Handle< std::reference_wrapper<T> > : Handle<T&>
+        {
+            Handle (std::reference_wrapper<T> ref)
+                : Handle<T&> (ref.get())
+            {}
+        };
+    
+        // A count of one means that no other object can be copying the handle
+        // at the same time, so the last owner skips the atomic decrement.
+        void release () noexcept
+        {
+            if (handle_ && (handle_->ref_count_ == 1u || --handle_->ref_count_ == 0u))
+                delete handle_;
+        }
+    
+        const HandleBase& read () const
+        {
+            return *handle_;
+        }
+    
+        HandleBase& write ()
+        {
+            if (handle_->ref_count_ != 1u) {
+                HandleBase* const clone = handle_->clone();
+                release();
+                handle_ = clone;
+            }
+            return *handle_;
+        }
+    
+        HandleBase* handle_ = nullptr;
+    };
+    
+    // Constructs a T from args in place, in a new Fooable.
+    template <typename T, typename... Args>
+    Fooable make_fooable (Args&&... args)
+    {
+        return Fooable(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
+
+}
+#endif
+
@@ -0,0 +1,13 @@
+#ifndef INTRUSIVE_COW_FOOABLE_HH
+#define INTRUSIVE_COW_FOOABLE_HH
+
+namespace IntrusiveCOW
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
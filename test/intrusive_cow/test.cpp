@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include "interface.hh"
+#include "../cow/interface.hh"
+#include "../mock_fooable.hh"
+
+namespace
+{
+    using IntrusiveCOW::Fooable;
+    using Mock::MockFooable;
+
+    void death_tests( Fooable& fooable )
+    {
+#ifndef NDEBUG
+        EXPECT_DEATH( fooable.foo(), "" );
+        EXPECT_DEATH( fooable.set_value( Mock::other_value ), "" );
+#endif
+    }
+
+    void test_interface( Fooable& fooable, int initial_value, int new_value )
+    {
+        EXPECT_EQ( fooable.foo(), initial_value );
+        fooable.set_value( new_value );
+        EXPECT_EQ( fooable.foo(), new_value );
+    }
+
+    void test_ref_interface( Fooable& fooable, const MockFooable& mock_fooable,
+                             int new_value )
+    {
+        test_interface(fooable, mock_fooable.foo(), new_value);
+        EXPECT_EQ( mock_fooable.foo(), new_value );
+    }
+
+    void test_copies( Fooable& copy, const Fooable& fooable, int new_value )
+    {
+        auto value = fooable.foo();
+        test_interface( copy, value, new_value );
+        EXPECT_EQ( fooable.foo(), value );
+        ASSERT_NE( value, new_value );
+        EXPECT_NE( fooable.foo(), copy.foo() );
+    }
+}
+
+TEST( TestIntrusiveCOWFooable, Empty )
+{
+    Fooable fooable;
+    death_tests(fooable);
+
+    Fooable copy(fooable);
+    death_tests(copy);
+
+    Fooable move( std::move(fooable) );
+    death_tests(move);
+
+    Fooable copy_assign;
+    copy_assign = move;
+    death_tests(copy_assign);
+
+    Fooable move_assign;
+    move_assign = std::move(fooable);
+    death_tests(move_assign);
+}
+
+TEST( TestIntrusiveCOWFooable, CopyFromValue )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+TEST( TestIntrusiveCOWFooable, CopyConstruction )
+{
+    Fooable fooable = MockFooable();
+    Fooable other( fooable );
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestIntrusiveCOWFooable, CopyFromValueWithReferenceWrapper )
+{
+    MockFooable mock_fooable;
+    Fooable fooable( std::ref(mock_fooable) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestIntrusiveCOWFooable, MoveFromValue )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+TEST( TestIntrusiveCOWFooable, MoveConstruction )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestIntrusiveCOWFooable, MoveFromValueWithReferenceWrapper )
+{
+    MockFooable mock_fooable;
+    Fooable fooable( std::move(std::ref(mock_fooable)) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestIntrusiveCOWFooable, CopyAssignFromValue )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = mock_fooable;
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestIntrusiveCOWFooable, CopyAssignment )
+{
+    Fooable fooable = MockFooable();
+    Fooable other;
+    other = fooable;
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestIntrusiveCOWFooable, CopyAssignFromValueWithReferenceWrapper )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::ref(mock_fooable);
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestIntrusiveCOWFooable, MoveAssignFromValue )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = std::move(mock_fooable);
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestIntrusiveCOWFooable, MoveAssignment )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other;
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestIntrusiveCOWFooable, MoveAssignFromValueWithReferenceWrapper )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::move(std::ref(mock_fooable));
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestIntrusiveCOWFooable, Cast )
+{
+    Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::value );
+}
+
+TEST( TestIntrusiveCOWFooable, ConstCast )
+{
+    const Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::value );
+}
+
+TEST( TestIntrusiveCOWFooable, Size )
+{
+    EXPECT_EQ( sizeof(Fooable), sizeof(void*) );
+    EXPECT_LT( sizeof(Fooable), sizeof(COW::Fooable) );
+}
+
+TEST( TestIntrusiveCOWFooable, CopyOnWrite )
+{
+    Fooable fooable = MockFooable();
+    Fooable copy( fooable );
+    Fooable other_copy;
+    other_copy = copy;
+    EXPECT_EQ( copy.cast<MockFooable>(), fooable.cast<MockFooable>() );
+    EXPECT_EQ( other_copy.cast<MockFooable>(), fooable.cast<MockFooable>() );
+
+    copy.set_value( Mock::other_value );
+    EXPECT_NE( copy.cast<MockFooable>(), fooable.cast<MockFooable>() );
+    EXPECT_EQ( other_copy.cast<MockFooable>(), fooable.cast<MockFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+    EXPECT_EQ( other_copy.foo(), Mock::value );
+    EXPECT_EQ( copy.foo(), Mock::other_value );
+
+    // The last owner writes in place.
+    const MockFooable* address = copy.cast<MockFooable>();
+    copy.set_value( Mock::value );
+    EXPECT_EQ( copy.cast<MockFooable>(), address );
+}
+
+TEST( TestIntrusiveCOWFooable, NonTrivialObject )
+{
+    {
+        Fooable fooable = Mock::MockNonTrivialFooable();
+        EXPECT_EQ( Mock::MockNonTrivialFooable::instances(), 1 );
+
+        Fooable copy( fooable );
+        EXPECT_EQ( Mock::MockNonTrivialFooable::instances(), 1 );
+
+        copy.set_value( Mock::other_value );
+        EXPECT_EQ( Mock::MockNonTrivialFooable::instances(), 2 );
+
+        fooable = copy;
+        EXPECT_EQ( Mock::MockNonTrivialFooable::instances(), 1 );
+    }
+
+    EXPECT_EQ( Mock::MockNonTrivialFooable::instances(), 0 );
+}
+
+TEST( TestIntrusiveCOWFooable, InPlace )
+{
+    using Mock::MockValueFooable;
+    MockValueFooable::transfers() = 0;
+
+    Fooable fooable( type_erasure::in_place_type_t<MockValueFooable>(), Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    MockValueFooable& value = fooable.emplace<MockValueFooable>( Mock::value );
+    EXPECT_EQ( &value, fooable.cast<MockValueFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    Fooable made = IntrusiveCOW::make_fooable<MockValueFooable>( Mock::other_value );
+    EXPECT_EQ( made.foo(), Mock::other_value );
+    EXPECT_EQ( MockValueFooable::transfers(), 0 );
+}
@@ -2,6 +2,22 @@
 #define MOCK_FOOABLE_HH
 
 #include <array>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#ifndef TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+#define TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+namespace type_erasure
+{
+    // Values of types for which this is true are moved by copying their bytes,
+    // without calling the move constructor or the destructor.  True for
+    // trivially copyable types; specialize it for other types that allow this.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T>
+    {};
+}
+#endif
 
 namespace Mock
 {
@@ -29,6 +45,208 @@ namespace Mock
     private:
         std::array<double,1024> buffer_;
     };
+
+    struct alignas(16) MockAlignedFooable : MockFooable
+    {
+    private:
+        std::array<float,4> buffer_;
+    };
+
+    // Can be moved, but not copied.
+    struct MockMoveOnlyFooable : MockFooable
+    {
+        MockMoveOnlyFooable () = default;
+
+        MockMoveOnlyFooable (MockMoveOnlyFooable&&) = default;
+
+        MockMoveOnlyFooable& operator= (MockMoveOnlyFooable&&) = default;
+
+    private:
+        std::unique_ptr<int> resource_;
+    };
+
+    struct MockLargeMoveOnlyFooable : MockMoveOnlyFooable
+    {
+    private:
+        std::array<double,1024> buffer_;
+    };
+
+    // Small, but neither trivially copyable nor trivially destructible.
+    // Counts its live instances.
+    struct MockNonTrivialFooable : MockFooable
+    {
+        MockNonTrivialFooable () noexcept
+        {
+            ++instances();
+        }
+
+        MockNonTrivialFooable (const MockNonTrivialFooable& other) noexcept :
+            MockFooable(other)
+        {
+            ++instances();
+        }
+
+        MockNonTrivialFooable& operator= (const MockNonTrivialFooable& other) noexcept
+        {
+            MockFooable::operator=(other);
+            return *this;
+        }
+
+        ~MockNonTrivialFooable ()
+        {
+            --instances();
+        }
+
+        static int& instances ()
+        {
+            static int instances_ = 0;
+            return instances_;
+        }
+    };
+
+    // Counts its moves.  It is declared trivially relocatable below, so the
+    // erased types move it without calling its move constructor.
+    struct MockRelocatableFooable : MockFooable
+    {
+        MockRelocatableFooable () = default;
+
+        MockRelocatableFooable (const MockRelocatableFooable&) = default;
+
+        MockRelocatableFooable (MockRelocatableFooable&& other) noexcept :
+            MockFooable(other)
+        {
+            ++moves();
+        }
+
+        static int& moves ()
+        {
+            static int moves_ = 0;
+            return moves_;
+        }
+    };
+}
+
+namespace type_erasure
+{
+    template <>
+    struct is_trivially_relocatable<Mock::MockRelocatableFooable> : std::true_type
+    {};
+}
+
+namespace Mock
+{
+
+    struct MockStringFooable : MockFooable
+    {
+    private:
+        std::string name_ = "fooable";
+    };
+
+    // Built from its value.  Counts its copies and moves, which
+    // constructing it in place should not need.
+    struct MockValueFooable : MockFooable
+    {
+        explicit MockValueFooable (int val)
+        {
+            set_value(val);
+        }
+
+        MockValueFooable (const MockValueFooable& other) :
+            MockFooable(other)
+        {
+            ++transfers();
+        }
+
+        MockValueFooable (MockValueFooable&& other) noexcept :
+            MockFooable(other)
+        {
+            ++transfers();
+        }
+
+        static int& transfers ()
+        {
+            static int transfers_ = 0;
+            return transfers_;
+        }
+    };
+
+    // Counts its copies.
+    struct CopyCounter
+    {
+        CopyCounter () = default;
+
+        CopyCounter (const CopyCounter&)
+        {
+            ++copies();
+        }
+
+        CopyCounter (CopyCounter&&) = default;
+
+        CopyCounter& operator= (const CopyCounter&)
+        {
+            ++copies();
+            return *this;
+        }
+
+        CopyCounter& operator= (CopyCounter&&) = default;
+
+        static int& copies ()
+        {
+            static int copies_ = 0;
+            return copies_;
+        }
+    };
+
+    // Keeps the last argument it was given.
+    struct MockSink
+    {
+        void take(CopyCounter value)
+        {
+            kept_ = std::move(value);
+        }
+
+        void take_rvalue(CopyCounter&& value)
+        {
+            kept_ = std::move(value);
+        }
+
+        void take_ref(const CopyCounter& value)
+        {
+            kept_ = value;
+        }
+
+    private:
+        CopyCounter kept_;
+    };
+
+    // Has noexcept functions, and an rvalue-qualified overload that gives
+    // up its counter instead of copying it.
+    struct MockQualifiedFooable
+    {
+        int foo() const noexcept
+        {
+            return value_;
+        }
+
+        void set_value(int val) noexcept
+        {
+            value_ = val;
+        }
+
+        CopyCounter counter() const &
+        {
+            return counter_;
+        }
+
+        CopyCounter counter() &&
+        {
+            return std::move(counter_);
+        }
+
+    private:
+        int value_ = value;
+        CopyCounter counter_;
+    };
 }
 
 #endif // MOCK_FOOABLE_HH
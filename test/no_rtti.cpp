@@ -0,0 +1,75 @@
+// Built with -fno-rtti where the compiler supports it: cast() identifies the
+// stored type through the address of a per-type tag, not through RTTI.  The
+// erased types here are also compiled with RTTI into unit_tests, so this file
+// is a test program of its own, no_rtti_tests.
+
+#include <gtest/gtest.h>
+
+#include "basic/interface.hh"
+#include "cow/interface.hh"
+#include "intrusive_cow/interface.hh"
+#include "sbo/interface.hh"
+#include "sbo_cow/interface.hh"
+#include "unique/interface.hh"
+#include "unique_sbo/interface.hh"
+
+#include <array>
+
+namespace
+{
+    struct Small
+    {
+        int foo() const
+        {
+            return value_;
+        }
+
+        void set_value(int val)
+        {
+            value_ = val;
+        }
+
+    private:
+        int value_ = 1;
+    };
+
+    struct Large : Small
+    {
+    private:
+        std::array<double, 16> buffer_;
+    };
+
+    template <typename Fooable, typename T>
+    void test_cast ()
+    {
+        Fooable fooable = T();
+        const Fooable& const_fooable = fooable;
+
+        ASSERT_FALSE( fooable.template cast<T>() == nullptr );
+        EXPECT_EQ( fooable.template cast<T>()->foo(), 1 );
+        EXPECT_EQ( const_fooable.template cast<T>(), fooable.template cast<T>() );
+
+        EXPECT_TRUE( fooable.template cast<int>() == nullptr );
+        EXPECT_TRUE( const_fooable.template cast<int>() == nullptr );
+        EXPECT_TRUE( fooable.template cast<Small>() == nullptr ||
+                     fooable.template cast<Large>() == nullptr );
+    }
+
+    template <typename Fooable>
+    void test_casts ()
+    {
+        test_cast<Fooable, Small>();
+        test_cast<Fooable, Large>();
+    }
+}
+
+TEST( TestNoRTTI, Cast )
+{
+    test_casts<Basic::Fooable>();
+    test_casts<COW::Fooable>();
+    test_casts<IntrusiveCOW::Fooable>();
+    test_casts<SBO::Fooable>();
+    test_casts<SBOCOW::Fooable>();
+    test_casts<Unique::Fooable>();
+    test_casts<UniqueSBO::Fooable>();
+}
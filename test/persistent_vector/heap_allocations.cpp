@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "../cow/interface.hh"
+#include "../mock_fooable.hh"
+#include "../util.hh"
+
+namespace
+{
+    using COW::Fooable;
+    using Mock::MockFooable;
+
+    using Vector = type_erasure::persistent_vector<Fooable>;
+
+    Vector make_vector (std::size_t size)
+    {
+        Vector retval;
+        for (std::size_t i = 0; i < size; ++i) {
+            retval.push_back( MockFooable() );
+        }
+        return retval;
+    }
+}
+
+TEST( TestPersistentVector_HeapAllocations, Copy )
+{
+    auto expected_heap_allocations = 0u;
+
+    const Vector vector = make_vector( 1025 );
+    CHECK_HEAP_ALLOC( Vector copy = vector,
+                      expected_heap_allocations );
+}
+
+TEST( TestPersistentVector_HeapAllocations, SetAfterCopy )
+{
+    const Vector vector = make_vector( 1025 );
+    Vector copy = vector;
+    Fooable value = MockFooable();
+
+    // The root, the node above the chunk and the chunk are each copied into
+    // one allocation for the node and one for its contents.
+    auto expected_heap_allocations = 6u;
+    CHECK_HEAP_ALLOC( copy.set( 0, value ),
+                      expected_heap_allocations );
+
+    expected_heap_allocations = 0u;
+    CHECK_HEAP_ALLOC( copy.set( 1, value ),
+                      expected_heap_allocations );
+
+    // Only the next chunk is still shared.
+    expected_heap_allocations = 2u;
+    CHECK_HEAP_ALLOC( copy.set( 32, value ),
+                      expected_heap_allocations );
+}
+
+TEST( TestPersistentVector_HeapAllocations, Iterate )
+{
+    auto expected_heap_allocations = 0u;
+
+    const Vector vector = make_vector( 1025 );
+    int sum = 0;
+    CHECK_HEAP_ALLOC( for (const Fooable& value : vector) { sum += value.foo(); },
+                      expected_heap_allocations );
+    EXPECT_EQ( sum, 1025 * Mock::value );
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include "../cow/interface.hh"
+#include "../mock_fooable.hh"
+
+#include <vector>
+
+namespace
+{
+    using COW::Fooable;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::MockNonTrivialFooable;
+
+    using Vector = type_erasure::persistent_vector<Fooable>;
+
+    // Holds size values, alternating small and large ones, with the value at
+    // index i set to i.
+    Vector make_vector (std::size_t size)
+    {
+        Vector retval;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (i % 2)
+                retval.push_back( MockLargeFooable() );
+            else
+                retval.push_back( MockFooable() );
+            retval.update( i, [i]( Fooable& value ) { value.set_value( static_cast<int>(i) ); } );
+        }
+        return retval;
+    }
+
+    std::vector<int> values (const Vector& vector)
+    {
+        std::vector<int> retval;
+        for (const Fooable& value : vector) {
+            retval.push_back( value.foo() );
+        }
+        return retval;
+    }
+
+    std::vector<int> iota (std::size_t size)
+    {
+        std::vector<int> retval;
+        for (std::size_t i = 0; i < size; ++i) {
+            retval.push_back( static_cast<int>(i) );
+        }
+        return retval;
+    }
+}
+
+
+TEST( TestPersistentVector, Empty )
+{
+    Vector vector;
+    EXPECT_TRUE( vector.empty() );
+    EXPECT_EQ( vector.size(), 0u );
+    EXPECT_TRUE( vector.begin() == vector.end() );
+
+    Vector copy = vector;
+    EXPECT_TRUE( copy.empty() );
+}
+
+TEST( TestPersistentVector, PushBack )
+{
+    // Sizes on either side of a full chunk, and of a full tree of one and
+    // two levels above the chunks.
+    const std::size_t sizes[] = {1, 32, 33, 1024, 1025, 32 * 1024 + 1};
+    for (std::size_t size : sizes) {
+        Vector vector = make_vector( size );
+        EXPECT_EQ( vector.size(), size );
+        EXPECT_FALSE( vector.empty() );
+        for (std::size_t i = 0; i < size; ++i) {
+            ASSERT_EQ( vector[i].foo(), static_cast<int>(i) );
+        }
+        EXPECT_EQ( values( vector ), iota( size ) );
+    }
+}
+
+TEST( TestPersistentVector, CopyIsIndependent )
+{
+    const Vector vector = make_vector( 1025 );
+    Vector copy = vector;
+    EXPECT_EQ( values( copy ), iota( 1025 ) );
+
+    copy.set( 0, MockFooable() );
+    copy.update( 1000, []( Fooable& value ) { value.set_value( Mock::other_value ); } );
+    copy.push_back( MockFooable() );
+
+    EXPECT_EQ( vector.size(), 1025u );
+    EXPECT_EQ( values( vector ), iota( 1025 ) );
+
+    EXPECT_EQ( copy.size(), 1026u );
+    EXPECT_EQ( copy[0].foo(), Mock::value );
+    EXPECT_EQ( copy[1000].foo(), Mock::other_value );
+    EXPECT_EQ( copy[1025].foo(), Mock::value );
+}
+
+TEST( TestPersistentVector, CopySharesUnchangedChunks )
+{
+    const Vector vector = make_vector( 1025 );
+    Vector copy = vector;
+    EXPECT_EQ( &copy[0], &vector[0] );
+
+    copy.set( 0, MockFooable() );
+    EXPECT_NE( &copy[0], &vector[0] );
+    EXPECT_NE( &copy[31], &vector[31] );
+    EXPECT_EQ( &copy[32], &vector[32] );
+    EXPECT_EQ( &copy[1024], &vector[1024] );
+}
+
+TEST( TestPersistentVector, UnsharedChangesInPlace )
+{
+    Vector vector = make_vector( 100 );
+    const Fooable* value = &vector[50];
+
+    vector.set( 50, MockFooable() );
+    vector.update( 50, []( Fooable& value ) { value.set_value( Mock::other_value ); } );
+    EXPECT_EQ( &vector[50], value );
+    EXPECT_EQ( vector[50].foo(), Mock::other_value );
+}
+
+TEST( TestPersistentVector, NonTrivialObject )
+{
+    {
+        Vector vector;
+        for (int i = 0; i < 40; ++i) {
+            vector.push_back( MockNonTrivialFooable() );
+        }
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 40 );
+
+        // The copied chunk shares its erased values with the original.
+        Vector copy = vector;
+        copy.set( 0, MockFooable() );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 40 );
+
+        copy.update( 1, []( Fooable& value ) { value.set_value( Mock::other_value ); } );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 41 );
+        EXPECT_EQ( vector[1].foo(), Mock::value );
+
+        vector.clear();
+        EXPECT_TRUE( vector.empty() );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 39 );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
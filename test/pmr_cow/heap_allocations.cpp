@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include "interface.hh"
+#include "../mock_fooable.hh"
+#include "../counting_resource.hh"
+#include "../util.hh"
+
+namespace
+{
+    using PMRCOW::Fooable;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::CountingResource;
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, Empty )
+{
+    auto expected_heap_allocations = 0u;
+
+    CHECK_HEAP_ALLOC( Fooable fooable,
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable copy(fooable),
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable move( std::move(fooable) ),
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable copy_assign;
+                      copy_assign = move,
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable move_assign;
+                      move_assign = std::move(fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, CopyFromValue )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( mock_fooable ),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, CopyConstruction )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockFooable();
+    CHECK_HEAP_ALLOC( Fooable other( fooable ),
+                      expected_heap_allocations );
+
+    expected_heap_allocations = 1u;
+    CHECK_HEAP_ALLOC( other.set_value(Mock::other_value),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, CopyFromValueWithReferenceWrapper )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( std::ref(mock_fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, MoveFromValue )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( std::move(mock_fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, MoveConstruction )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockFooable();
+    CHECK_HEAP_ALLOC( Fooable other( std::move(fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, MoveFromValueWithReferenceWrapper )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( std::move(std::ref(mock_fooable)) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, CopyAssignFromValue )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable;
+                      fooable = mock_fooable,
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, CopyAssignment )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockFooable();
+    CHECK_HEAP_ALLOC( Fooable other;
+                      other = fooable,
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, CopyAssignFromValuenWithReferenceWrapper )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable;
+                      fooable = std::ref(mock_fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, MoveAssignFromValue )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable;
+                      fooable = std::move(mock_fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, MoveAssignment )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockFooable();
+    CHECK_HEAP_ALLOC( Fooable other;
+                      other = std::move(fooable),
+                      expected_heap_allocations );
+}
+
+
+TEST( TestPMRCOWFooable_HeapAllocations, MoveAssignFromValueWithReferenceWrapper )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable;
+                      fooable = std::move(std::ref(mock_fooable)),
+                      expected_heap_allocations );
+}
+
+TEST( TestPMRCOWFooable_HeapAllocations, Resource )
+{
+    auto expected_heap_allocations = 0u;
+
+    CountingResource resource;
+    CHECK_HEAP_ALLOC( Fooable fooable( MockLargeFooable(), &resource );
+                      Fooable copy( fooable );
+                      copy.set_value( Mock::other_value ),
+                      expected_heap_allocations );
+}
@@ -0,0 +1,742 @@
+#ifndef PMR_COW_FOOABLE_HH
+#define PMR_COW_FOOABLE_HH
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#endif
+
+#ifndef TYPE_ERASURE_MEMORY_RESOURCE
+#define TYPE_ERASURE_MEMORY_RESOURCE
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#define TYPE_ERASURE_STD_PMR
+#endif
+#endif
+
+#ifdef TYPE_ERASURE_STD_PMR
+#include <memory_resource>
+
+namespace type_erasure
+{
+    using memory_resource = std::pmr::memory_resource;
+
+    inline memory_resource* default_resource () noexcept
+    {
+        return std::pmr::get_default_resource();
+    }
+}
+#else
+namespace type_erasure
+{
+    // The part of C++17's std::pmr::memory_resource used by the erased types.
+    // With C++17, this is std::pmr::memory_resource itself.
+    class memory_resource
+    {
+    public:
+        virtual ~memory_resource () {}
+
+        void* allocate (std::size_t bytes,
+                        std::size_t alignment = alignof(std::max_align_t))
+        {
+            return do_allocate(bytes, alignment);
+        }
+
+        void deallocate (void* ptr, std::size_t bytes,
+                         std::size_t alignment = alignof(std::max_align_t))
+        {
+            do_deallocate(ptr, bytes, alignment);
+        }
+
+        bool is_equal (const memory_resource& other) const noexcept
+        {
+            return do_is_equal(other);
+        }
+
+    private:
+        virtual void* do_allocate (std::size_t bytes, std::size_t alignment) = 0;
+        virtual void do_deallocate (void* ptr, std::size_t bytes, std::size_t alignment) = 0;
+        virtual bool do_is_equal (const memory_resource& other) const noexcept = 0;
+    };
+
+    // Uses the global operator new and operator delete.
+    inline memory_resource* default_resource () noexcept
+    {
+        struct new_delete_resource : memory_resource
+        {
+            void* do_allocate (std::size_t bytes, std::size_t alignment) override
+            {
+                assert(alignment <= alignof(std::max_align_t));
+                return ::operator new(bytes);
+            }
+
+            void do_deallocate (void* ptr, std::size_t, std::size_t) override
+            {
+                ::operator delete(ptr);
+            }
+
+            bool do_is_equal (const memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+        static new_delete_resource resource;
+        return &resource;
+    }
+}
+#endif
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
+
+#ifndef TYPE_ERASURE_LEADS_WITH_RESOURCE
+#define TYPE_ERASURE_LEADS_WITH_RESOURCE
+namespace type_erasure
+{
+    // Whether the first of Args is a memory_resource*.  Such arguments select
+    // the in-place constructors that take a resource, so that it is never
+    // passed on to the constructor of the stored type.
+    template <typename... Args>
+    struct leads_with_resource : std::false_type
+    {};
+
+    template <typename Arg, typename... Args>
+    struct leads_with_resource<Arg, Args...> : std::is_convertible<Arg, memory_resource*>
+    {};
+}
+#endif
+
+#ifndef TYPE_ERASURE_POOL_RESOURCE
+#define TYPE_ERASURE_POOL_RESOURCE
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace type_erasure
+{
+    // A memory_resource that keeps one free list per size class, and recycles
+    // freed blocks instead of returning them to its upstream resource.  Blocks
+    // of up to max_block_size() bytes are carved out of chunks allocated from
+    // upstream; larger or over-aligned requests go to upstream directly.
+    // release() returns all chunks to upstream at once, and so must only be
+    // called when no block handed out by the pool is in use anymore.  Not
+    // thread safe; see thread_local_pool_resource().
+    class pool_resource : public memory_resource
+    {
+    public:
+        explicit pool_resource (memory_resource* upstream = default_resource()) noexcept :
+            upstream_ (upstream)
+        {}
+
+        pool_resource (const pool_resource&) = delete;
+        pool_resource& operator= (const pool_resource&) = delete;
+
+        ~pool_resource ()
+        {
+            release();
+        }
+
+        void release () noexcept
+        {
+            while (chunks_) {
+                Chunk* const next = chunks_->next;
+                upstream_->deallocate(chunks_, chunk_size, granularity);
+                chunks_ = next;
+            }
+            for (Block*& free_list : free_lists_) {
+                free_list = nullptr;
+            }
+        }
+
+        memory_resource* upstream_resource () const noexcept
+        {
+            return upstream_;
+        }
+
+        static constexpr std::size_t max_block_size ()
+        {
+            return max_size;
+        }
+
+        static constexpr std::size_t chunk_bytes ()
+        {
+            return chunk_size;
+        }
+
+    private:
+        enum : std::size_t {
+            granularity = alignof(std::max_align_t),
+            max_size = 256,
+            chunk_size = 16384,
+            size_classes = max_size / granularity
+        };
+
+        struct Block
+        {
+            Block* next;
+        };
+
+        // Stored at the start of each chunk, in front of its first block.
+        struct Chunk
+        {
+            Chunk* next;
+        };
+
+        static bool pooled (std::size_t bytes, std::size_t alignment) noexcept
+        {
+            return bytes <= max_size && alignment <= granularity;
+        }
+
+        static std::size_t size_class (std::size_t bytes) noexcept
+        {
+            return bytes ? (bytes - 1) / granularity : 0;
+        }
+
+        void* do_allocate (std::size_t bytes, std::size_t alignment) override
+        {
+            if (!pooled(bytes, alignment))
+                return upstream_->allocate(bytes, alignment);
+
+            Block*& free_list = free_lists_[size_class(bytes)];
+            if (!free_list)
+                refill(size_class(bytes));
+
+            Block* const block = free_list;
+            free_list = block->next;
+            return block;
+        }
+
+        void do_deallocate (void* ptr, std::size_t bytes, std::size_t alignment) override
+        {
+            if (!pooled(bytes, alignment)) {
+                upstream_->deallocate(ptr, bytes, alignment);
+                return;
+            }
+
+            Block*& free_list = free_lists_[size_class(bytes)];
+            free_list = new (ptr) Block{free_list};
+        }
+
+        bool do_is_equal (const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        // Carves a new chunk into blocks of the given size class.
+        void refill (std::size_t size_class)
+        {
+            unsigned char* const chunk = static_cast<unsigned char*>(
+                upstream_->allocate(chunk_size, granularity)
+            );
+            chunks_ = new (chunk) Chunk{chunks_};
+
+            const std::size_t block_size = (size_class + 1) * granularity;
+            Block*& free_list = free_lists_[size_class];
+            for (std::size_t offset = granularity;
+                 offset + block_size <= chunk_size;
+                 offset += block_size) {
+                free_list = new (chunk + offset) Block{free_list};
+            }
+        }
+
+        memory_resource* upstream_;
+        Block* free_lists_[size_classes] = {};
+        Chunk* chunks_ = nullptr;
+    };
+
+    // What thread_local_pool_resource() keeps for one thread: its pool, and
+    // the blocks other threads have freed.  Those are pushed onto a lock-free
+    // list, which the owning thread moves into its pool on its next
+    // allocation.  Each block records its owner in front of the bytes handed
+    // out.  The state outlives its thread for as long as any of its blocks
+    // are in use; whichever thread frees the last one deletes it.
+    class thread_local_pool_state
+    {
+    public:
+        thread_local_pool_state (const thread_local_pool_state&) = delete;
+        thread_local_pool_state& operator= (const thread_local_pool_state&) = delete;
+
+        // The calling thread's state, created on first use.
+        static thread_local_pool_state& current ()
+        {
+            static thread_local Owner owner;
+            return *owner.state;
+        }
+
+        // Returns all of the pool's chunks to upstream at once.  Blocks that
+        // other threads have freed are dropped first, since they live in
+        // those chunks.  Must be called on the owning thread, once no block
+        // from the pool is in use on any thread.
+        void release () noexcept
+        {
+            remote_frees_.store(nullptr, std::memory_order_relaxed);
+            pool_.release();
+        }
+
+        // Must be called on the owning thread.
+        void* allocate (std::size_t bytes, std::size_t alignment)
+        {
+            drain();
+
+            const std::size_t header = header_size(alignment);
+            unsigned char* const payload = static_cast<unsigned char*>(
+                pool_.allocate(block_size(bytes, alignment), alignment)
+            ) + header;
+            new (payload - sizeof(thread_local_pool_state*)) thread_local_pool_state*(this);
+            users_.fetch_add(1, std::memory_order_relaxed);
+            return payload;
+        }
+
+        // May be called on any thread.
+        static void deallocate (void* ptr, std::size_t bytes, std::size_t alignment)
+        {
+            unsigned char* const payload = static_cast<unsigned char*>(ptr);
+            const std::size_t header = header_size(alignment);
+            thread_local_pool_state* const owner =
+                *reinterpret_cast<thread_local_pool_state**>(payload - sizeof(thread_local_pool_state*));
+
+            if (owner == running()) {
+                owner->pool_.deallocate(payload - header, block_size(bytes, alignment), alignment);
+                owner->users_.fetch_sub(1, std::memory_order_relaxed);
+            } else {
+                owner->free_remote(payload - header, block_size(bytes, alignment), alignment);
+            }
+        }
+
+    private:
+        // A block freed by another thread than its owner.
+        struct RemoteBlock
+        {
+            RemoteBlock* next;
+            std::size_t bytes;
+            std::size_t alignment;
+        };
+
+        // Ends the owning thread's use of the state.
+        struct Owner
+        {
+            Owner () :
+                state (new thread_local_pool_state)
+            {
+                running() = state;
+            }
+
+            ~Owner ()
+            {
+                running() = nullptr;
+                state->release_user();
+            }
+
+            thread_local_pool_state* state;
+        };
+
+        thread_local_pool_state () = default;
+
+        // The state of the calling thread, or null once that thread is ending.
+        // A plain pointer, so it can still be read while thread_local objects
+        // are being destroyed.
+        static thread_local_pool_state*& running () noexcept
+        {
+            static thread_local thread_local_pool_state* state = nullptr;
+            return state;
+        }
+
+        // Room for the owner in front of the bytes handed out, keeping them
+        // aligned.
+        static std::size_t header_size (std::size_t alignment) noexcept
+        {
+            return alignof(std::max_align_t) < alignment ? alignment : alignof(std::max_align_t);
+        }
+
+        // The whole block, which becomes a RemoteBlock if another thread
+        // frees it.
+        static std::size_t block_size (std::size_t bytes, std::size_t alignment) noexcept
+        {
+            return header_size(alignment) + bytes < sizeof(RemoteBlock) ?
+                sizeof(RemoteBlock) : header_size(alignment) + bytes;
+        }
+
+        void free_remote (void* block, std::size_t bytes, std::size_t alignment) noexcept
+        {
+            RemoteBlock* const remote = new (block) RemoteBlock{
+                remote_frees_.load(std::memory_order_relaxed), bytes, alignment
+            };
+            while (!remote_frees_.compare_exchange_weak(remote->next, remote,
+                                                        std::memory_order_release,
+                                                        std::memory_order_relaxed)) {
+            }
+            release_user();
+        }
+
+        void drain () noexcept
+        {
+            if (!remote_frees_.load(std::memory_order_relaxed))
+                return;
+
+            RemoteBlock* remote = remote_frees_.exchange(nullptr, std::memory_order_acquire);
+            while (remote) {
+                RemoteBlock* const next = remote->next;
+                pool_.deallocate(remote, remote->bytes, remote->alignment);
+                remote = next;
+            }
+        }
+
+        void release_user () noexcept
+        {
+            if (users_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                drain();
+                delete this;
+            }
+        }
+
+        pool_resource pool_;
+        std::atomic<RemoteBlock*> remote_frees_{nullptr};
+        // The owning thread while it runs, plus each block in use.
+        std::atomic<std::size_t> users_{1};
+    };
+
+    // The calling thread's pool.  Call release() on it to free everything it
+    // holds at once, once no block from it is in use on any thread.
+    inline thread_local_pool_state& thread_local_pool () noexcept
+    {
+        return thread_local_pool_state::current();
+    }
+
+    // Allocates from thread_local_pool() of the calling thread, so allocation
+    // takes no locks.  A block may be freed on any thread: one freed by
+    // another thread than the one that allocated it goes back to its own
+    // pool, which lives on after its thread ends until all of its blocks
+    // have been freed.
+    inline memory_resource* thread_local_pool_resource () noexcept
+    {
+        struct thread_local_pool_dispatch : memory_resource
+        {
+            void* do_allocate (std::size_t bytes, std::size_t alignment) override
+            {
+                return thread_local_pool_state::current().allocate(bytes, alignment);
+            }
+
+            void do_deallocate (void* ptr, std::size_t bytes, std::size_t alignment) override
+            {
+                thread_local_pool_state::deallocate(ptr, bytes, alignment);
+            }
+
+            bool do_is_equal (const memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+        static thread_local_pool_dispatch resource;
+        return &resource;
+    }
+}
+#endif
+
+
+namespace PMRCOW {
+    
+    class Fooable
+    {
+    public:
+        // Contructors
+        Fooable () = default;
+    
+        explicit Fooable (type_erasure::memory_resource* resource) noexcept :
+            resource_ (resource)
+        {}
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value &&
+                      !std::is_convertible< T, type_erasure::memory_resource* >::value
+                      >::type* = nullptr>
+        Fooable (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                             std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ) :
+            handle_ (
+                std::allocate_shared< Handle<typename std::decay<T>::type> >(
+                    Allocator<HandleBase>(resource_),
+                    std::forward<T>(value)
+                )
+            )
+        {}
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable (T&& value, type_erasure::memory_resource* resource) :
+            resource_ (resource),
+            handle_ (
+                std::allocate_shared< Handle<typename std::decay<T>::type> >(
+                    Allocator<HandleBase>(resource_),
+                    std::forward<T>(value)
+                )
+            )
+        {}
+    
+        // Constructs a T from args in place.
+        template <typename T, typename... Args,
+                  typename std::enable_if<
+                      !type_erasure::leads_with_resource<Args...>::value
+                      >::type* = nullptr>
+        explicit Fooable (type_erasure::in_place_type_t<T>, Args&&... args) :
+            handle_ (
+                std::allocate_shared< Handle<T> >(
+                    Allocator<HandleBase>(resource_),
+                    type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+                )
+            )
+        {}
+    
+        template <typename T, typename... Args>
+        Fooable (type_erasure::in_place_type_t<T>, type_erasure::memory_resource* resource,
+                       Args&&... args) :
+            resource_ (resource),
+            handle_ (
+                std::allocate_shared< Handle<T> >(
+                    Allocator<HandleBase>(resource_),
+                    type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+                )
+            )
+        {}
+    
+        // Assignment
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                        std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            Fooable temp( std::forward<T>(value), resource_ );
+            std::swap(temp.handle_, handle_);
+            return *this;
+        }
+    
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.  Writing through the reference after the object is copied
+        // would change the copies too.
+        template <typename T, typename... Args>
+        T& emplace (Args&&... args)
+        {
+            handle_ = std::allocate_shared< Handle<T> >(
+                Allocator<HandleBase>(resource_),
+                type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+            );
+            return value_of<T>();
+        }
+    
+        template <typename T>
+        T* cast()
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<Handle<T>*>( handle_.get() )->value_;
+        }
+    
+        template <typename T>
+        const T* cast() const
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<const Handle<T>*>( handle_.get() )->value_;
+        }
+    
+        // The resource that values are allocated from, including the copies made
+        // when a shared value is written to.  It goes along with the value on
+        // copies, moves and assignments.
+        type_erasure::memory_resource* resource () const noexcept
+        {
+            return resource_;
+        }
+    
+        int foo ( ) const
+        {
+                assert(handle_);
+                return read().foo( );
+        }
+        void set_value ( int value )
+        {
+                assert(handle_);
+                write().set_value(value );
+        }
+    
+    private:
+        // Allocates from a memory_resource, for std::allocate_shared().
+        template <typename T>
+        struct Allocator
+        {
+            using value_type = T;
+    
+            explicit Allocator (type_erasure::memory_resource* resource) noexcept :
+                resource_ (resource)
+            {}
+    
+            template <typename U>
+            Allocator (const Allocator<U>& other) noexcept :
+                resource_ (other.resource_)
+            {}
+    
+            T* allocate (std::size_t n)
+            {
+                return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+            }
+    
+            void deallocate (T* ptr, std::size_t n)
+            {
+                resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+            }
+    
+            template <typename U>
+            bool operator== (const Allocator<U>& rhs) const noexcept
+            {
+                return resource_ == rhs.resource_;
+            }
+    
+            template <typename U>
+            bool operator!= (const Allocator<U>& rhs) const noexcept
+            {
+                return resource_ != rhs.resource_;
+            }
+    
+            type_erasure::memory_resource* resource_;
+        };
+    
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename T>
+        T& value_of ()
+        {
+            return static_cast<Handle<T>*>(handle_.get())->value_;
+        }
+    
+        struct HandleBase
+        {
+            virtual ~HandleBase () {}
+            virtual const void* type_id () const noexcept = 0;
+            virtual std::shared_ptr<HandleBase> clone (type_erasure::memory_resource* resource) const = 0;
+    
+            virtual int foo ( ) const = 0;
+            virtual void set_value ( int value ) = 0;
+        };
+    
+        template <typename T>
+        struct Handle : HandleBase
+        {
+            template <typename U,
+                      typename std::enable_if<
+                          !std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle( U&& value ) noexcept
+                : value_( value )
+            {}
+    
+            template <typename U,
+                      typename std::enable_if<
+                          std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle( U&& value ) noexcept ( std::is_rvalue_reference<U>::value &&
+                                                    std::is_nothrow_move_constructible<typename std::decay<U>::type>::value )
+                : value_( std::forward<U>(value) )
+            {}
+    
+            template <typename... Args>
+            explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+                : value_( std::forward<Args>(args)... )
+            {}
+    
+            virtual std::shared_ptr<HandleBase> clone (type_erasure::memory_resource* resource) const
+            {
+                return std::allocate_shared<Handle>(Allocator<Handle>(resource), value_);
+            }
+    
+            virtual const void* type_id () const noexcept
+            {
+                return Fooable::type_id<T>();
+            }
+    
+            virtual int foo ( ) const {
+                return value_.foo( );
+            }
+            virtual void set_value ( int value ) {
+                value_.set_value(value );
+            }
+    
+            T value_;
+        };
+    
+        template <typename T>
+        struct Handle< std::reference_wrapper<T> > : Handle<T&>
+        {
+            Handle (std::reference_wrapper<T> ref)
+                : Handle<T&> (ref.get())
+            {}
+        };
+    
+        const HandleBase& read () const
+        {
+            return *handle_;
+        }
+    
+        HandleBase& write ()
+        {
+            if (!handle_.unique())
+                handle_ = handle_->clone(resource_);
+            return *handle_;
+        }
+    
+        type_erasure::memory_resource* resource_ = type_erasure::default_resource();
+        std::shared_ptr<HandleBase> handle_;
+    };
+    
+    // Constructs a T from args in place, in a new Fooable.  A leading
+    // memory_resource* is used for the object's allocations instead.
+    template <typename T, typename... Args>
+    Fooable make_fooable (Args&&... args)
+    {
+        return Fooable(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
+
+}
+#endif
+
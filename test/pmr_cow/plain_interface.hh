@@ -0,0 +1,13 @@
+#ifndef PMR_COW_FOOABLE_HH
+#define PMR_COW_FOOABLE_HH
+
+namespace PMRCOW
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+
+#include "interface.hh"
+#include "../mock_fooable.hh"
+#include "../counting_resource.hh"
+
+namespace
+{
+    using PMRCOW::Fooable;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::CountingResource;
+
+    void death_tests( Fooable& fooable )
+    {
+#ifndef NDEBUG
+        EXPECT_DEATH( fooable.foo(), "" );
+        EXPECT_DEATH( fooable.set_value( Mock::other_value ), "" );
+#endif
+    }
+
+    void test_interface( Fooable& fooable, int initial_value, int new_value )
+    {
+        EXPECT_EQ( fooable.foo(), initial_value );
+        fooable.set_value( new_value );
+        EXPECT_EQ( fooable.foo(), new_value );
+    }
+
+    void test_ref_interface( Fooable& fooable, const MockFooable& mock_fooable,
+                             int new_value )
+    {
+        test_interface(fooable, mock_fooable.foo(), new_value);
+        EXPECT_EQ( mock_fooable.foo(), new_value );
+    }
+
+    void test_copies( Fooable& copy, const Fooable& fooable, int new_value )
+    {
+        auto value = fooable.foo();
+        test_interface( copy, value, new_value );
+        EXPECT_EQ( fooable.foo(), value );
+        ASSERT_NE( value, new_value );
+        EXPECT_NE( fooable.foo(), copy.foo() );
+    }
+}
+
+TEST( TestPMRCOWFooable, Empty )
+{
+    Fooable fooable;
+    death_tests(fooable);
+
+    Fooable copy(fooable);
+    death_tests(copy);
+
+    Fooable move( std::move(fooable) );
+    death_tests(move);
+
+    Fooable copy_assign;
+    copy_assign = move;
+    death_tests(copy_assign);
+
+    Fooable move_assign;
+    move_assign = std::move(fooable);
+    death_tests(move_assign);
+}
+
+TEST( TestPMRCOWFooable, CopyFromValue )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+TEST( TestPMRCOWFooable, CopyConstruction )
+{
+    Fooable fooable = MockFooable();
+    Fooable other( fooable );
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestPMRCOWFooable, CopyFromValueWithReferenceWrapper )
+{
+    MockFooable mock_fooable;
+    Fooable fooable( std::ref(mock_fooable) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestPMRCOWFooable, MoveFromValue )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+TEST( TestPMRCOWFooable, MoveConstruction )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestPMRCOWFooable, MoveFromValueWithReferenceWrapper )
+{
+    MockFooable mock_fooable;
+    Fooable fooable( std::move(std::ref(mock_fooable)) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestPMRCOWFooable, CopyAssignFromValue )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = mock_fooable;
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestPMRCOWFooable, CopyAssignment )
+{
+    Fooable fooable = MockFooable();
+    Fooable other;
+    other = fooable;
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestPMRCOWFooable, CopyAssignFromValueWithReferenceWrapper )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::ref(mock_fooable);
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestPMRCOWFooable, MoveAssignFromValue )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = std::move(mock_fooable);
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestPMRCOWFooable, MoveAssignment )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other;
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestPMRCOWFooable, MoveAssignFromValueWithReferenceWrapper )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::move(std::ref(mock_fooable));
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestPMRCOWFooable, Cast )
+{
+    Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::value );
+}
+
+TEST( TestPMRCOWFooable, ConstCast )
+{
+    const Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::value );
+}
+
+TEST( TestPMRCOWFooable, DefaultResource )
+{
+    Fooable fooable;
+    EXPECT_EQ( fooable.resource(), type_erasure::default_resource() );
+
+    Fooable other = MockFooable();
+    EXPECT_EQ( other.resource(), type_erasure::default_resource() );
+}
+
+TEST( TestPMRCOWFooable, Resource )
+{
+    CountingResource resource;
+    {
+        Fooable fooable( MockLargeFooable(), &resource );
+        EXPECT_EQ( fooable.resource(), &resource );
+        EXPECT_EQ( resource.allocations, 1u );
+
+        Fooable copy( fooable );
+        EXPECT_EQ( copy.resource(), &resource );
+        EXPECT_EQ( resource.allocations, 1u );
+
+        copy.set_value( Mock::other_value );
+        EXPECT_EQ( resource.allocations, 2u );
+        EXPECT_EQ( fooable.foo(), Mock::value );
+        EXPECT_EQ( copy.foo(), Mock::other_value );
+
+        Fooable assigned;
+        assigned = copy;
+        EXPECT_EQ( assigned.resource(), &resource );
+        assigned.set_value( Mock::value );
+        EXPECT_EQ( resource.allocations, 3u );
+    }
+    EXPECT_EQ( resource.deallocations, resource.allocations );
+    EXPECT_EQ( resource.bytes_in_use, 0u );
+}
+
+TEST( TestPMRCOWFooable, Resource_AssignFromValue )
+{
+    CountingResource resource;
+    {
+        Fooable fooable( &resource );
+        fooable = MockFooable();
+        EXPECT_EQ( fooable.resource(), &resource );
+        EXPECT_EQ( resource.allocations, 1u );
+    }
+    EXPECT_EQ( resource.bytes_in_use, 0u );
+}
+
+TEST( TestPMRCOWFooable, InPlace )
+{
+    using Mock::MockValueFooable;
+    MockValueFooable::transfers() = 0;
+
+    Fooable fooable( type_erasure::in_place_type_t<MockValueFooable>(), Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    MockValueFooable& value = fooable.emplace<MockValueFooable>( Mock::value );
+    EXPECT_EQ( &value, fooable.cast<MockValueFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    Fooable made = PMRCOW::make_fooable<MockValueFooable>( Mock::other_value );
+    EXPECT_EQ( made.foo(), Mock::other_value );
+    EXPECT_EQ( MockValueFooable::transfers(), 0 );
+}
+
+TEST( TestPMRCOWFooable, InPlace_Resource )
+{
+    CountingResource resource;
+    {
+        Fooable fooable{ type_erasure::in_place_type_t<MockFooable>(), &resource };
+        EXPECT_EQ( fooable.resource(), &resource );
+        EXPECT_EQ( fooable.foo(), Mock::value );
+        EXPECT_EQ( resource.allocations, 1u );
+
+        Fooable made =
+            PMRCOW::make_fooable<Mock::MockValueFooable>( &resource, Mock::other_value );
+        EXPECT_EQ( made.resource(), &resource );
+        EXPECT_EQ( made.foo(), Mock::other_value );
+        EXPECT_EQ( resource.allocations, 2u );
+    }
+    EXPECT_EQ( resource.deallocations, resource.allocations );
+    EXPECT_EQ( resource.bytes_in_use, 0u );
+}
@@ -0,0 +1,906 @@
+#ifndef PMR_SBO_FOOABLE_HH
+#define PMR_SBO_FOOABLE_HH
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#define alignof __alignof
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT alignof(void*)
+#endif
+
+#ifndef TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+#define TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+namespace type_erasure
+{
+    // Values of types for which this is true are moved by copying their bytes,
+    // without calling the move constructor or the destructor.  True for
+    // trivially copyable types; specialize it for other types that allow this.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T>
+    {};
+}
+#endif
+
+#ifndef TYPE_ERASURE_MEMORY_RESOURCE
+#define TYPE_ERASURE_MEMORY_RESOURCE
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#define TYPE_ERASURE_STD_PMR
+#endif
+#endif
+
+#ifdef TYPE_ERASURE_STD_PMR
+#include <memory_resource>
+
+namespace type_erasure
+{
+    using memory_resource = std::pmr::memory_resource;
+
+    inline memory_resource* default_resource () noexcept
+    {
+        return std::pmr::get_default_resource();
+    }
+}
+#else
+namespace type_erasure
+{
+    // The part of C++17's std::pmr::memory_resource used by the erased types.
+    // With C++17, this is std::pmr::memory_resource itself.
+    class memory_resource
+    {
+    public:
+        virtual ~memory_resource () {}
+
+        void* allocate (std::size_t bytes,
+                        std::size_t alignment = alignof(std::max_align_t))
+        {
+            return do_allocate(bytes, alignment);
+        }
+
+        void deallocate (void* ptr, std::size_t bytes,
+                         std::size_t alignment = alignof(std::max_align_t))
+        {
+            do_deallocate(ptr, bytes, alignment);
+        }
+
+        bool is_equal (const memory_resource& other) const noexcept
+        {
+            return do_is_equal(other);
+        }
+
+    private:
+        virtual void* do_allocate (std::size_t bytes, std::size_t alignment) = 0;
+        virtual void do_deallocate (void* ptr, std::size_t bytes, std::size_t alignment) = 0;
+        virtual bool do_is_equal (const memory_resource& other) const noexcept = 0;
+    };
+
+    // Uses the global operator new and operator delete.
+    inline memory_resource* default_resource () noexcept
+    {
+        struct new_delete_resource : memory_resource
+        {
+            void* do_allocate (std::size_t bytes, std::size_t alignment) override
+            {
+                assert(alignment <= alignof(std::max_align_t));
+                return ::operator new(bytes);
+            }
+
+            void do_deallocate (void* ptr, std::size_t, std::size_t) override
+            {
+                ::operator delete(ptr);
+            }
+
+            bool do_is_equal (const memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+        static new_delete_resource resource;
+        return &resource;
+    }
+}
+#endif
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
+
+#ifndef TYPE_ERASURE_LEADS_WITH_RESOURCE
+#define TYPE_ERASURE_LEADS_WITH_RESOURCE
+namespace type_erasure
+{
+    // Whether the first of Args is a memory_resource*.  Such arguments select
+    // the in-place constructors that take a resource, so that it is never
+    // passed on to the constructor of the stored type.
+    template <typename... Args>
+    struct leads_with_resource : std::false_type
+    {};
+
+    template <typename Arg, typename... Args>
+    struct leads_with_resource<Arg, Args...> : std::is_convertible<Arg, memory_resource*>
+    {};
+}
+#endif
+
+#ifndef TYPE_ERASURE_POOL_RESOURCE
+#define TYPE_ERASURE_POOL_RESOURCE
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace type_erasure
+{
+    // A memory_resource that keeps one free list per size class, and recycles
+    // freed blocks instead of returning them to its upstream resource.  Blocks
+    // of up to max_block_size() bytes are carved out of chunks allocated from
+    // upstream; larger or over-aligned requests go to upstream directly.
+    // release() returns all chunks to upstream at once, and so must only be
+    // called when no block handed out by the pool is in use anymore.  Not
+    // thread safe; see thread_local_pool_resource().
+    class pool_resource : public memory_resource
+    {
+    public:
+        explicit pool_resource (memory_resource* upstream = default_resource()) noexcept :
+            upstream_ (upstream)
+        {}
+
+        pool_resource (const pool_resource&) = delete;
+        pool_resource& operator= (const pool_resource&) = delete;
+
+        ~pool_resource ()
+        {
+            release();
+        }
+
+        void release () noexcept
+        {
+            while (chunks_) {
+                Chunk* const next = chunks_->next;
+                upstream_->deallocate(chunks_, chunk_size, granularity);
+                chunks_ = next;
+            }
+            for (Block*& free_list : free_lists_) {
+                free_list = nullptr;
+            }
+        }
+
+        memory_resource* upstream_resource () const noexcept
+        {
+            return upstream_;
+        }
+
+        static constexpr std::size_t max_block_size ()
+        {
+            return max_size;
+        }
+
+        static constexpr std::size_t chunk_bytes ()
+        {
+            return chunk_size;
+        }
+
+    private:
+        enum : std::size_t {
+            granularity = alignof(std::max_align_t),
+            max_size = 256,
+            chunk_size = 16384,
+            size_classes = max_size / granularity
+        };
+
+        struct Block
+        {
+            Block* next;
+        };
+
+        // Stored at the start of each chunk, in front of its first block.
+        struct Chunk
+        {
+            Chunk* next;
+        };
+
+        static bool pooled (std::size_t bytes, std::size_t alignment) noexcept
+        {
+            return bytes <= max_size && alignment <= granularity;
+        }
+
+        static std::size_t size_class (std::size_t bytes) noexcept
+        {
+            return bytes ? (bytes - 1) / granularity : 0;
+        }
+
+        void* do_allocate (std::size_t bytes, std::size_t alignment) override
+        {
+            if (!pooled(bytes, alignment))
+                return upstream_->allocate(bytes, alignment);
+
+            Block*& free_list = free_lists_[size_class(bytes)];
+            if (!free_list)
+                refill(size_class(bytes));
+
+            Block* const block = free_list;
+            free_list = block->next;
+            return block;
+        }
+
+        void do_deallocate (void* ptr, std::size_t bytes, std::size_t alignment) override
+        {
+            if (!pooled(bytes, alignment)) {
+                upstream_->deallocate(ptr, bytes, alignment);
+                return;
+            }
+
+            Block*& free_list = free_lists_[size_class(bytes)];
+            free_list = new (ptr) Block{free_list};
+        }
+
+        bool do_is_equal (const memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        // Carves a new chunk into blocks of the given size class.
+        void refill (std::size_t size_class)
+        {
+            unsigned char* const chunk = static_cast<unsigned char*>(
+                upstream_->allocate(chunk_size, granularity)
+            );
+            chunks_ = new (chunk) Chunk{chunks_};
+
+            const std::size_t block_size = (size_class + 1) * granularity;
+            Block*& free_list = free_lists_[size_class];
+            for (std::size_t offset = granularity;
+                 offset + block_size <= chunk_size;
+                 offset += block_size) {
+                free_list = new (chunk + offset) Block{free_list};
+            }
+        }
+
+        memory_resource* upstream_;
+        Block* free_lists_[size_classes] = {};
+        Chunk* chunks_ = nullptr;
+    };
+
+    // What thread_local_pool_resource() keeps for one thread: its pool, and
+    // the blocks other threads have freed.  Those are pushed onto a lock-free
+    // list, which the owning thread moves into its pool on its next
+    // allocation.  Each block records its owner in front of the bytes handed
+    // out.  The state outlives its thread for as long as any of its blocks
+    // are in use; whichever thread frees the last one deletes it.
+    class thread_local_pool_state
+    {
+    public:
+        thread_local_pool_state (const thread_local_pool_state&) = delete;
+        thread_local_pool_state& operator= (const thread_local_pool_state&) = delete;
+
+        // The calling thread's state, created on first use.
+        static thread_local_pool_state& current ()
+        {
+            static thread_local Owner owner;
+            return *owner.state;
+        }
+
+        // Returns all of the pool's chunks to upstream at once.  Blocks that
+        // other threads have freed are dropped first, since they live in
+        // those chunks.  Must be called on the owning thread, once no block
+        // from the pool is in use on any thread.
+        void release () noexcept
+        {
+            remote_frees_.store(nullptr, std::memory_order_relaxed);
+            pool_.release();
+        }
+
+        // Must be called on the owning thread.
+        void* allocate (std::size_t bytes, std::size_t alignment)
+        {
+            drain();
+
+            const std::size_t header = header_size(alignment);
+            unsigned char* const payload = static_cast<unsigned char*>(
+                pool_.allocate(block_size(bytes, alignment), alignment)
+            ) + header;
+            new (payload - sizeof(thread_local_pool_state*)) thread_local_pool_state*(this);
+            users_.fetch_add(1, std::memory_order_relaxed);
+            return payload;
+        }
+
+        // May be called on any thread.
+        static void deallocate (void* ptr, std::size_t bytes, std::size_t alignment)
+        {
+            unsigned char* const payload = static_cast<unsigned char*>(ptr);
+            const std::size_t header = header_size(alignment);
+            thread_local_pool_state* const owner =
+                *reinterpret_cast<thread_local_pool_state**>(payload - sizeof(thread_local_pool_state*));
+
+            if (owner == running()) {
+                owner->pool_.deallocate(payload - header, block_size(bytes, alignment), alignment);
+                owner->users_.fetch_sub(1, std::memory_order_relaxed);
+            } else {
+                owner->free_remote(payload - header, block_size(bytes, alignment), alignment);
+            }
+        }
+
+    private:
+        // A block freed by another thread than its owner.
+        struct RemoteBlock
+        {
+            RemoteBlock* next;
+            std::size_t bytes;
+            std::size_t alignment;
+        };
+
+        // Ends the owning thread's use of the state.
+        struct Owner
+        {
+            Owner () :
+                state (new thread_local_pool_state)
+            {
+                running() = state;
+            }
+
+            ~Owner ()
+            {
+                running() = nullptr;
+                state->release_user();
+            }
+
+            thread_local_pool_state* state;
+        };
+
+        thread_local_pool_state () = default;
+
+        // The state of the calling thread, or null once that thread is ending.
+        // A plain pointer, so it can still be read while thread_local objects
+        // are being destroyed.
+        static thread_local_pool_state*& running () noexcept
+        {
+            static thread_local thread_local_pool_state* state = nullptr;
+            return state;
+        }
+
+        // Room for the owner in front of the bytes handed out, keeping them
+        // aligned.
+        static std::size_t header_size (std::size_t alignment) noexcept
+        {
+            return alignof(std::max_align_t) < alignment ? alignment : alignof(std::max_align_t);
+        }
+
+        // The whole block, which becomes a RemoteBlock if another thread
+        // frees it.
+        static std::size_t block_size (std::size_t bytes, std::size_t alignment) noexcept
+        {
+            return header_size(alignment) + bytes < sizeof(RemoteBlock) ?
+                sizeof(RemoteBlock) : header_size(alignment) + bytes;
+        }
+
+        void free_remote (void* block, std::size_t bytes, std::size_t alignment) noexcept
+        {
+            RemoteBlock* const remote = new (block) RemoteBlock{
+                remote_frees_.load(std::memory_order_relaxed), bytes, alignment
+            };
+            while (!remote_frees_.compare_exchange_weak(remote->next, remote,
+                                                        std::memory_order_release,
+                                                        std::memory_order_relaxed)) {
+            }
+            release_user();
+        }
+
+        void drain () noexcept
+        {
+            if (!remote_frees_.load(std::memory_order_relaxed))
+                return;
+
+            RemoteBlock* remote = remote_frees_.exchange(nullptr, std::memory_order_acquire);
+            while (remote) {
+                RemoteBlock* const next = remote->next;
+                pool_.deallocate(remote, remote->bytes, remote->alignment);
+                remote = next;
+            }
+        }
+
+        void release_user () noexcept
+        {
+            if (users_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                drain();
+                delete this;
+            }
+        }
+
+        pool_resource pool_;
+        std::atomic<RemoteBlock*> remote_frees_{nullptr};
+        // The owning thread while it runs, plus each block in use.
+        std::atomic<std::size_t> users_{1};
+    };
+
+    // The calling thread's pool.  Call release() on it to free everything it
+    // holds at once, once no block from it is in use on any thread.
+    inline thread_local_pool_state& thread_local_pool () noexcept
+    {
+        return thread_local_pool_state::current();
+    }
+
+    // Allocates from thread_local_pool() of the calling thread, so allocation
+    // takes no locks.  A block may be freed on any thread: one freed by
+    // another thread than the one that allocated it goes back to its own
+    // pool, which lives on after its thread ends until all of its blocks
+    // have been freed.
+    inline memory_resource* thread_local_pool_resource () noexcept
+    {
+        struct thread_local_pool_dispatch : memory_resource
+        {
+            void* do_allocate (std::size_t bytes, std::size_t alignment) override
+            {
+                return thread_local_pool_state::current().allocate(bytes, alignment);
+            }
+
+            void do_deallocate (void* ptr, std::size_t bytes, std::size_t alignment) override
+            {
+                thread_local_pool_state::deallocate(ptr, bytes, alignment);
+            }
+
+            bool do_is_equal (const memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+        static thread_local_pool_dispatch resource;
+        return &resource;
+    }
+}
+#endif
+
+
+namespace PMRSBO {
+    
+    class Fooable
+    {
+        public:
+        // Contructors
+        Fooable () = default;
+    
+        explicit Fooable (type_erasure::memory_resource* resource) noexcept :
+            resource_ (resource)
+        {}
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value &&
+                      !std::is_convertible< T, type_erasure::memory_resource* >::value
+                      >::type* = nullptr>
+        Fooable (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                             std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            handle_ = clone_impl( std::forward<T>(value), buffer_, resource_ );
+        }
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable (T&& value, type_erasure::memory_resource* resource) :
+            resource_ (resource)
+        {
+            handle_ = clone_impl( std::forward<T>(value), buffer_, resource_ );
+        }
+    
+        // Constructs a T from args in place.
+        template <typename T, typename... Args,
+                  typename std::enable_if<
+                      !type_erasure::leads_with_resource<Args...>::value
+                      >::type* = nullptr>
+        explicit Fooable (type_erasure::in_place_type_t<T>, Args&&... args)
+        {
+            handle_ = emplace_impl<T>(buffer_, resource_, type_erasure::in_place_type_t<T>(),
+                                      std::forward<Args>(args)...);
+        }
+    
+        template <typename T, typename... Args>
+        Fooable (type_erasure::in_place_type_t<T>, type_erasure::memory_resource* resource,
+                       Args&&... args) :
+            resource_ (resource)
+        {
+            handle_ = emplace_impl<T>(buffer_, resource_, type_erasure::in_place_type_t<T>(),
+                                      std::forward<Args>(args)...);
+        }
+    
+        // Copies use the resource of rhs.
+        Fooable (const Fooable& rhs) :
+            resource_ (rhs.resource_)
+        {
+            if (rhs.handle_)
+                handle_ = rhs.handle_->clone_into(buffer_, resource_);
+        }
+    
+        Fooable (Fooable&& rhs) noexcept
+        {
+            move_from(rhs);
+        }
+    
+        // Assignment
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                        std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            reset();
+            handle_ = clone_impl(std::forward<T>(value), buffer_, resource_);
+            return *this;
+        }
+    
+        Fooable& operator= (const Fooable& rhs)
+        {
+            Fooable temp(rhs);
+            reset();
+            move_from(temp);
+            return *this;
+        }
+    
+        Fooable& operator= (Fooable&& rhs) noexcept
+        {
+            if (this != &rhs) {
+                reset();
+                move_from(rhs);
+            }
+            return *this;
+        }
+    
+        ~Fooable ()
+        {
+            reset();
+        }
+    
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.
+        template <typename T, typename... Args>
+        T& emplace (Args&&... args)
+        {
+            reset();
+            handle_ = emplace_impl<T>(buffer_, resource_, type_erasure::in_place_type_t<T>(),
+                                      std::forward<Args>(args)...);
+            return value_of<T>();
+        }
+    
+        template <typename T>
+        T* cast()
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+        }
+    
+        template <typename T>
+        const T* cast() const
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+        }
+    
+        // Calls f(value) on the stored value if its type is one of those given to
+        // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+        // looked up once, so the calls f makes on value can be inlined.
+        template <typename F>
+        auto visit (F&& f) -> decltype(f(std::declval<Fooable&>()))
+        {
+            assert(handle_);
+            return visit_impl(f, *this, handle_->type_id(), VisitTypes<>());
+        }
+    
+        template <typename F>
+        auto visit (F&& f) const -> decltype(f(std::declval<const Fooable&>()))
+        {
+            assert(handle_);
+            return visit_impl(f, *this, handle_->type_id(), VisitTypes<>());
+        }
+    
+        // The resource that values which do not fit the buffer are allocated
+        // from.  It goes along with the value on copies, moves and assignments.
+        type_erasure::memory_resource* resource () const noexcept
+        {
+            return resource_;
+        }
+    
+        // The small buffer, and what fits in it.  inline_capacity() is the size of
+        // the largest pointer-aligned value that is stored in the buffer instead
+        // of on the heap, provided it can be moved without throwing or is
+        // trivially relocatable.
+        static constexpr std::size_t buffer_size ()
+        {
+            return sizeof(Buffer);
+        }
+    
+        static constexpr std::size_t buffer_alignment ()
+        {
+            return alignof(Buffer);
+        }
+    
+        static constexpr std::size_t inline_capacity ()
+        {
+            return sizeof(Buffer) - sizeof(HandleBase);
+        }
+    
+        template <typename T>
+        static constexpr bool stored_inline ()
+        {
+            return sizeof(Handle<typename std::decay<T>::type, false>) <= sizeof(Buffer) &&
+                   alignof(Handle<typename std::decay<T>::type, false>) <= alignof(Buffer) &&
+                   (std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ||
+                    type_erasure::is_trivially_relocatable<typename std::decay<T>::type>::value);
+        }
+    
+        int foo ( ) const
+        {
+                assert(handle_);
+                return handle_->foo( );
+        }
+        void set_value ( int value )
+        {
+                assert(handle_);
+                handle_->set_value(value );
+        }
+    
+        private:
+            using Buffer = typename std::aligned_storage<SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE, SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT>::type;
+    
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename... Ts>
+        struct VisitTypes
+        {};
+    
+        template <typename F, typename Self>
+        static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+        {
+            return f(self);
+        }
+    
+        template <typename F, typename Self, typename T, typename... Ts>
+        static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+        {
+            if (id == type_id<T>())
+                return f(self.template value_of<T>());
+            return visit_impl(f, self, id, VisitTypes<Ts...>());
+        }
+    
+        template <typename T>
+        T& value_of ()
+        {
+            return static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+        }
+    
+        template <typename T>
+        const T& value_of () const
+        {
+            return static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+        }
+    
+        struct HandleBase
+        {
+            virtual ~HandleBase () {}
+            virtual const void* type_id () const noexcept = 0;
+            virtual HandleBase* clone_into (Buffer& buffer,
+                                            type_erasure::memory_resource* resource) const = 0;
+            virtual HandleBase* move_into (Buffer& buffer) noexcept = 0;
+            virtual void destroy (type_erasure::memory_resource* resource) = 0;
+    
+            virtual int foo ( ) const = 0;
+            virtual void set_value ( int value ) = 0;
+        };
+    
+        template <typename T, bool HeapAllocated>
+        struct Handle : HandleBase
+        {
+            template <typename U,
+                      typename std::enable_if<
+                          !std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle(U&& value) noexcept :
+                value_( value )
+            {}
+    
+            template <typename U,
+                      typename std::enable_if<
+                          std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle(U&& value) noexcept ( std::is_rvalue_reference<U>::value &&
+                                                  std::is_nothrow_move_constructible<typename std::decay<U>::type>::value ) :
+                value_( std::forward<U>(value) )
+            {}
+    
+            template <typename... Args>
+            explicit Handle(type_erasure::in_place_type_t<T>, Args&&... args) :
+                value_( std::forward<Args>(args)... )
+            {}
+    
+            virtual HandleBase* clone_into (Buffer& buffer,
+                                            type_erasure::memory_resource* resource) const
+            {
+                return clone_impl(value_, buffer, resource);
+            }
+    
+            virtual HandleBase* move_into (Buffer& buffer) noexcept
+            {
+                return relocate(this, buffer);
+            }
+    
+            virtual void destroy (type_erasure::memory_resource* resource)
+            {
+                this->~Handle();
+                if (HeapAllocated)
+                    resource->deallocate(this, sizeof(Handle), alignof(Handle));
+            }
+    
+            virtual const void* type_id () const noexcept
+            {
+                return Fooable::type_id<T>();
+            }
+    
+            virtual int foo ( ) const {
+                return value_.foo( );
+            }
+            virtual void set_value ( int value ) {
+                value_.set_value(value );
+            }
+    
+            T value_;
+        };
+    
+        template <typename T, bool HeapAllocated>
+        struct Handle<std::reference_wrapper<T>, HeapAllocated> : Handle<T&, HeapAllocated>
+        {
+            Handle (std::reference_wrapper<T> ref) :
+                Handle<T&, HeapAllocated> (ref.get())
+            {}
+        };
+    
+        template <typename T>
+        static HandleBase* clone_impl (T&& value, Buffer& buffer,
+                                       type_erasure::memory_resource* resource)
+        {
+            return emplace_impl<typename std::decay<T>::type>(buffer, resource,
+                                                              std::forward<T>(value));
+        }
+    
+        // Constructs a handle for a T from args, in buffer if a T fits there,
+        // and otherwise in memory from resource.
+        template <typename T, typename... Args>
+        static HandleBase* emplace_impl (Buffer& buffer, type_erasure::memory_resource* resource,
+                                         Args&&... args)
+        {
+            using HeapHandle = Handle<T, true>;
+    
+            void* buf_ptr = get_buffer_ptr<T>(buffer);
+            if (buf_ptr) {
+                new (buf_ptr) Handle<T, false>( std::forward<Args>(args)... );
+                return static_cast<HandleBase*>(buf_ptr);
+            }
+    
+            void* heap_ptr = resource->allocate(sizeof(HeapHandle), alignof(HeapHandle));
+            try {
+                return new (heap_ptr) HeapHandle( std::forward<Args>(args)... );
+            } catch (...) {
+                resource->deallocate(heap_ptr, sizeof(HeapHandle), alignof(HeapHandle));
+                throw;
+            }
+        }
+    
+        // Heap handles are passed over, inline handles move to the new buffer.
+        template <typename T>
+        static HandleBase* relocate (Handle<T, true>* handle, Buffer&) noexcept
+        {
+            return handle;
+        }
+    
+        template <typename T>
+        static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer) noexcept
+        {
+            return relocate(handle, buffer, type_erasure::is_trivially_relocatable<T>());
+        }
+    
+        template <typename T>
+        static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                     std::true_type) noexcept
+        {
+            std::memcpy(static_cast<void*>(&buffer), static_cast<void*>(handle),
+                        sizeof(Handle<T, false>));
+            return static_cast<Handle<T, false>*>(static_cast<void*>(&buffer));
+        }
+    
+        template <typename T>
+        static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                     std::false_type) noexcept
+        {
+            HandleBase* const moved =
+                new (&buffer) Handle<T, false>( std::move(handle->value_) );
+            handle->~Handle();
+            return moved;
+        }
+    
+        // Expects this to be empty, and leaves rhs empty.  Heap handles stay
+        // with the resource they were allocated from.
+        void move_from (Fooable& rhs) noexcept
+        {
+            if (rhs.handle_)
+                handle_ = rhs.handle_->move_into(buffer_);
+            rhs.handle_ = nullptr;
+            resource_ = rhs.resource_;
+        }
+    
+        void reset ()
+        {
+            if (handle_)
+                handle_->destroy(resource_);
+            handle_ = nullptr;
+        }
+    
+        template <class T>
+        static void* get_buffer_ptr(Buffer& buffer)
+        {
+            return stored_inline<T>() ? &buffer : nullptr;
+        }
+    
+        HandleBase* handle_ = nullptr;
+        Buffer buffer_;
+        type_erasure::memory_resource* resource_ = type_erasure::default_resource();
+    };
+    
+    // Constructs a T from args in place, in a new Fooable.  A leading
+    // memory_resource* is used for the object's allocations instead.
+    template <typename T, typename... Args>
+    Fooable make_fooable (Args&&... args)
+    {
+        return Fooable(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
+
+}
+#endif
+
@@ -0,0 +1,13 @@
+#ifndef PMR_SBO_FOOABLE_HH
+#define PMR_SBO_FOOABLE_HH
+
+namespace PMRSBO
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
@@ -0,0 +1,519 @@
+#include <gtest/gtest.h>
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "interface.hh"
+#include "../mock_fooable.hh"
+#include "../counting_resource.hh"
+
+
+namespace
+{
+    using PMRSBO::Fooable;
+    using Mock::MockFooable;
+    using Mock::CountingResource;
+    using Mock::MockLargeFooable;
+    using Mock::MockRelocatableFooable;
+    using Mock::MockNonTrivialFooable;
+
+    void death_tests( Fooable& fooable )
+    {
+#ifndef NDEBUG
+        EXPECT_DEATH( fooable.foo(), "" );
+        EXPECT_DEATH( fooable.set_value( Mock::other_value ), "" );
+#endif
+    }
+
+    void test_interface( Fooable& fooable, int initial_value, int new_value )
+    {
+        EXPECT_EQ( fooable.foo(), initial_value );
+        fooable.set_value( new_value );
+        EXPECT_EQ( fooable.foo(), new_value );
+    }
+
+    void test_ref_interface( Fooable& fooable, const MockFooable& mock_fooable,
+                             int new_value )
+    {
+        test_interface(fooable, mock_fooable.foo(), new_value);
+        EXPECT_EQ( mock_fooable.foo(), new_value );
+    }
+
+    void test_copies( Fooable& copy, const Fooable& fooable, int new_value )
+    {
+        auto value = fooable.foo();
+        test_interface( copy, value, new_value );
+        EXPECT_EQ( fooable.foo(), value );
+        ASSERT_NE( value, new_value );
+        EXPECT_NE( fooable.foo(), copy.foo() );
+    }
+}
+
+
+TEST( TestPMRSBOFooable, Empty )
+{
+    Fooable fooable;
+    death_tests(fooable);
+
+    Fooable copy(fooable);
+    death_tests(copy);
+
+    Fooable move( std::move(fooable) );
+    death_tests(move);
+
+    Fooable copy_assign;
+    copy_assign = move;
+    death_tests(copy_assign);
+
+    Fooable move_assign;
+    move_assign = std::move(fooable);
+    death_tests(move_assign);
+}
+
+
+TEST( TestPMRSBOFooable, CopyFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+TEST( TestPMRSBOFooable, CopyFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, CopyConstruction_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    Fooable other( fooable );
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestPMRSBOFooable, CopyConstruction_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    Fooable other( fooable );
+    test_copies( other, fooable, Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, CopyFromValueWithReferenceWrapper_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable( std::ref(mock_fooable) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, CopyFromValueWithReferenceWrapper_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable( std::ref(mock_fooable) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, MoveFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+TEST( TestPMRSBOFooable, MoveFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, MoveConstruction_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestPMRSBOFooable, MoveConstruction_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+
+TEST( TestPMRSBOFooable, MoveFromValueWithReferenceWrapper_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable( std::move(std::ref(mock_fooable)) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestPMRSBOFooable, MoveFromValueWithReferenceWrapper_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable( std::move(std::ref(mock_fooable)) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, CopyAssignFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = mock_fooable;
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestPMRSBOFooable, CopyAssignFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = mock_fooable;
+    test_interface(fooable, value, Mock::other_value);
+}
+
+
+TEST( TestPMRSBOFooable, CopyAssignment_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    Fooable other;
+    other = fooable;
+    test_copies( other, fooable, Mock::other_value );
+}
+
+TEST( TestPMRSBOFooable, CopyAssignment_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    Fooable other;
+    other = fooable;
+    test_copies( other, fooable, Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, CopyAssignFromValueWithReferenceWrapper_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::ref(mock_fooable);
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestPMRSBOFooable, CopyAssignFromValueWithReferenceWrapper_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::ref(mock_fooable);
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, MoveAssignFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = std::move(mock_fooable);
+    test_interface(fooable, value, Mock::other_value);
+}
+
+TEST( TestPMRSBOFooable, MoveAssignFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    auto value = mock_fooable.foo();
+    fooable = std::move(mock_fooable);
+    test_interface(fooable, value, Mock::other_value);
+}
+
+
+TEST( TestPMRSBOFooable, MoveAssignment_SmallObject )
+{
+    Fooable fooable = MockFooable();
+    auto value = fooable.foo();
+    Fooable other;
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestPMRSBOFooable, MoveAssignment_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+    auto value = fooable.foo();
+    Fooable other;
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+
+TEST( TestPMRSBOFooable, MoveAssignFromValueWithReferenceWrapper_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::move(std::ref(mock_fooable));
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestPMRSBOFooable, MoveAssignFromValueWithReferenceWrapper_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable;
+
+    fooable = std::move(std::ref(mock_fooable));
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, Cast_SmallObject )
+{
+    Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+
+    fooable.set_value(Mock::other_value);
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::other_value );
+}
+
+TEST( TestPMRSBOFooable, Cast_LargeObject )
+{
+    Fooable fooable = MockLargeFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockLargeFooable>() == nullptr );
+
+    fooable.set_value(Mock::other_value);
+    EXPECT_EQ( fooable.cast<MockLargeFooable>()->foo(), Mock::other_value );
+}
+
+
+TEST( TestPMRSBOFooable, ConstCast_SmallObject )
+{
+    const Fooable fooable = MockFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockFooable>() == nullptr );
+
+    EXPECT_EQ( fooable.cast<MockFooable>()->foo(), Mock::value );
+}
+
+TEST( TestPMRSBOFooable, ConstCast_LargeObject )
+{
+    const Fooable fooable = MockLargeFooable();
+
+    EXPECT_TRUE( fooable.cast<int>() == nullptr );
+    ASSERT_FALSE( fooable.cast<MockLargeFooable>() == nullptr );
+
+    EXPECT_EQ( fooable.cast<MockLargeFooable>()->foo(), Mock::value );
+}
+
+
+TEST( TestPMRSBOFooable, BufferConfiguration )
+{
+    EXPECT_EQ( Fooable::buffer_size(), 24u );
+    EXPECT_EQ( Fooable::buffer_alignment(), alignof(void*) );
+    EXPECT_EQ( Fooable::inline_capacity(), 24u - sizeof(void*) );
+    EXPECT_TRUE( Fooable::stored_inline<MockFooable>() );
+    EXPECT_FALSE( Fooable::stored_inline<MockLargeFooable>() );
+
+}
+
+TEST( TestPMRSBOFooable, NonTrivialObject )
+{
+    EXPECT_TRUE( Fooable::stored_inline<MockNonTrivialFooable>() );
+
+    {
+        Fooable fooable = MockNonTrivialFooable();
+        ASSERT_FALSE( fooable.cast<MockNonTrivialFooable>() == nullptr );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 1 );
+
+        Fooable copy( fooable );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 2 );
+        test_copies( copy, fooable, Mock::other_value );
+
+        Fooable moved( std::move(copy) );
+        EXPECT_EQ( moved.foo(), Mock::other_value );
+
+        Fooable large = MockLargeFooable();
+        large = std::move(moved);
+        EXPECT_EQ( large.foo(), Mock::other_value );
+
+        fooable = large;
+        EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+        Fooable small = MockFooable();
+        small = std::move(fooable);
+        EXPECT_EQ( small.foo(), Mock::other_value );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
+
+TEST( TestPMRSBOFooable, TriviallyRelocatableObject )
+{
+    EXPECT_TRUE( Fooable::stored_inline<MockRelocatableFooable>() );
+
+    Fooable fooable = MockRelocatableFooable();
+    Fooable other = MockFooable();
+    MockRelocatableFooable::moves() = 0;
+
+    Fooable moved( std::move(fooable) );
+    EXPECT_EQ( moved.foo(), Mock::value );
+
+    std::swap( moved, other );
+    EXPECT_EQ( other.foo(), Mock::value );
+    ASSERT_FALSE( other.cast<MockRelocatableFooable>() == nullptr );
+
+    other.set_value( Mock::other_value );
+    EXPECT_EQ( other.foo(), Mock::other_value );
+    EXPECT_EQ( MockRelocatableFooable::moves(), 0 );
+}
+
+TEST( TestPMRSBOFooable, DefaultResource )
+{
+    Fooable fooable;
+    EXPECT_EQ( fooable.resource(), type_erasure::default_resource() );
+
+    Fooable other = MockLargeFooable();
+    EXPECT_EQ( other.resource(), type_erasure::default_resource() );
+}
+
+TEST( TestPMRSBOFooable, Resource_SmallObject )
+{
+    CountingResource resource;
+    {
+        Fooable fooable( MockFooable(), &resource );
+        Fooable copy( fooable );
+        EXPECT_EQ( copy.resource(), &resource );
+        test_copies( copy, fooable, Mock::other_value );
+    }
+    EXPECT_EQ( resource.allocations, 0u );
+}
+
+TEST( TestPMRSBOFooable, Resource_LargeObject )
+{
+    CountingResource resource;
+    {
+        Fooable fooable( MockLargeFooable(), &resource );
+        EXPECT_EQ( fooable.resource(), &resource );
+        EXPECT_EQ( resource.allocations, 1u );
+
+        Fooable copy( fooable );
+        EXPECT_EQ( copy.resource(), &resource );
+        EXPECT_EQ( resource.allocations, 2u );
+        test_copies( copy, fooable, Mock::other_value );
+
+        Fooable moved( std::move(copy) );
+        EXPECT_EQ( moved.resource(), &resource );
+        EXPECT_EQ( resource.allocations, 2u );
+
+        Fooable copy_assigned;
+        copy_assigned = fooable;
+        EXPECT_EQ( copy_assigned.resource(), &resource );
+        EXPECT_EQ( resource.allocations, 3u );
+
+        Fooable move_assigned = MockFooable();
+        move_assigned = std::move(moved);
+        EXPECT_EQ( move_assigned.resource(), &resource );
+        EXPECT_EQ( resource.allocations, 3u );
+    }
+    EXPECT_EQ( resource.deallocations, resource.allocations );
+    EXPECT_EQ( resource.bytes_in_use, 0u );
+}
+
+TEST( TestPMRSBOFooable, Resource_AssignFromValue )
+{
+    CountingResource resource;
+    {
+        Fooable fooable( &resource );
+        fooable = MockLargeFooable();
+        EXPECT_EQ( fooable.resource(), &resource );
+        EXPECT_EQ( resource.allocations, 1u );
+
+        fooable = MockFooable();
+        EXPECT_EQ( resource.deallocations, 1u );
+    }
+    EXPECT_EQ( resource.bytes_in_use, 0u );
+}
+
+TEST( TestPMRSBOFooable, InPlace )
+{
+    using Mock::MockValueFooable;
+    MockValueFooable::transfers() = 0;
+
+    Fooable fooable( type_erasure::in_place_type_t<MockValueFooable>(), Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    MockValueFooable& value = fooable.emplace<MockValueFooable>( Mock::value );
+    EXPECT_EQ( &value, fooable.cast<MockValueFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    Fooable made = PMRSBO::make_fooable<MockValueFooable>( Mock::other_value );
+    EXPECT_EQ( made.foo(), Mock::other_value );
+    EXPECT_EQ( MockValueFooable::transfers(), 0 );
+}
+
+TEST( TestPMRSBOFooable, InPlace_LargeObject )
+{
+    Fooable fooable{ type_erasure::in_place_type_t<Mock::MockLargeFooable>() };
+    ASSERT_FALSE( fooable.cast<Mock::MockLargeFooable>() == nullptr );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    fooable.emplace<Mock::MockLargeFooable>().set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    fooable.emplace<MockFooable>();
+    EXPECT_EQ( fooable.foo(), Mock::value );
+}
+
+TEST( TestPMRSBOFooable, InPlace_Resource )
+{
+    CountingResource resource;
+    {
+        Fooable fooable{ type_erasure::in_place_type_t<Mock::MockLargeFooable>(), &resource };
+        EXPECT_EQ( fooable.resource(), &resource );
+        EXPECT_EQ( fooable.foo(), Mock::value );
+        EXPECT_EQ( resource.allocations, 1u );
+
+        Fooable made =
+            PMRSBO::make_fooable<Mock::MockValueFooable>( &resource, Mock::other_value );
+        EXPECT_EQ( made.resource(), &resource );
+        EXPECT_EQ( made.foo(), Mock::other_value );
+        EXPECT_EQ( resource.allocations, 1u );
+    }
+    EXPECT_EQ( resource.deallocations, resource.allocations );
+    EXPECT_EQ( resource.bytes_in_use, 0u );
+}
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../pmr_sbo/interface.hh"
+#include "../pmr_cow/interface.hh"
+#include "../mock_fooable.hh"
+#include "../util.hh"
+
+namespace
+{
+    using Mock::MockFooable;
+    using Mock::MockAlignedFooable;
+}
+
+TEST( TestPoolResource_HeapAllocations, RecycledBlocks )
+{
+    auto expected_heap_allocations = 1u;
+
+    type_erasure::memory_resource* resource =
+        type_erasure::thread_local_pool_resource();
+    type_erasure::thread_local_pool().release();
+
+    CHECK_HEAP_ALLOC( PMRSBO::Fooable fooable( MockAlignedFooable(), resource ),
+                      expected_heap_allocations );
+
+    expected_heap_allocations = 0u;
+    CHECK_HEAP_ALLOC( PMRSBO::Fooable copy( fooable );
+                      PMRCOW::Fooable cow_fooable( MockFooable(), resource );
+                      PMRCOW::Fooable cow_copy( cow_fooable );
+                      cow_copy.set_value( Mock::other_value ),
+                      expected_heap_allocations );
+}
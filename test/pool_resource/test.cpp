@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../pmr_sbo/interface.hh"
+#include "../pmr_cow/interface.hh"
+#include "../mock_fooable.hh"
+#include "../counting_resource.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using type_erasure::pool_resource;
+    using Mock::MockFooable;
+    using Mock::MockAlignedFooable;
+    using Mock::MockLargeFooable;
+    using Mock::CountingResource;
+}
+
+
+TEST( TestPoolResource, RecyclesBlocks )
+{
+    CountingResource upstream;
+    pool_resource pool( &upstream );
+    EXPECT_EQ( pool.upstream_resource(), &upstream );
+
+    void* block = pool.allocate( 24 );
+    EXPECT_EQ( upstream.allocations, 1u );
+    EXPECT_EQ( upstream.bytes_in_use, pool_resource::chunk_bytes() );
+
+    void* other_block = pool.allocate( 24 );
+    EXPECT_NE( block, other_block );
+    EXPECT_EQ( upstream.allocations, 1u );
+
+    pool.deallocate( block, 24 );
+    EXPECT_EQ( pool.allocate( 24 ), block );
+    EXPECT_EQ( upstream.allocations, 1u );
+    EXPECT_EQ( upstream.deallocations, 0u );
+}
+
+TEST( TestPoolResource, SizeClasses )
+{
+    CountingResource upstream;
+    pool_resource pool( &upstream );
+
+    void* small_block = pool.allocate( 8 );
+    void* large_block = pool.allocate( pool_resource::max_block_size() );
+    EXPECT_EQ( upstream.allocations, 2u );
+
+    pool.deallocate( small_block, 8 );
+    EXPECT_NE( pool.allocate( pool_resource::max_block_size() ), small_block );
+    pool.deallocate( large_block, pool_resource::max_block_size() );
+}
+
+TEST( TestPoolResource, Alignment )
+{
+    pool_resource pool;
+    for (std::size_t bytes = 1; bytes <= pool_resource::max_block_size(); bytes += 7) {
+        void* block = pool.allocate( bytes );
+        EXPECT_EQ( reinterpret_cast<std::uintptr_t>(block) % alignof(std::max_align_t), 0u );
+    }
+}
+
+TEST( TestPoolResource, LargeBlocksGoUpstream )
+{
+    CountingResource upstream;
+    pool_resource pool( &upstream );
+
+    const std::size_t bytes = pool_resource::max_block_size() + 1;
+    void* block = pool.allocate( bytes );
+    EXPECT_EQ( upstream.allocations, 1u );
+    EXPECT_EQ( upstream.bytes_in_use, bytes );
+
+    pool.deallocate( block, bytes );
+    EXPECT_EQ( upstream.deallocations, 1u );
+    EXPECT_EQ( upstream.bytes_in_use, 0u );
+}
+
+TEST( TestPoolResource, Release )
+{
+    CountingResource upstream;
+    {
+        pool_resource pool( &upstream );
+        for (std::size_t i = 0; i < pool_resource::chunk_bytes(); ++i) {
+            pool.allocate( 64 );
+        }
+        EXPECT_GT( upstream.allocations, 1u );
+
+        pool.release();
+        EXPECT_EQ( upstream.deallocations, upstream.allocations );
+        EXPECT_EQ( upstream.bytes_in_use, 0u );
+
+        pool.allocate( 64 );
+        EXPECT_GT( upstream.bytes_in_use, 0u );
+    }
+    EXPECT_EQ( upstream.bytes_in_use, 0u );
+}
+
+TEST( TestPoolResource, ErasedTypes )
+{
+    CountingResource upstream;
+    pool_resource pool( &upstream );
+
+    {
+        PMRSBO::Fooable fooable( MockAlignedFooable(), &pool );
+        PMRSBO::Fooable copy( fooable );
+        copy.set_value( Mock::other_value );
+        EXPECT_EQ( fooable.foo(), Mock::value );
+        EXPECT_EQ( copy.foo(), Mock::other_value );
+
+        PMRCOW::Fooable cow_fooable( MockFooable(), &pool );
+        PMRCOW::Fooable cow_copy( cow_fooable );
+        cow_copy.set_value( Mock::other_value );
+        EXPECT_EQ( cow_fooable.foo(), Mock::value );
+        EXPECT_EQ( cow_copy.foo(), Mock::other_value );
+    }
+    const std::size_t chunks = upstream.allocations;
+    EXPECT_GT( chunks, 0u );
+
+    {
+        PMRSBO::Fooable fooable( MockAlignedFooable(), &pool );
+        PMRCOW::Fooable cow_fooable( MockFooable(), &pool );
+    }
+    EXPECT_EQ( upstream.allocations, chunks );
+}
+
+TEST( TestPoolResource, ThreadLocalPool )
+{
+    type_erasure::thread_local_pool_state* main_pool = &type_erasure::thread_local_pool();
+    type_erasure::thread_local_pool_state* thread_pool = nullptr;
+    int value = 0;
+
+    std::thread thread( [&] {
+        thread_pool = &type_erasure::thread_local_pool();
+        PMRSBO::Fooable fooable( MockAlignedFooable(),
+                                 type_erasure::thread_local_pool_resource() );
+        PMRSBO::Fooable copy( fooable );
+        copy.set_value( Mock::other_value );
+        value = copy.foo();
+    } );
+    thread.join();
+
+    EXPECT_NE( main_pool, thread_pool );
+    EXPECT_EQ( value, Mock::other_value );
+
+    {
+        PMRSBO::Fooable fooable( MockAlignedFooable(),
+                                 type_erasure::thread_local_pool_resource() );
+        EXPECT_EQ( fooable.resource(), type_erasure::thread_local_pool_resource() );
+        EXPECT_EQ( fooable.foo(), Mock::value );
+    }
+    type_erasure::thread_local_pool().release();
+}
+
+TEST( TestPoolResource, ThreadLocalPoolFreedByOtherThread )
+{
+    type_erasure::memory_resource* resource = type_erasure::thread_local_pool_resource();
+
+    // Blocks freed by another thread go back to this thread's pool.
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        blocks.push_back( resource->allocate( 48 ) );
+    }
+    std::thread( [&] {
+        for (void* block : blocks) {
+            resource->deallocate( block, 48 );
+        }
+    } ).join();
+
+    void* block = resource->allocate( 48 );
+    EXPECT_NE( std::find( blocks.begin(), blocks.end(), block ), blocks.end() );
+    resource->deallocate( block, 48 );
+
+    // A shared value outlives the thread that allocated it.
+    PMRCOW::Fooable fooable;
+    std::thread( [&] {
+        fooable = PMRCOW::Fooable( MockLargeFooable(), resource );
+    } ).join();
+
+    PMRCOW::Fooable copy( fooable );
+    copy.set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+    EXPECT_EQ( copy.foo(), Mock::other_value );
+    fooable = PMRCOW::Fooable();
+}
+
+TEST( TestPoolResource, ThreadLocalPoolReleasedAfterRemoteFree )
+{
+    type_erasure::memory_resource* resource = type_erasure::thread_local_pool_resource();
+
+    void* block = resource->allocate( 48 );
+    std::thread( [&] {
+        resource->deallocate( block, 48 );
+    } ).join();
+
+    // The block freed by the other thread went back upstream with its chunk,
+    // and must not be recycled by the next allocation.
+    type_erasure::thread_local_pool().release();
+
+    void* first = resource->allocate( 48 );
+    void* second = resource->allocate( 48 );
+    EXPECT_NE( first, second );
+    resource->deallocate( second, 48 );
+    resource->deallocate( first, 48 );
+    type_erasure::thread_local_pool().release();
+}
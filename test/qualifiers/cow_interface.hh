@@ -0,0 +1,247 @@
+#ifndef QUALIFIERS_COW_FOOABLE_HH
+#define QUALIFIERS_COW_FOOABLE_HH
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include "../mock_fooable.hh"
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
+
+
+namespace QualifiersCOW {
+    
+    class Fooable
+    {
+    public:
+        // Contructors
+        Fooable () = default;
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                             std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ) :
+            handle_ (
+                std::make_shared< Handle<typename std::decay<T>::type> >(
+                    std::forward<T>(value)
+                )
+            )
+        {}
+    
+        // Constructs a T from args in place.
+        template <typename T, typename... Args>
+        explicit Fooable (type_erasure::in_place_type_t<T>, Args&&... args) :
+            handle_ (
+                std::make_shared< Handle<T> >(
+                    type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+                )
+            )
+        {}
+    
+        // Assignment
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                        std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            Fooable temp( std::forward<T>(value) );
+            std::swap(temp.handle_, handle_);
+            return *this;
+        }
+    
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.  Writing through the reference after the object is copied
+        // would change the copies too.
+        template <typename T, typename... Args>
+        T& emplace (Args&&... args)
+        {
+            handle_ = std::make_shared< Handle<T> >(
+                type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...
+            );
+            return value_of<T>();
+        }
+    
+        template <typename T>
+        T* cast()
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<Handle<T>*>( handle_.get() )->value_;
+        }
+    
+        template <typename T>
+        const T* cast() const
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<const Handle<T>*>( handle_.get() )->value_;
+        }
+    
+        [[nodiscard]] int foo ( ) const noexcept
+        {
+                assert(handle_);
+                return read().foo( );
+        }
+        void set_value ( int value )
+        {
+                assert(handle_);
+                write().set_value(value );
+        }
+        Mock :: CopyCounter counter ( ) const &
+        {
+                assert(handle_);
+                return read().counter( );
+        }
+        Mock :: CopyCounter counter ( ) &&
+        {
+                assert(handle_);
+                return std::move(write()).counter( );
+        }
+    
+    private:
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename T>
+        T& value_of ()
+        {
+            return static_cast<Handle<T>*>(handle_.get())->value_;
+        }
+    
+        struct HandleBase
+        {
+            virtual ~HandleBase () {}
+            virtual const void* type_id () const noexcept = 0;
+            virtual std::shared_ptr<HandleBase> clone () const = 0;
+    
+            [[nodiscard]] virtual int foo ( ) const noexcept = 0;
+            virtual void set_value ( int value ) noexcept = 0;
+            virtual Mock :: CopyCounter counter ( ) const & = 0;
+            virtual Mock :: CopyCounter counter ( ) && = 0;
+        };
+    
+        template <typename T>
+        struct Handle : HandleBase
+        {
+            template <typename U,
+                      typename std::enable_if<
+                          !std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle( U&& value ) noexcept
+                : value_( value )
+            {}
+    
+            template <typename U,
+                      typename std::enable_if<
+                          std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle( U&& value ) noexcept ( std::is_rvalue_reference<U>::value &&
+                                                    std::is_nothrow_move_constructible<typename std::decay<U>::type>::value )
+                : value_( std::forward<U>(value) )
+            {}
+    
+            template <typename... Args>
+            explicit Handle( type_erasure::in_place_type_t<T>, Args&&... args )
+                : value_( std::forward<Args>(args)... )
+            {}
+    
+            virtual std::shared_ptr<HandleBase> clone () const
+            {
+                return std::make_shared<Handle>(value_);
+            }
+    
+            virtual const void* type_id () const noexcept
+            {
+                return Fooable::type_id<T>();
+            }
+    
+            [[nodiscard]] virtual int foo ( ) const noexcept {
+                return value_.foo( );
+            }
+            virtual void set_value ( int value ) noexcept {
+                value_.set_value(value );
+            }
+            virtual Mock :: CopyCounter counter ( ) const & {
+                return value_.counter( );
+            }
+            virtual Mock :: CopyCounter counter ( ) && {
+                return std::move(value_).counter( );
+            }
+    
+            T value_;
+        };
+    
+        template <typename T>
+        struct Handle< std::reference_wrapper<T> > : Handle<T&>
+        {
+            Handle (std::reference_wrapper<T> ref)
+                : Handle<T&> (ref.get())
+            {}
+        };
+    
+        const HandleBase& read () const
+        {
+            return *handle_;
+        }
+    
+        HandleBase& write ()
+        {
+            if (!handle_.unique())
+                handle_ = handle_->clone();
+            return *handle_;
+        }
+    
+        std::shared_ptr<HandleBase> handle_;
+    };
+    
+    // Constructs a T from args in place, in a new Fooable.
+    template <typename T, typename... Args>
+    Fooable make_fooable (Args&&... args)
+    {
+        return Fooable(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
+
+}
+#endif
+
@@ -0,0 +1,17 @@
+#ifndef QUALIFIERS_CLOSED_FOOABLE_HH
+#define QUALIFIERS_CLOSED_FOOABLE_HH
+
+#include "../mock_fooable.hh"
+
+namespace QualifiersClosed
+{
+    class Fooable
+    {
+    public:
+        [[nodiscard]] int foo() const noexcept;
+        void set_value(int value) noexcept;
+        Mock::CopyCounter counter() const &;
+        Mock::CopyCounter counter() &&;
+    };
+}
+#endif
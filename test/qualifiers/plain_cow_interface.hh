@@ -0,0 +1,17 @@
+#ifndef QUALIFIERS_COW_FOOABLE_HH
+#define QUALIFIERS_COW_FOOABLE_HH
+
+#include "../mock_fooable.hh"
+
+namespace QualifiersCOW
+{
+    class Fooable
+    {
+    public:
+        [[nodiscard]] int foo() const noexcept;
+        void set_value(int value) noexcept;
+        Mock::CopyCounter counter() const &;
+        Mock::CopyCounter counter() &&;
+    };
+}
+#endif
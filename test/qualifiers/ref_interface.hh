@@ -0,0 +1,265 @@
+#ifndef QUALIFIERS_REF_FOOABLE_HH
+#define QUALIFIERS_REF_FOOABLE_HH
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include "../mock_fooable.hh"
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#endif
+
+#ifndef TYPE_ERASURE_DELEGATE
+#define TYPE_ERASURE_DELEGATE
+namespace type_erasure
+{
+    // A member function of an erased object bound to that object, as
+    // returned by the generated bind_*() members: a pointer to the object's
+    // storage, and the function pointer its table holds for the stored type.
+    // Calling it makes no lookup.  It is trivially copyable, and two pointers
+    // in size.
+    //
+    // It is invalidated when the erased object is destroyed or moved from, or
+    // given a new value by assignment or emplace(), even one of the same type.
+    // When TYPE_ERASURE_CHECK_DELEGATES is defined, delegates and erased
+    // objects grow by a count of these changes, and calls assert that none
+    // has happened since the delegate was bound while the erased object
+    // lives.  Define it in every translation unit or in none, since it
+    // changes the layout of both.  Calling a delegate after the erased object
+    // is destroyed cannot be checked.
+    template <typename Signature>
+    class delegate;
+
+    template <typename R, typename Object, typename... Args>
+    class delegate<R (Object*, Args...)>
+    {
+    public:
+        using function_type = R (*) (Object*, Args...);
+
+        delegate () = default;
+
+        delegate (Object* object, function_type function,
+                  const void* owner, std::size_t (*generation_of) (const void*)) noexcept :
+            object_ (object),
+            function_ (function)
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            ,
+            owner_ (owner),
+            generation_ (generation_of(owner)),
+            generation_of_ (generation_of)
+#endif
+        {
+            (void)owner;
+            (void)generation_of;
+        }
+
+        R operator() (Args... args) const
+        {
+            assert(function_);
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            assert(generation_of_(owner_) == generation_ &&
+                   "delegate used after its object was given a new value or moved from");
+#endif
+            return function_(object_, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool () const noexcept
+        {
+            return function_ != nullptr;
+        }
+
+    private:
+        Object* object_ = nullptr;
+        function_type function_ = nullptr;
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+        const void* owner_ = nullptr;
+        std::size_t generation_ = 0;
+        std::size_t (*generation_of_) (const void*) = nullptr;
+#endif
+    };
+}
+#endif
+
+
+namespace QualifiersRef {
+    
+    class FooableRef
+    {
+    public:
+        // Contructors
+        FooableRef () = default;
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< FooableRef, typename std::remove_const<T>::type >::value
+                      >::type* = nullptr>
+        FooableRef (T& value) noexcept :
+            vtable_ (Thunks<T>::table()),
+            object_ (const_cast<void*>(static_cast<const void*>(std::addressof(value))))
+        {}
+    
+        // T& above also binds const rvalues.  Referring to a temporary is
+        // never intended.
+        template <typename T>
+        FooableRef (const T&& value) = delete;
+    
+        // cast<const T>() succeeds for const and non-const referenced objects,
+        // cast<T>() only for non-const ones.
+        template <typename T>
+        T* cast() const
+        {
+            assert(vtable_);
+            if (vtable_->type_id() != type_id<T>() &&
+                vtable_->type_id() != type_id<typename std::remove_const<T>::type>())
+                return nullptr;
+            return static_cast<T*>(object_);
+        }
+    
+        [[nodiscard]] int foo ( ) const noexcept
+        {
+                assert(vtable_);
+                return vtable().foo(object() );
+        }
+        void set_value ( int value ) noexcept
+        {
+                assert(vtable_);
+                vtable().set_value(object(), value );
+        }
+        Mock :: CopyCounter counter ( ) const &
+        {
+                assert(vtable_);
+                return vtable().counter(object() );
+        }
+        Mock :: CopyCounter counter ( ) &&
+        {
+                assert(vtable_);
+                return vtable().counter_1(object() );
+        }
+    
+        type_erasure::delegate<int (const void* object_)> bind_foo () const
+        {
+                assert(vtable_);
+                return type_erasure::delegate<int (const void* object_)>(object(), vtable().foo, this, &bound_generation);
+        }
+        type_erasure::delegate<void (void* object_, int value)> bind_set_value ()
+        {
+                assert(vtable_);
+                return type_erasure::delegate<void (void* object_, int value)>(object(), vtable().set_value, this, &bound_generation);
+        }
+        type_erasure::delegate<Mock :: CopyCounter (const void* object_)> bind_counter () const
+        {
+                assert(vtable_);
+                return type_erasure::delegate<Mock :: CopyCounter (const void* object_)>(object(), vtable().counter, this, &bound_generation);
+        }
+        type_erasure::delegate<Mock :: CopyCounter (void* object_)> bind_counter_1 ()
+        {
+                assert(vtable_);
+                return type_erasure::delegate<Mock :: CopyCounter (void* object_)>(object(), vtable().counter_1, this, &bound_generation);
+        }
+    
+    private:
+        // One table per referenced type, built at compile time.  Every entry
+        // takes the referenced object as its object parameter.
+        struct VTable
+        {
+            const void* (*type_id) ();
+    
+            int (*foo) (const void* object_) noexcept;
+            void (*set_value) (void* object_, int value) noexcept;
+            Mock :: CopyCounter (*counter) (const void* object_);
+            Mock :: CopyCounter (*counter_1) (void* object_);
+        };
+    
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename T>
+        struct Thunks
+        {
+            static T& value_of (void* object_)
+            {
+                return *static_cast<T*>(object_);
+            }
+    
+            static const T& value_of (const void* object_)
+            {
+                return *static_cast<const T*>(object_);
+            }
+    
+            // A reference does not own its object, so even an rvalue reference
+            // never lets rvalue-qualified functions consume it.
+            static T& rvalue_of (void* object_)
+            {
+                return value_of(object_);
+            }
+    
+            static const T& rvalue_of (const void* object_)
+            {
+                return value_of(object_);
+            }
+    
+            static int foo (const void* object_) noexcept
+            {
+                return value_of(object_).foo( );
+            }
+            static void set_value (void* object_, int value) noexcept
+            {
+                value_of(object_).set_value(value );
+            }
+            static Mock :: CopyCounter counter (const void* object_)
+            {
+                return value_of(object_).counter( );
+            }
+            static Mock :: CopyCounter counter_1 (void* object_)
+            {
+                return rvalue_of(object_).counter( );
+            }
+    
+            static const VTable* table ()
+            {
+                static constexpr VTable table = {
+                    &type_id<T>,
+                    &foo,
+                    &set_value,
+                    &counter,
+                    &counter_1,
+                };
+                return &table;
+            }
+        };
+    
+        const VTable& vtable () const
+        {
+            return *vtable_;
+        }
+    
+        // Delegates returned by the bind_*() members call the referenced object,
+        // so they stay valid as long as it lives, whatever becomes of the
+        // reference.
+        static std::size_t bound_generation (const void*)
+        {
+            return 0;
+        }
+    
+        void* object () const
+        {
+            return object_;
+        }
+    
+        const VTable* vtable_ = nullptr;
+        void* object_ = nullptr;
+    };
+
+}
+#endif
+
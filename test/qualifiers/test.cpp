@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include "basic_interface.hh"
+#include "cow_interface.hh"
+#include "vtable_interface.hh"
+#include "ref_interface.hh"
+#include "closed_interface.hh"
+#include "../mock_fooable.hh"
+
+namespace
+{
+    using Mock::CopyCounter;
+    using Mock::MockQualifiedFooable;
+
+    template <typename Fooable>
+    void test_qualifiers ()
+    {
+        static_assert(noexcept(std::declval<const Fooable&>().foo()), "");
+
+        MockQualifiedFooable mock;
+        Fooable fooable = mock;
+        EXPECT_EQ( fooable.foo(), Mock::value );
+
+        CopyCounter::copies() = 0;
+        CopyCounter counter = fooable.counter();
+        EXPECT_EQ( CopyCounter::copies(), 1 );
+
+        counter = std::move(fooable).counter();
+        EXPECT_EQ( CopyCounter::copies(), 1 );
+    }
+}
+
+TEST( TestQualifiers, Basic )
+{
+    using QualifiersBasic::Fooable;
+    static_assert(noexcept(std::declval<Fooable&>().set_value(0)), "");
+    test_qualifiers<Fooable>();
+}
+
+// write() may copy the value, so non-const functions of the copy-on-write
+// forms cannot be noexcept.
+TEST( TestQualifiers, COW )
+{
+    using QualifiersCOW::Fooable;
+    static_assert(!noexcept(std::declval<Fooable&>().set_value(0)), "");
+    test_qualifiers<Fooable>();
+}
+
+TEST( TestQualifiers, StaticVTable )
+{
+    using QualifiersVTable::Fooable;
+    static_assert(noexcept(std::declval<Fooable&>().set_value(0)), "");
+    test_qualifiers<Fooable>();
+}
+
+TEST( TestQualifiers, Ref )
+{
+    using QualifiersRef::FooableRef;
+    static_assert(noexcept(std::declval<FooableRef&>().set_value(0)), "");
+
+    // A reference never consumes the object it refers to.
+    MockQualifiedFooable mock;
+    FooableRef ref = mock;
+    EXPECT_EQ( ref.foo(), Mock::value );
+
+    CopyCounter::copies() = 0;
+    std::move(ref).counter();
+    EXPECT_EQ( CopyCounter::copies(), 1 );
+}
+
+TEST( TestQualifiers, Closed )
+{
+    using QualifiersClosed::Fooable;
+    static_assert(noexcept(std::declval<Fooable&>().set_value(0)), "");
+    test_qualifiers<Fooable>();
+}
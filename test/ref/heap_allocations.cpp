@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "interface.hh"
+#include "../basic/interface.hh"
+#include "../cow/interface.hh"
+#include "../mock_fooable.hh"
+#include "../util.hh"
+
+namespace
+{
+    using Ref::FooableRef;
+    using Ref::FooableView;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+}
+
+TEST( TestFooableRef_HeapAllocations, FromValue )
+{
+    auto expected_heap_allocations = 0u;
+
+    MockFooable mock_fooable;
+    CHECK_HEAP_ALLOC( FooableRef fooable( mock_fooable ),
+                      expected_heap_allocations );
+
+    MockLargeFooable large_mock_fooable;
+    CHECK_HEAP_ALLOC( FooableRef large_fooable( large_mock_fooable ),
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( FooableView view( large_mock_fooable ),
+                      expected_heap_allocations );
+}
+
+TEST( TestFooableRef_HeapAllocations, Copy )
+{
+    auto expected_heap_allocations = 0u;
+
+    MockFooable mock_fooable;
+    FooableRef fooable( mock_fooable );
+    CHECK_HEAP_ALLOC( FooableRef copy( fooable ),
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( FooableRef copy_assign;
+                      copy_assign = fooable,
+                      expected_heap_allocations );
+}
+
+TEST( TestFooableRef_HeapAllocations, FromOwningErasedType )
+{
+    auto expected_heap_allocations = 0u;
+
+    Basic::Fooable basic_fooable = MockFooable();
+    CHECK_HEAP_ALLOC( FooableRef fooable( basic_fooable );
+                      fooable.set_value( Mock::other_value ),
+                      expected_heap_allocations );
+
+    COW::Fooable cow_fooable = MockFooable();
+    CHECK_HEAP_ALLOC( FooableView view( cow_fooable );
+                      view.foo(),
+                      expected_heap_allocations );
+}
@@ -0,0 +1,900 @@
+#ifndef REF_FOOABLE_HH
+#define REF_FOOABLE_HH
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#endif
+
+#ifndef TYPE_ERASURE_DELEGATE
+#define TYPE_ERASURE_DELEGATE
+namespace type_erasure
+{
+    // A member function of an erased object bound to that object, as
+    // returned by the generated bind_*() members: a pointer to the object's
+    // storage, and the function pointer its table holds for the stored type.
+    // Calling it makes no lookup.  It is trivially copyable, and two pointers
+    // in size.
+    //
+    // It is invalidated when the erased object is destroyed or moved from, or
+    // given a new value by assignment or emplace(), even one of the same type.
+    // When TYPE_ERASURE_CHECK_DELEGATES is defined, delegates and erased
+    // objects grow by a count of these changes, and calls assert that none
+    // has happened since the delegate was bound while the erased object
+    // lives.  Define it in every translation unit or in none, since it
+    // changes the layout of both.  Calling a delegate after the erased object
+    // is destroyed cannot be checked.
+    template <typename Signature>
+    class delegate;
+
+    template <typename R, typename Object, typename... Args>
+    class delegate<R (Object*, Args...)>
+    {
+    public:
+        using function_type = R (*) (Object*, Args...);
+
+        delegate () = default;
+
+        delegate (Object* object, function_type function,
+                  const void* owner, std::size_t (*generation_of) (const void*)) noexcept :
+            object_ (object),
+            function_ (function)
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            ,
+            owner_ (owner),
+            generation_ (generation_of(owner)),
+            generation_of_ (generation_of)
+#endif
+        {
+            (void)owner;
+            (void)generation_of;
+        }
+
+        R operator() (Args... args) const
+        {
+            assert(function_);
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+            assert(generation_of_(owner_) == generation_ &&
+                   "delegate used after its object was given a new value or moved from");
+#endif
+            return function_(object_, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool () const noexcept
+        {
+            return function_ != nullptr;
+        }
+
+    private:
+        Object* object_ = nullptr;
+        function_type function_ = nullptr;
+#ifdef TYPE_ERASURE_CHECK_DELEGATES
+        const void* owner_ = nullptr;
+        std::size_t generation_ = 0;
+        std::size_t (*generation_of_) (const void*) = nullptr;
+#endif
+    };
+}
+#endif
+
+#ifndef TYPE_ERASURE_COLLECTION
+#define TYPE_ERASURE_COLLECTION
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace type_erasure
+{
+    // A container for values of any types that bind to Ref, a reference type
+    // generated from forms/ref.hpp.  The values of each type are kept in
+    // their own std::vector, a segment, so iteration walks memory in order
+    // and calls through Ref go to the same function for a whole segment.
+    // for_each<Ts...>() goes further, and calls its function object on the
+    // values of the types Ts... directly, in loops the compiler can inline.
+    // Inserting or erasing invalidates references into the affected segment
+    // only.  Segments are visited in the order their types were first
+    // inserted.
+    template <typename Ref>
+    class collection
+    {
+    public:
+        template <typename T>
+        typename std::decay<T>::type& insert (T&& value)
+        {
+            std::vector<typename std::decay<T>::type>& values =
+                segment<typename std::decay<T>::type>();
+            values.push_back(std::forward<T>(value));
+            return values.back();
+        }
+
+        // The values of type T, in insertion order.  Erase or reorder them as
+        // in any std::vector.
+        template <typename T>
+        std::vector<T>& segment ()
+        {
+            for (const std::unique_ptr<SegmentBase>& segment : segments_) {
+                if (segment->type_id() == type_id<T>())
+                    return static_cast<Segment<T>&>(*segment).values_;
+            }
+            segments_.emplace_back(new Segment<T>);
+            return static_cast<Segment<T>&>(*segments_.back()).values_;
+        }
+
+        // Calls f(value) for each value of one of the types Ts..., and f(Ref)
+        // for all others.
+        template <typename... Ts, typename F>
+        F for_each (F f)
+        {
+            for (const std::unique_ptr<SegmentBase>& segment : segments_) {
+                if (!for_each_in(*segment, f, Types<Ts...>()))
+                    segment->for_each(&call<F>, &f);
+            }
+            return f;
+        }
+
+        // Erases every value for which pred(Ref) is true.  Returns the number
+        // of values erased.
+        template <typename Pred>
+        std::size_t erase_if (Pred pred)
+        {
+            std::size_t retval = 0;
+            for (const std::unique_ptr<SegmentBase>& segment : segments_) {
+                retval += segment->erase_if(&test<Pred>, &pred);
+            }
+            return retval;
+        }
+
+        std::size_t size () const noexcept
+        {
+            std::size_t retval = 0;
+            for (const std::unique_ptr<SegmentBase>& segment : segments_) {
+                retval += segment->size();
+            }
+            return retval;
+        }
+
+        bool empty () const noexcept
+        {
+            return size() == 0;
+        }
+
+        void clear () noexcept
+        {
+            segments_.clear();
+        }
+
+    private:
+        template <typename... Ts>
+        struct Types
+        {};
+
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+
+        struct SegmentBase
+        {
+            virtual ~SegmentBase () {}
+            virtual const void* type_id () const noexcept = 0;
+            virtual std::size_t size () const noexcept = 0;
+            virtual void for_each (void (*f) (void*, Ref), void* context) = 0;
+            virtual std::size_t erase_if (bool (*pred) (void*, Ref), void* context) = 0;
+        };
+
+        template <typename T>
+        struct Segment : SegmentBase
+        {
+            virtual const void* type_id () const noexcept
+            {
+                return collection::type_id<T>();
+            }
+
+            virtual std::size_t size () const noexcept
+            {
+                return values_.size();
+            }
+
+            virtual void for_each (void (*f) (void*, Ref), void* context)
+            {
+                for (T& value : values_) {
+                    f(context, Ref(value));
+                }
+            }
+
+            virtual std::size_t erase_if (bool (*pred) (void*, Ref), void* context)
+            {
+                const std::size_t size = values_.size();
+                values_.erase(
+                    std::remove_if(values_.begin(), values_.end(),
+                                   [=](T& value) { return pred(context, Ref(value)); }),
+                    values_.end()
+                );
+                return size - values_.size();
+            }
+
+            std::vector<T> values_;
+        };
+
+        template <typename F>
+        static bool for_each_in (SegmentBase&, F&, Types<>)
+        {
+            return false;
+        }
+
+        template <typename F, typename T, typename... Ts>
+        static bool for_each_in (SegmentBase& segment, F& f, Types<T, Ts...>)
+        {
+            if (segment.type_id() != type_id<T>())
+                return for_each_in(segment, f, Types<Ts...>());
+            for (T& value : static_cast<Segment<T>&>(segment).values_) {
+                f(value);
+            }
+            return true;
+        }
+
+        template <typename F>
+        static void call (void* f, Ref ref)
+        {
+            (*static_cast<F*>(f))(ref);
+        }
+
+        template <typename Pred>
+        static bool test (void* pred, Ref ref)
+        {
+            return (*static_cast<Pred*>(pred))(ref);
+        }
+
+        std::vector<std::unique_ptr<SegmentBase>> segments_;
+    };
+}
+#endif
+
+#ifndef TYPE_ERASURE_ERASED_ARRAY
+#define TYPE_ERASURE_ERASED_ARRAY
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace type_erasure
+{
+    // A sequence of values of any types that bind to Ref, a reference type
+    // generated from forms/ref.hpp, laid out end to end in one block of
+    // memory.  Each value is preceded by a header of a pointer to a table of
+    // operations for its type and the distance to the next header, and takes
+    // only the space its type needs, padded to its alignment.  Iterating
+    // yields a Ref bound to each value in turn.  If every value is trivially
+    // copyable, copying and growing the array copy the whole block at once.
+    // Stored types must be nothrow move constructible and may not be
+    // over-aligned.  Appending invalidates iterators and references.
+    template <typename Ref>
+    class erased_array
+    {
+        struct Ops
+        {
+            Ref (*bind) (void* value);
+            void (*copy) (const void* from, void* to);
+            void (*relocate) (void* from, void* to);
+            void (*destroy) (void* value);
+            std::size_t size;
+            std::size_t alignment;
+        };
+
+        using Header = const Ops*;
+        using Stride = std::uint32_t;
+
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Ref;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Ref;
+
+            iterator () = default;
+
+            Ref operator* () const
+            {
+                return ops()->bind(data_ + value_offset(pos_, *ops()));
+            }
+
+            iterator& operator++ ()
+            {
+                pos_ += *reinterpret_cast<const Stride*>(data_ + pos_ + sizeof(Header));
+                return *this;
+            }
+
+            iterator operator++ (int)
+            {
+                iterator retval = *this;
+                ++*this;
+                return retval;
+            }
+
+            friend bool operator== (iterator lhs, iterator rhs)
+            {
+                return lhs.pos_ == rhs.pos_;
+            }
+
+            friend bool operator!= (iterator lhs, iterator rhs)
+            {
+                return lhs.pos_ != rhs.pos_;
+            }
+
+        private:
+            iterator (unsigned char* data, std::size_t pos) :
+                data_ (data),
+                pos_ (pos)
+            {}
+
+            const Ops* ops () const
+            {
+                return *reinterpret_cast<const Header*>(data_ + pos_);
+            }
+
+            unsigned char* data_ = nullptr;
+            std::size_t pos_ = 0;
+
+            friend class erased_array;
+        };
+
+        erased_array () = default;
+
+        erased_array (const erased_array& rhs)
+        {
+            if (!rhs.used_)
+                return;
+            allocate(rhs.used_);
+            if (rhs.trivial_) {
+                std::memcpy(data_, rhs.data_, rhs.used_);
+            } else {
+                trivial_ = false;
+                try {
+                    for (std::size_t pos = 0; pos < rhs.used_; ) {
+                        const Ops& ops = rhs.ops_at(pos);
+                        const std::size_t value = value_offset(pos, ops);
+                        ops.copy(rhs.data_ + value, data_ + value);
+                        pos = used_ = write_header(data_, pos, ops);
+                        ++size_;
+                    }
+                } catch (...) {
+                    reset();
+                    throw;
+                }
+            }
+            used_ = rhs.used_;
+            size_ = rhs.size_;
+            trivial_ = rhs.trivial_;
+        }
+
+        erased_array (erased_array&& rhs) noexcept
+        {
+            steal(rhs);
+        }
+
+        erased_array& operator= (const erased_array& rhs)
+        {
+            erased_array temp(rhs);
+            reset();
+            steal(temp);
+            return *this;
+        }
+
+        erased_array& operator= (erased_array&& rhs) noexcept
+        {
+            if (this != &rhs) {
+                reset();
+                steal(rhs);
+            }
+            return *this;
+        }
+
+        ~erased_array ()
+        {
+            reset();
+        }
+
+        template <typename T>
+        typename std::decay<T>::type& push_back (T&& value)
+        {
+            using U = typename std::decay<T>::type;
+            static_assert(alignof(U) <= alignof(std::max_align_t),
+                          "over-aligned types cannot be stored in an erased_array");
+            static_assert(sizeof(U) < (1u << 31),
+                          "types stored in an erased_array must be smaller than 2 GB");
+            static_assert(std::is_nothrow_move_constructible<U>::value,
+                          "types stored in an erased_array must be nothrow move constructible");
+
+            const Ops& ops = *ops_for<U>();
+            const std::size_t offset = value_offset(used_, ops);
+            const std::size_t next = next_offset(used_, ops);
+            if (capacity_ < next)
+                grow(next);
+
+            U* retval = ::new (data_ + offset) U(std::forward<T>(value));
+            write_header(data_, used_, ops);
+            used_ = next;
+            ++size_;
+            trivial_ = trivial_ && std::is_trivially_copyable<U>::value;
+            return *retval;
+        }
+
+        iterator begin () noexcept
+        {
+            return iterator(data_, 0);
+        }
+
+        iterator end () noexcept
+        {
+            return iterator(data_, used_);
+        }
+
+        // The number of values.
+        std::size_t size () const noexcept
+        {
+            return size_;
+        }
+
+        bool empty () const noexcept
+        {
+            return size_ == 0;
+        }
+
+        // The number of bytes taken by the values and their headers.
+        std::size_t bytes () const noexcept
+        {
+            return used_;
+        }
+
+        std::size_t capacity_bytes () const noexcept
+        {
+            return capacity_;
+        }
+
+        void reserve_bytes (std::size_t bytes)
+        {
+            if (capacity_ < bytes)
+                reallocate(bytes);
+        }
+
+        void clear () noexcept
+        {
+            destroy_all();
+            used_ = 0;
+            size_ = 0;
+            trivial_ = true;
+        }
+
+    private:
+        template <typename T>
+        struct OpsFor
+        {
+            static Ref bind (void* value)
+            {
+                return Ref(*static_cast<T*>(value));
+            }
+
+            static void copy (const void* from, void* to)
+            {
+                ::new (to) T(*static_cast<const T*>(from));
+            }
+
+            static void relocate (void* from, void* to)
+            {
+                T& value = *static_cast<T*>(from);
+                ::new (to) T(std::move(value));
+                value.~T();
+            }
+
+            static void destroy (void* value)
+            {
+                static_cast<T*>(value)->~T();
+            }
+        };
+
+        template <typename T>
+        static const Ops* ops_for ()
+        {
+            static constexpr Ops ops = {
+                &OpsFor<T>::bind,
+                &OpsFor<T>::copy,
+                &OpsFor<T>::relocate,
+                &OpsFor<T>::destroy,
+                sizeof(T),
+                alignof(T)
+            };
+            return &ops;
+        }
+
+        // The block starts at an address aligned for any type, so offsets
+        // into it are as aligned as the addresses they lead to.  Alignments
+        // are powers of two.
+        static std::size_t align (std::size_t offset, std::size_t alignment)
+        {
+            return (offset + alignment - 1) & ~(alignment - 1);
+        }
+
+        static std::size_t value_offset (std::size_t pos, const Ops& ops)
+        {
+            return align(pos + sizeof(Header) + sizeof(Stride), ops.alignment);
+        }
+
+        static std::size_t next_offset (std::size_t pos, const Ops& ops)
+        {
+            return align(value_offset(pos, ops) + ops.size, alignof(Header));
+        }
+
+        // Returns the offset of the next header.
+        static std::size_t write_header (unsigned char* data, std::size_t pos, const Ops& ops)
+        {
+            const std::size_t next = next_offset(pos, ops);
+            ::new (data + pos) Header(&ops);
+            ::new (data + pos + sizeof(Header)) Stride(static_cast<Stride>(next - pos));
+            return next;
+        }
+
+        const Ops& ops_at (std::size_t pos) const
+        {
+            return **reinterpret_cast<const Header*>(data_ + pos);
+        }
+
+        void allocate (std::size_t bytes)
+        {
+            data_ = static_cast<unsigned char*>(::operator new(bytes));
+            capacity_ = bytes;
+        }
+
+        void grow (std::size_t bytes)
+        {
+            reallocate(capacity_ * 2 < bytes ? bytes : capacity_ * 2);
+        }
+
+        void reallocate (std::size_t bytes)
+        {
+            unsigned char* const data = static_cast<unsigned char*>(::operator new(bytes));
+            if (trivial_) {
+                if (used_)
+                    std::memcpy(data, data_, used_);
+            } else {
+                for (std::size_t pos = 0; pos < used_; ) {
+                    const Ops& ops = ops_at(pos);
+                    const std::size_t value = value_offset(pos, ops);
+                    ops.relocate(data_ + value, data + value);
+                    pos = write_header(data, pos, ops);
+                }
+            }
+            ::operator delete(data_);
+            data_ = data;
+            capacity_ = bytes;
+        }
+
+        void destroy_all () noexcept
+        {
+            if (trivial_)
+                return;
+            for (std::size_t pos = 0; pos < used_; ) {
+                const Ops& ops = ops_at(pos);
+                ops.destroy(data_ + value_offset(pos, ops));
+                pos = next_offset(pos, ops);
+            }
+        }
+
+        void reset () noexcept
+        {
+            clear();
+            ::operator delete(data_);
+            data_ = nullptr;
+            capacity_ = 0;
+        }
+
+        void steal (erased_array& rhs) noexcept
+        {
+            data_ = rhs.data_;
+            capacity_ = rhs.capacity_;
+            used_ = rhs.used_;
+            size_ = rhs.size_;
+            trivial_ = rhs.trivial_;
+            rhs.data_ = nullptr;
+            rhs.capacity_ = 0;
+            rhs.used_ = 0;
+            rhs.size_ = 0;
+            rhs.trivial_ = true;
+        }
+
+        unsigned char* data_ = nullptr;
+        std::size_t capacity_ = 0;
+        std::size_t used_ = 0;
+        std::size_t size_ = 0;
+        bool trivial_ = true;
+    };
+}
+#endif
+
+
+namespace Ref {
+    
+    class FooableRef
+    {
+    public:
+        // Contructors
+        FooableRef () = default;
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< FooableRef, typename std::remove_const<T>::type >::value
+                      >::type* = nullptr>
+        FooableRef (T& value) noexcept :
+            vtable_ (Thunks<T>::table()),
+            object_ (const_cast<void*>(static_cast<const void*>(std::addressof(value))))
+        {}
+    
+        // T& above also binds const rvalues.  Referring to a temporary is
+        // never intended.
+        template <typename T>
+        FooableRef (const T&& value) = delete;
+    
+        // cast<const T>() succeeds for const and non-const referenced objects,
+        // cast<T>() only for non-const ones.
+        template <typename T>
+        T* cast() const
+        {
+            assert(vtable_);
+            if (vtable_->type_id() != type_id<T>() &&
+                vtable_->type_id() != type_id<typename std::remove_const<T>::type>())
+                return nullptr;
+            return static_cast<T*>(object_);
+        }
+    
+        int foo ( ) const
+        {
+                assert(vtable_);
+                return vtable().foo(object() );
+        }
+        void set_value ( int value )
+        {
+                assert(vtable_);
+                vtable().set_value(object(), value );
+        }
+    
+        type_erasure::delegate<int (const void* object_)> bind_foo () const
+        {
+                assert(vtable_);
+                return type_erasure::delegate<int (const void* object_)>(object(), vtable().foo, this, &bound_generation);
+        }
+        type_erasure::delegate<void (void* object_, int value)> bind_set_value ()
+        {
+                assert(vtable_);
+                return type_erasure::delegate<void (void* object_, int value)>(object(), vtable().set_value, this, &bound_generation);
+        }
+    
+    private:
+        // One table per referenced type, built at compile time.  Every entry
+        // takes the referenced object as its object parameter.
+        struct VTable
+        {
+            const void* (*type_id) ();
+    
+            int (*foo) (const void* object_);
+            void (*set_value) (void* object_, int value);
+        };
+    
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename T>
+        struct Thunks
+        {
+            static T& value_of (void* object_)
+            {
+                return *static_cast<T*>(object_);
+            }
+    
+            static const T& value_of (const void* object_)
+            {
+                return *static_cast<const T*>(object_);
+            }
+    
+            // A reference does not own its object, so even an rvalue reference
+            // never lets rvalue-qualified functions consume it.
+            static T& rvalue_of (void* object_)
+            {
+                return value_of(object_);
+            }
+    
+            static const T& rvalue_of (const void* object_)
+            {
+                return value_of(object_);
+            }
+    
+            static int foo (const void* object_)
+            {
+                return value_of(object_).foo( );
+            }
+            static void set_value (void* object_, int value)
+            {
+                value_of(object_).set_value(value );
+            }
+    
+            static const VTable* table ()
+            {
+                static constexpr VTable table = {
+                    &type_id<T>,
+                    &foo,
+                    &set_value,
+                };
+                return &table;
+            }
+        };
+    
+        const VTable& vtable () const
+        {
+            return *vtable_;
+        }
+    
+        // Delegates returned by the bind_*() members call the referenced object,
+        // so they stay valid as long as it lives, whatever becomes of the
+        // reference.
+        static std::size_t bound_generation (const void*)
+        {
+            return 0;
+        }
+    
+        void* object () const
+        {
+            return object_;
+        }
+    
+        const VTable* vtable_ = nullptr;
+        void* object_ = nullptr;
+    };
+
+    
+    class FooableView
+    {
+    public:
+        // Contructors
+        FooableView () = default;
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< FooableView, typename std::remove_const<T>::type >::value
+                      >::type* = nullptr>
+        FooableView (T& value) noexcept :
+            vtable_ (Thunks<T>::table()),
+            object_ (const_cast<void*>(static_cast<const void*>(std::addressof(value))))
+        {}
+    
+        // T& above also binds const rvalues.  Referring to a temporary is
+        // never intended.
+        template <typename T>
+        FooableView (const T&& value) = delete;
+    
+        // cast<const T>() succeeds for const and non-const referenced objects,
+        // cast<T>() only for non-const ones.
+        template <typename T>
+        T* cast() const
+        {
+            assert(vtable_);
+            if (vtable_->type_id() != type_id<T>() &&
+                vtable_->type_id() != type_id<typename std::remove_const<T>::type>())
+                return nullptr;
+            return static_cast<T*>(object_);
+        }
+    
+        int foo ( ) const
+        {
+                assert(vtable_);
+                return vtable().foo(object() );
+        }
+    
+        type_erasure::delegate<int (const void* object_)> bind_foo () const
+        {
+                assert(vtable_);
+                return type_erasure::delegate<int (const void* object_)>(object(), vtable().foo, this, &bound_generation);
+        }
+    
+    private:
+        // One table per referenced type, built at compile time.  Every entry
+        // takes the referenced object as its object parameter.
+        struct VTable
+        {
+            const void* (*type_id) ();
+    
+            int (*foo) (const void* object_);
+        };
+    
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename T>
+        struct Thunks
+        {
+            static T& value_of (void* object_)
+            {
+                return *static_cast<T*>(object_);
+            }
+    
+            static const T& value_of (const void* object_)
+            {
+                return *static_cast<const T*>(object_);
+            }
+    
+            // A reference does not own its object, so even an rvalue reference
+            // never lets rvalue-qualified functions consume it.
+            static T& rvalue_of (void* object_)
+            {
+                return value_of(object_);
+            }
+    
+            static const T& rvalue_of (const void* object_)
+            {
+                return value_of(object_);
+            }
+    
+            static int foo (const void* object_)
+            {
+                return value_of(object_).foo( );
+            }
+    
+            static const VTable* table ()
+            {
+                static constexpr VTable table = {
+                    &type_id<T>,
+                    &foo,
+                };
+                return &table;
+            }
+        };
+    
+        const VTable& vtable () const
+        {
+            return *vtable_;
+        }
+    
+        // Delegates returned by the bind_*() members call the referenced object,
+        // so they stay valid as long as it lives, whatever becomes of the
+        // reference.
+        static std::size_t bound_generation (const void*)
+        {
+            return 0;
+        }
+    
+        void* object () const
+        {
+            return object_;
+        }
+    
+        const VTable* vtable_ = nullptr;
+        void* object_ = nullptr;
+    };
+
+}
+#endif
+
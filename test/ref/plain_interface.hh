@@ -0,0 +1,19 @@
+#ifndef REF_FOOABLE_HH
+#define REF_FOOABLE_HH
+
+namespace Ref
+{
+    class FooableRef
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+
+    class FooableView
+    {
+    public:
+        int foo() const;
+    };
+}
+#endif
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "interface.hh"
+#include "../sbo/interface.hh"
+#include "../unique/interface.hh"
+#include "../mock_fooable.hh"
+
+#include <type_traits>
+
+namespace
+{
+    using Ref::FooableRef;
+    using Ref::FooableView;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::MockMoveOnlyFooable;
+
+    void death_tests( FooableRef& fooable )
+    {
+#ifndef NDEBUG
+        EXPECT_DEATH( fooable.foo(), "" );
+        EXPECT_DEATH( fooable.set_value( Mock::other_value ), "" );
+#endif
+    }
+
+    // A function that takes its interface parameter by reference.
+    void set_value( FooableRef fooable, int value )
+    {
+        fooable.set_value( value );
+    }
+
+    int foo( FooableView fooable )
+    {
+        return fooable.foo();
+    }
+}
+
+
+TEST( TestFooableRef, Size )
+{
+    EXPECT_EQ( sizeof(FooableRef), 2 * sizeof(void*) );
+    EXPECT_EQ( sizeof(FooableView), 2 * sizeof(void*) );
+    EXPECT_TRUE( std::is_trivially_copyable<FooableRef>::value );
+    EXPECT_TRUE( std::is_trivially_copyable<FooableView>::value );
+}
+
+TEST( TestFooableRef, Empty )
+{
+    FooableRef fooable;
+    death_tests(fooable);
+
+    FooableRef copy(fooable);
+    death_tests(copy);
+}
+
+TEST( TestFooableRef, FromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    FooableRef fooable( mock_fooable );
+
+    EXPECT_EQ( fooable.foo(), Mock::value );
+    fooable.set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+    EXPECT_EQ( mock_fooable.foo(), Mock::other_value );
+}
+
+TEST( TestFooableRef, FromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    FooableRef fooable( mock_fooable );
+
+    EXPECT_EQ( fooable.foo(), Mock::value );
+    fooable.set_value( Mock::other_value );
+    EXPECT_EQ( mock_fooable.foo(), Mock::other_value );
+}
+
+TEST( TestFooableRef, Copy )
+{
+    MockFooable mock_fooable;
+    FooableRef fooable( mock_fooable );
+    FooableRef copy( fooable );
+
+    copy.set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+    EXPECT_EQ( mock_fooable.foo(), Mock::other_value );
+
+    MockFooable other_mock_fooable;
+    copy = FooableRef( other_mock_fooable );
+    EXPECT_EQ( copy.foo(), Mock::value );
+}
+
+TEST( TestFooableRef, FunctionParameter )
+{
+    MockFooable mock_fooable;
+    set_value( mock_fooable, Mock::other_value );
+    EXPECT_EQ( foo( mock_fooable ), Mock::other_value );
+}
+
+TEST( TestFooableRef, FromOwningErasedType )
+{
+    SBO::Fooable fooable = MockFooable();
+    set_value( fooable, Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+    EXPECT_EQ( foo( fooable ), Mock::other_value );
+
+    Unique::Fooable unique_fooable = MockMoveOnlyFooable();
+    set_value( unique_fooable, Mock::other_value );
+    EXPECT_EQ( foo( unique_fooable ), Mock::other_value );
+}
+
+TEST( TestFooableRef, ViewOfConstObject )
+{
+    const MockFooable mock_fooable;
+    FooableView fooable( mock_fooable );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    EXPECT_TRUE( (std::is_constructible<FooableView, const MockFooable&>::value) );
+    EXPECT_FALSE( (std::is_constructible<FooableView, MockFooable>::value) );
+}
+
+TEST( TestFooableRef, Cast )
+{
+    MockFooable mock_fooable;
+    FooableRef fooable( mock_fooable );
+    EXPECT_EQ( fooable.cast<MockFooable>(), &mock_fooable );
+    EXPECT_EQ( fooable.cast<const MockFooable>(), &mock_fooable );
+    EXPECT_TRUE( fooable.cast<MockLargeFooable>() == nullptr );
+
+    const MockFooable const_mock_fooable;
+    FooableView view( const_mock_fooable );
+    EXPECT_TRUE( view.cast<MockFooable>() == nullptr );
+    EXPECT_EQ( view.cast<const MockFooable>(), &const_mock_fooable );
+}
+
+TEST( TestFooableRef, Bind )
+{
+    MockFooable mock_fooable;
+    auto set_value = FooableRef( mock_fooable ).bind_set_value();
+    auto foo = FooableView( mock_fooable ).bind_foo();
+    EXPECT_TRUE( std::is_trivially_copyable<decltype(foo)>::value );
+
+    set_value( Mock::other_value );
+    EXPECT_EQ( mock_fooable.foo(), Mock::other_value );
+    EXPECT_EQ( foo(), Mock::other_value );
+}
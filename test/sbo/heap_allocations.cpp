@@ -2,14 +2,19 @@
 
 #define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
 #include "interface.hh"
+#include "aligned_interface.hh"
 #include "../mock_fooable.hh"
 #include "../util.hh"
 
 namespace
 {
     using SBO::Fooable;
+    using SBO::AlignedFooable;
     using Mock::MockFooable;
     using Mock::MockLargeFooable;
+    using Mock::MockNonTrivialFooable;
+    using Mock::MockStringFooable;
+    using Mock::MockAlignedFooable;
 }
 
 TEST( TestSBOFooable_HeapAllocations, Empty )
@@ -264,3 +269,138 @@ TEST( TestSBOFooable_HeapAllocations, MoveAssignFromValueWithReferenceWrapper_La
                       fooable = std::move(std::ref(mock_fooable)),
                       expected_heap_allocations );
 }
+
+
+TEST( TestSBOFooable_HeapAllocations, CopyFromValue_AlignedObject )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockAlignedFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( mock_fooable ),
+                      expected_heap_allocations );
+
+    expected_heap_allocations = 0u;
+    CHECK_HEAP_ALLOC( AlignedFooable aligned_fooable( mock_fooable ),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, CopyConstruction_AlignedObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    AlignedFooable fooable = MockAlignedFooable();
+    CHECK_HEAP_ALLOC( AlignedFooable other( fooable ),
+                      expected_heap_allocations );
+}
+
+
+TEST( TestSBOFooable_HeapAllocations, CopyFromValue_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    MockNonTrivialFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( mock_fooable ),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, CopyConstruction_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockNonTrivialFooable();
+    CHECK_HEAP_ALLOC( Fooable other( fooable ),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, MoveConstruction_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockNonTrivialFooable();
+    CHECK_HEAP_ALLOC( Fooable other( std::move(fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, CopyAssignment_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockNonTrivialFooable();
+    CHECK_HEAP_ALLOC( Fooable other = MockFooable();
+                      other = fooable,
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, MoveAssignment_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockNonTrivialFooable();
+    CHECK_HEAP_ALLOC( Fooable other = MockFooable();
+                      other = std::move(fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, CopyConstruction_StringObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    CHECK_HEAP_ALLOC( AlignedFooable fooable = MockStringFooable();
+                      AlignedFooable other( fooable );
+                      AlignedFooable moved( std::move(other) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, AssignSameType_LargeObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    MockLargeFooable mock_fooable;
+    Fooable fooable = MockLargeFooable();
+    CHECK_HEAP_ALLOC( fooable = mock_fooable;
+                      fooable = std::move(mock_fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, CopyAssignSameType_LargeObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockLargeFooable();
+    Fooable other = MockLargeFooable();
+    CHECK_HEAP_ALLOC( other = fooable,
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, AssignSmallerType_LargeObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockLargeFooable();
+    CHECK_HEAP_ALLOC( fooable = MockStringFooable(),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, AssignLargerType_StringObject )
+{
+    auto expected_heap_allocations = 1u;
+
+    Fooable fooable = MockStringFooable();
+    CHECK_HEAP_ALLOC( fooable = MockLargeFooable(),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOFooable_HeapAllocations, InPlace_LargeObject )
+{
+    auto expected_heap_allocations = 1u;
+
+    CHECK_HEAP_ALLOC( Fooable fooable{ type_erasure::in_place_type_t<MockLargeFooable>() },
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( fooable.emplace<MockLargeFooable>(),
+                      expected_heap_allocations );
+
+    expected_heap_allocations = 0u;
+    CHECK_HEAP_ALLOC( fooable.emplace<MockFooable>(),
+                      expected_heap_allocations );
+}
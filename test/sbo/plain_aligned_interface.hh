@@ -0,0 +1,13 @@
+#ifndef SBO_ALIGNED_FOOABLE_HH
+#define SBO_ALIGNED_FOOABLE_HH
+
+namespace SBO
+{
+    class AlignedFooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
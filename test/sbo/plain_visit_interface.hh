@@ -0,0 +1,15 @@
+#ifndef SBO_VISIT_FOOABLE_HH
+#define SBO_VISIT_FOOABLE_HH
+
+#include "../mock_fooable.hh"
+
+namespace SBOVisit
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
@@ -2,13 +2,21 @@
 
 #define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
 #include "interface.hh"
+#include "aligned_interface.hh"
+#include "visit_interface.hh"
 #include "../mock_fooable.hh"
 
+#include <cstdint>
+
 namespace
 {
     using SBO::Fooable;
+    using SBO::AlignedFooable;
     using Mock::MockFooable;
     using Mock::MockLargeFooable;
+    using Mock::MockRelocatableFooable;
+    using Mock::MockNonTrivialFooable;
+    using Mock::MockAlignedFooable;
 
     void death_tests( Fooable& fooable )
     {
@@ -334,3 +342,229 @@ TEST( TestSBOFooable, ConstCast_LargeObject )
 
     EXPECT_EQ( fooable.cast<MockLargeFooable>()->foo(), Mock::value );
 }
+
+
+TEST( TestSBOFooable, BufferConfiguration )
+{
+    EXPECT_EQ( Fooable::buffer_size(), 24u );
+    EXPECT_EQ( Fooable::buffer_alignment(), alignof(void*) );
+    EXPECT_EQ( Fooable::inline_capacity(), 24u - sizeof(void*) );
+    EXPECT_TRUE( Fooable::stored_inline<MockFooable>() );
+    EXPECT_FALSE( Fooable::stored_inline<MockLargeFooable>() );
+    EXPECT_FALSE( Fooable::stored_inline<MockAlignedFooable>() );
+
+    EXPECT_EQ( AlignedFooable::buffer_size(), 64u );
+    EXPECT_EQ( AlignedFooable::buffer_alignment(), 16u );
+    EXPECT_EQ( AlignedFooable::inline_capacity(), 64u - sizeof(void*) );
+    EXPECT_TRUE( AlignedFooable::stored_inline<MockAlignedFooable>() );
+}
+
+TEST( TestSBOFooable, AlignedObject )
+{
+    AlignedFooable fooable = MockAlignedFooable();
+    ASSERT_FALSE( fooable.cast<MockAlignedFooable>() == nullptr );
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>(fooable.cast<MockAlignedFooable>()) % 16, 0u );
+
+    AlignedFooable other( fooable );
+    other.set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+    EXPECT_EQ( other.foo(), Mock::other_value );
+
+    AlignedFooable moved( std::move(other) );
+    EXPECT_EQ( moved.foo(), Mock::other_value );
+    EXPECT_EQ( reinterpret_cast<std::uintptr_t>(moved.cast<MockAlignedFooable>()) % 16, 0u );
+}
+
+TEST( TestSBOFooable, NonTrivialObject )
+{
+    EXPECT_TRUE( Fooable::stored_inline<MockNonTrivialFooable>() );
+
+    {
+        Fooable fooable = MockNonTrivialFooable();
+        ASSERT_FALSE( fooable.cast<MockNonTrivialFooable>() == nullptr );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 1 );
+
+        Fooable copy( fooable );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 2 );
+        test_copies( copy, fooable, Mock::other_value );
+
+        Fooable moved( std::move(copy) );
+        EXPECT_EQ( moved.foo(), Mock::other_value );
+
+        Fooable large = MockLargeFooable();
+        large = std::move(moved);
+        EXPECT_EQ( large.foo(), Mock::other_value );
+
+        fooable = large;
+        EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+        Fooable small = MockFooable();
+        small = std::move(fooable);
+        EXPECT_EQ( small.foo(), Mock::other_value );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
+
+TEST( TestSBOFooable, TriviallyRelocatableObject )
+{
+    EXPECT_TRUE( Fooable::stored_inline<MockRelocatableFooable>() );
+
+    Fooable fooable = MockRelocatableFooable();
+    Fooable other = MockFooable();
+    MockRelocatableFooable::moves() = 0;
+
+    Fooable moved( std::move(fooable) );
+    EXPECT_EQ( moved.foo(), Mock::value );
+
+    std::swap( moved, other );
+    EXPECT_EQ( other.foo(), Mock::value );
+    ASSERT_FALSE( other.cast<MockRelocatableFooable>() == nullptr );
+
+    other.set_value( Mock::other_value );
+    EXPECT_EQ( other.foo(), Mock::other_value );
+    EXPECT_EQ( MockRelocatableFooable::moves(), 0 );
+}
+
+
+namespace
+{
+    // Returns which overload was called, after setting the value through
+    // it.
+    struct SetValueVisitor
+    {
+        int operator() (MockFooable& value) const
+        {
+            value.set_value( value.foo() + 1 );
+            return 1;
+        }
+
+        int operator() (MockLargeFooable& value) const
+        {
+            value.set_value( value.foo() + 1 );
+            return 2;
+        }
+
+        template <typename Fooable>
+        int operator() (Fooable& fooable) const
+        {
+            fooable.set_value( fooable.foo() + 1 );
+            return 0;
+        }
+    };
+
+    struct ConstVisitor
+    {
+        int operator() (const MockFooable&) const
+        {
+            return 1;
+        }
+
+        int operator() (const MockLargeFooable&) const
+        {
+            return 2;
+        }
+
+        template <typename Fooable>
+        int operator() (const Fooable&) const
+        {
+            return 0;
+        }
+    };
+}
+
+TEST( TestSBOFooable, Visit )
+{
+    SBOVisit::Fooable small = MockFooable();
+    EXPECT_EQ( small.visit( SetValueVisitor() ), 1 );
+    EXPECT_EQ( small.foo(), Mock::value + 1 );
+
+    SBOVisit::Fooable large = MockLargeFooable();
+    EXPECT_EQ( large.visit( SetValueVisitor() ), 2 );
+    EXPECT_EQ( large.foo(), Mock::value + 1 );
+
+    // Types that were not registered are passed as the erased object.
+    SBOVisit::Fooable other = MockNonTrivialFooable();
+    EXPECT_EQ( other.visit( SetValueVisitor() ), 0 );
+    EXPECT_EQ( other.foo(), Mock::value + 1 );
+
+    MockFooable mock_fooable;
+    SBOVisit::Fooable ref = std::ref( mock_fooable );
+    EXPECT_EQ( ref.visit( SetValueVisitor() ), 0 );
+    EXPECT_EQ( mock_fooable.foo(), Mock::value + 1 );
+
+    Fooable unregistered = MockFooable();
+    EXPECT_EQ( unregistered.visit( SetValueVisitor() ), 0 );
+    EXPECT_EQ( unregistered.foo(), Mock::value + 1 );
+}
+
+TEST( TestSBOFooable, ConstVisit )
+{
+    const SBOVisit::Fooable small = MockFooable();
+    const SBOVisit::Fooable large = MockLargeFooable();
+    const SBOVisit::Fooable other = MockNonTrivialFooable();
+    EXPECT_EQ( small.visit( ConstVisitor() ), 1 );
+    EXPECT_EQ( large.visit( ConstVisitor() ), 2 );
+    EXPECT_EQ( other.visit( ConstVisitor() ), 0 );
+
+    const Fooable unregistered = MockLargeFooable();
+    EXPECT_EQ( unregistered.visit( ConstVisitor() ), 0 );
+}
+
+TEST( TestSBOFooable, AssignSameType )
+{
+    {
+        MockNonTrivialFooable mock;
+        mock.set_value( Mock::other_value );
+
+        Fooable fooable = MockNonTrivialFooable();
+        fooable = mock;
+        EXPECT_EQ( fooable.foo(), Mock::other_value );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 2 );
+
+        Fooable other = MockNonTrivialFooable();
+        other = fooable;
+        EXPECT_EQ( other.foo(), Mock::other_value );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 3 );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+
+    Fooable large = MockLargeFooable();
+    large = Mock::MockStringFooable();
+    ASSERT_FALSE( large.cast<Mock::MockStringFooable>() == nullptr );
+    EXPECT_EQ( large.foo(), Mock::value );
+
+    large = MockLargeFooable();
+    ASSERT_FALSE( large.cast<MockLargeFooable>() == nullptr );
+}
+
+TEST( TestSBOFooable, InPlace )
+{
+    using Mock::MockValueFooable;
+    MockValueFooable::transfers() = 0;
+
+    Fooable fooable( type_erasure::in_place_type_t<MockValueFooable>(), Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    MockValueFooable& value = fooable.emplace<MockValueFooable>( Mock::value );
+    EXPECT_EQ( &value, fooable.cast<MockValueFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    Fooable made = SBO::make_fooable<MockValueFooable>( Mock::other_value );
+    EXPECT_EQ( made.foo(), Mock::other_value );
+    EXPECT_EQ( MockValueFooable::transfers(), 0 );
+}
+
+TEST( TestSBOFooable, InPlace_LargeObject )
+{
+    Fooable fooable{ type_erasure::in_place_type_t<Mock::MockLargeFooable>() };
+    ASSERT_FALSE( fooable.cast<Mock::MockLargeFooable>() == nullptr );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    fooable.emplace<Mock::MockLargeFooable>().set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    fooable.emplace<MockFooable>();
+    EXPECT_EQ( fooable.foo(), Mock::value );
+}
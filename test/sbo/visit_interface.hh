@@ -0,0 +1,548 @@
+#ifndef SBO_VISIT_FOOABLE_HH
+#define SBO_VISIT_FOOABLE_HH
+
+#include <cassert>
+#include <memory>
+#include <utility>
+#include "../mock_fooable.hh"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+#if defined(_MSC_VER) && _MSC_VER == 1800
+#define noexcept
+#define alignof __alignof
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#endif
+
+#ifndef SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT alignof(void*)
+#endif
+
+#ifndef TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+#define TYPE_ERASURE_IS_TRIVIALLY_RELOCATABLE
+namespace type_erasure
+{
+    // Values of types for which this is true are moved by copying their bytes,
+    // without calling the move constructor or the destructor.  True for
+    // trivially copyable types; specialize it for other types that allow this.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T>
+    {};
+}
+#endif
+
+#ifndef TYPE_ERASURE_IN_PLACE_TYPE
+#define TYPE_ERASURE_IN_PLACE_TYPE
+namespace type_erasure
+{
+    // Selects the constructors that build a T from the remaining arguments,
+    // directly where the erased type stores it.  With C++17 this is
+    // std::in_place_type_t, so std::in_place_type<T> works too.
+#if __cplusplus >= 201703L
+    using std::in_place_type_t;
+    using std::in_place_type;
+#else
+    template <typename T>
+    struct in_place_type_t
+    {
+        explicit in_place_type_t () = default;
+    };
+#if __cplusplus >= 201402L
+    template <typename T>
+    constexpr in_place_type_t<T> in_place_type{};
+#endif
+#endif
+}
+#endif
+
+
+namespace SBOVisit {
+    
+    class Fooable
+    {
+        public:
+        // Contructors
+        Fooable () = default;
+    
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                             std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            handle_ = clone_impl( std::forward<T>(value), buffer_ );
+        }
+    
+        Fooable (const Fooable& rhs)
+        {
+            if (rhs.handle_)
+                handle_ = rhs.handle_->clone_into(buffer_);
+        }
+    
+        Fooable (Fooable&& rhs) noexcept
+        {
+            move_from(rhs);
+        }
+    
+        // Constructs a T from args in place.
+        template <typename T, typename... Args>
+        explicit Fooable (type_erasure::in_place_type_t<T>, Args&&... args)
+        {
+            handle_ = emplace_impl<T>(buffer_, type_erasure::in_place_type_t<T>(),
+                                      std::forward<Args>(args)...);
+        }
+    
+        // Assignment
+        template <typename T,
+                  typename std::enable_if<
+                      !std::is_same< Fooable, typename std::decay<T>::type >::value
+                      >::type* = nullptr>
+        Fooable& operator= (T&& value) noexcept ( std::is_rvalue_reference<T>::value &&
+                                                        std::is_nothrow_move_constructible<typename std::decay<T>::type>::value )
+        {
+            using StoredType = decltype(Handle<typename std::decay<T>::type, false>::value_);
+            assign(std::forward<T>(value),
+                   std::integral_constant<bool, assignable_in_place<StoredType, T>()>());
+            return *this;
+        }
+    
+        Fooable& operator= (const Fooable& rhs)
+        {
+            if (handle_ && rhs.handle_ && rhs.handle_->assign_to(*handle_))
+                return *this;
+    
+            Fooable temp(rhs);
+            reset();
+            move_from(temp);
+            return *this;
+        }
+    
+        Fooable& operator= (Fooable&& rhs) noexcept
+        {
+            if (this != &rhs) {
+                reset();
+                move_from(rhs);
+            }
+            return *this;
+        }
+    
+        ~Fooable ()
+        {
+            reset();
+        }
+    
+        // Replaces the value with a T constructed from args in place, and
+        // returns it.
+        template <typename T, typename... Args>
+        T& emplace (Args&&... args)
+        {
+            reset();
+            handle_ = emplace_impl<T>(buffer_, type_erasure::in_place_type_t<T>(),
+                                      std::forward<Args>(args)...);
+            return value_of<T>();
+        }
+    
+        template <typename T>
+        T* cast()
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+        }
+    
+        template <typename T>
+        const T* cast() const
+        {
+            assert(handle_);
+            if (handle_->type_id() != type_id<T>())
+                return nullptr;
+            return &static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+        }
+    
+        // Calls f(value) on the stored value if its type is one of those given to
+        // emtypen with --visit-type, and f(*this) otherwise.  The stored type is
+        // looked up once, so the calls f makes on value can be inlined.
+        template <typename F>
+        auto visit (F&& f) -> decltype(f(std::declval<Fooable&>()))
+        {
+            assert(handle_);
+            return visit_impl(f, *this, handle_->type_id(), VisitTypes<Mock::MockFooable, Mock::MockLargeFooable>());
+        }
+    
+        template <typename F>
+        auto visit (F&& f) const -> decltype(f(std::declval<const Fooable&>()))
+        {
+            assert(handle_);
+            return visit_impl(f, *this, handle_->type_id(), VisitTypes<Mock::MockFooable, Mock::MockLargeFooable>());
+        }
+    
+        // The small buffer, and what fits in it.  inline_capacity() is the size of
+        // the largest pointer-aligned value that is stored in the buffer instead
+        // of on the heap, provided it can be moved without throwing or is
+        // trivially relocatable.
+        static constexpr std::size_t buffer_size ()
+        {
+            return sizeof(Buffer);
+        }
+    
+        static constexpr std::size_t buffer_alignment ()
+        {
+            return alignof(Buffer);
+        }
+    
+        static constexpr std::size_t inline_capacity ()
+        {
+            return sizeof(Buffer) - sizeof(HandleBase);
+        }
+    
+        template <typename T>
+        static constexpr bool stored_inline ()
+        {
+            return sizeof(Handle<typename std::decay<T>::type, false>) <= sizeof(Buffer) &&
+                   alignof(Handle<typename std::decay<T>::type, false>) <= alignof(Buffer) &&
+                   (std::is_nothrow_move_constructible<typename std::decay<T>::type>::value ||
+                    type_erasure::is_trivially_relocatable<typename std::decay<T>::type>::value);
+        }
+    
+        int foo ( ) const
+        {
+                assert(handle_);
+                return handle_->foo( );
+        }
+        void set_value ( int value )
+        {
+                assert(handle_);
+                handle_->set_value(value );
+        }
+    
+        private:
+            using Buffer = typename std::aligned_storage<SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE, SMALL_OBJECT_OPTIMIZATION_BUFFER_ALIGNMENT>::type;
+    
+        template <typename T>
+        static const void* type_id ()
+        {
+            static char id;
+            return &id;
+        }
+    
+        template <typename... Ts>
+        struct VisitTypes
+        {};
+    
+        template <typename F, typename Self>
+        static auto visit_impl (F& f, Self& self, const void*, VisitTypes<>) -> decltype(f(self))
+        {
+            return f(self);
+        }
+    
+        template <typename F, typename Self, typename T, typename... Ts>
+        static auto visit_impl (F& f, Self& self, const void* id, VisitTypes<T, Ts...>) -> decltype(f(self))
+        {
+            if (id == type_id<T>())
+                return f(self.template value_of<T>());
+            return visit_impl(f, self, id, VisitTypes<Ts...>());
+        }
+    
+        template <typename T>
+        T& value_of ()
+        {
+            return static_cast<Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+        }
+    
+        template <typename T>
+        const T& value_of () const
+        {
+            return static_cast<const Handle<T, !stored_inline<T>()>*>(handle_)->value_;
+        }
+    
+        struct HandleBase
+        {
+            virtual ~HandleBase () {}
+            virtual const void* type_id () const noexcept = 0;
+            virtual HandleBase* clone_into (Buffer& buffer) const = 0;
+            virtual HandleBase* move_into (Buffer& buffer) noexcept = 0;
+            virtual bool assign_to (HandleBase& handle) const = 0;
+            virtual std::size_t heap_size () const noexcept = 0;
+            virtual void* release () noexcept = 0;
+            virtual void destroy () = 0;
+    
+            virtual int foo ( ) const = 0;
+            virtual void set_value ( int value ) = 0;
+        };
+    
+        template <typename T, bool HeapAllocated>
+        struct Handle : HandleBase
+        {
+            template <typename U,
+                      typename std::enable_if<
+                          !std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle(U&& value) noexcept :
+                value_( value )
+            {}
+    
+            template <typename U,
+                      typename std::enable_if<
+                          std::is_same< T, typename std::decay<U>::type >::value
+                                               >::type* = nullptr>
+            explicit Handle(U&& value) noexcept ( std::is_rvalue_reference<U>::value &&
+                                                  std::is_nothrow_move_constructible<typename std::decay<U>::type>::value ) :
+                value_( std::forward<U>(value) )
+            {}
+    
+            template <typename... Args>
+            explicit Handle(type_erasure::in_place_type_t<T>, Args&&... args) :
+                value_( std::forward<Args>(args)... )
+            {}
+    
+            virtual HandleBase* clone_into (Buffer& buffer) const
+            {
+                return clone_impl(value_, buffer);
+            }
+    
+            virtual HandleBase* move_into (Buffer& buffer) noexcept
+            {
+                return relocate(this, buffer);
+            }
+    
+            // Copies value_ over the value of handle, if that has the same type.
+            virtual bool assign_to (HandleBase& handle) const
+            {
+                return handle.type_id() == Fooable::type_id<T>() &&
+                    copy_assign(static_cast<Handle&>(handle).value_, value_,
+                                std::integral_constant<bool, assignable_in_place<T, const T&>()>());
+            }
+    
+            // The size of the heap block holding this handle, or 0 if it is in a
+            // buffer or in an over-aligned block, which is not reused.  A reused
+            // block may be larger.
+            virtual std::size_t heap_size () const noexcept
+            {
+                return HeapAllocated && plain_block<T>() ? sizeof(Handle) : 0;
+            }
+    
+            // Destroys the handle, and returns its memory without freeing it.
+            virtual void* release () noexcept
+            {
+                this->~Handle();
+                return this;
+            }
+    
+            virtual void destroy ()
+            {
+                if (!HeapAllocated)
+                    this->~Handle();
+                else if (plain_block<T>())
+                    ::operator delete(release());
+                else
+                    delete this;
+            }
+    
+            virtual const void* type_id () const noexcept
+            {
+                return Fooable::type_id<T>();
+            }
+    
+            virtual int foo ( ) const {
+                return value_.foo( );
+            }
+            virtual void set_value ( int value ) {
+                value_.set_value(value );
+            }
+    
+            T value_;
+        };
+    
+        template <typename T, bool HeapAllocated>
+        struct Handle<std::reference_wrapper<T>, HeapAllocated> : Handle<T&, HeapAllocated>
+        {
+            Handle (std::reference_wrapper<T> ref) :
+                Handle<T&, HeapAllocated> (ref.get())
+            {}
+        };
+    
+        template <typename T>
+        static HandleBase* clone_impl (T&& value, Buffer& buffer)
+        {
+            return emplace_impl<typename std::decay<T>::type>(buffer, std::forward<T>(value));
+        }
+    
+        // Constructs a handle for a T from args, in buffer if a T fits there.
+        template <typename T, typename... Args>
+        static HandleBase* emplace_impl (Buffer& buffer, Args&&... args)
+        {
+            void* buf_ptr = get_buffer_ptr<T>(buffer);
+            if (buf_ptr) {
+                new (buf_ptr) Handle<T, false>( std::forward<Args>(args)... );
+                return static_cast<HandleBase*>(buf_ptr);
+            }
+    
+            if (plain_block<T>()) {
+                return heap_handle<T>(::operator new(sizeof(Handle<T, true>)),
+                                      std::forward<Args>(args)...);
+            }
+            return new Handle<T, true>(std::forward<Args>(args)...);
+        }
+    
+        // Whether a heap handle for T may live in a block from the plain
+        // operator new, which is only aligned for std::max_align_t.  Over-aligned
+        // handles get their own new expression, which aligns them where the
+        // language supports that, and their blocks are never reused.
+        template <typename T>
+        static constexpr bool plain_block ()
+        {
+            return alignof(Handle<T, true>) <= alignof(std::max_align_t);
+        }
+    
+        // Constructs a heap handle in block, and frees block if that throws.
+        template <typename T, typename... Args>
+        static HandleBase* heap_handle (void* block, Args&&... args)
+        {
+            try {
+                return ::new (block) Handle<T, true>(std::forward<Args>(args)...);
+            } catch (...) {
+                ::operator delete(block);
+                throw;
+            }
+        }
+    
+        // Whether a stored T can be assigned a U in place.  Stored references,
+        // such as those from std::reference_wrapper, are not, since that would
+        // assign to the referenced object, and nor are
+        // types whose assignment may throw where construction would not.
+        template <typename T, typename U>
+        static constexpr bool assignable_in_place ()
+        {
+            return !std::is_reference<T>::value && std::is_assignable<T&, U>::value &&
+                   (std::is_nothrow_assignable<T&, U>::value ||
+                    !std::is_nothrow_constructible<T, U>::value);
+        }
+    
+        template <typename T>
+        static bool copy_assign (T& to, const T& from, std::true_type)
+        {
+            to = from;
+            return true;
+        }
+    
+        template <typename T>
+        static bool copy_assign (T&, const T&, std::false_type)
+        {
+            return false;
+        }
+    
+        // Assigns value to the stored value if that has the same type.
+        template <typename T>
+        void assign (T&& value, std::true_type)
+        {
+            using PlainType = typename std::decay<T>::type;
+            if (handle_ && handle_->type_id() == type_id<PlainType>())
+                value_of<PlainType>() = std::forward<T>(value);
+            else
+                replace(std::forward<T>(value));
+        }
+    
+        template <typename T>
+        void assign (T&& value, std::false_type)
+        {
+            replace(std::forward<T>(value));
+        }
+    
+        // Replaces the stored value.  The heap block of the old value is reused
+        // if the new one goes on the heap too, and fits in it.
+        template <typename T>
+        void replace (T&& value)
+        {
+            using PlainType = typename std::decay<T>::type;
+            using HeapHandle = Handle<PlainType, true>;
+    
+            if (!stored_inline<PlainType>() && handle_ && sizeof(HeapHandle) <= handle_->heap_size() &&
+                plain_block<PlainType>()) {
+                void* const block = handle_->release();
+                handle_ = nullptr;
+                handle_ = heap_handle<PlainType>(block, std::forward<T>(value));
+                return;
+            }
+    
+            reset();
+            handle_ = clone_impl(std::forward<T>(value), buffer_);
+        }
+    
+        // Heap handles are passed over, inline handles move to the new buffer.
+        template <typename T>
+        static HandleBase* relocate (Handle<T, true>* handle, Buffer&) noexcept
+        {
+            return handle;
+        }
+    
+        template <typename T>
+        static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer) noexcept
+        {
+            return relocate(handle, buffer, type_erasure::is_trivially_relocatable<T>());
+        }
+    
+        template <typename T>
+        static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                     std::true_type) noexcept
+        {
+            std::memcpy(static_cast<void*>(&buffer), static_cast<void*>(handle),
+                        sizeof(Handle<T, false>));
+            return static_cast<Handle<T, false>*>(static_cast<void*>(&buffer));
+        }
+    
+        template <typename T>
+        static HandleBase* relocate (Handle<T, false>* handle, Buffer& buffer,
+                                     std::false_type) noexcept
+        {
+            HandleBase* const moved =
+                new (&buffer) Handle<T, false>( std::move(handle->value_) );
+            handle->~Handle();
+            return moved;
+        }
+    
+        // Expects this to be empty, and leaves rhs empty.
+        void move_from (Fooable& rhs) noexcept
+        {
+            if (rhs.handle_)
+                handle_ = rhs.handle_->move_into(buffer_);
+            rhs.handle_ = nullptr;
+        }
+    
+        void reset ()
+        {
+            if (handle_)
+                handle_->destroy();
+            handle_ = nullptr;
+        }
+    
+        template <class T>
+        static void* get_buffer_ptr(Buffer& buffer)
+        {
+            return stored_inline<T>() ? &buffer : nullptr;
+        }
+    
+        HandleBase* handle_ = nullptr;
+        Buffer buffer_;
+    };
+    
+    // Constructs a T from args in place, in a new Fooable.
+    template <typename T, typename... Args>
+    Fooable make_fooable (Args&&... args)
+    {
+        return Fooable(type_erasure::in_place_type_t<T>(), std::forward<Args>(args)...);
+    }
+
+}
+#endif
+
@@ -9,6 +9,8 @@ namespace
     using SBOCOW::Fooable;
     using Mock::MockFooable;
     using Mock::MockLargeFooable;
+    using Mock::MockNonTrivialFooable;
+    using Mock::MockStringFooable;
 }
 
 TEST( TestSBOCOWFooable_HeapAllocations, Empty )
@@ -271,3 +273,96 @@ TEST( TestSBOCOWFooable_HeapAllocations, MoveAssignFromValueWithReferenceWrapper
                       fooable = std::move(std::ref(mock_fooable)),
                       expected_heap_allocations );
 }
+
+
+TEST( TestSBOCOWFooable_HeapAllocations, CopyFromValue_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    MockNonTrivialFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( mock_fooable ),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOCOWFooable_HeapAllocations, CopyConstruction_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockNonTrivialFooable();
+    CHECK_HEAP_ALLOC( Fooable other( fooable ),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOCOWFooable_HeapAllocations, MoveConstruction_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockNonTrivialFooable();
+    CHECK_HEAP_ALLOC( Fooable other( std::move(fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOCOWFooable_HeapAllocations, CopyAssignment_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockNonTrivialFooable();
+    CHECK_HEAP_ALLOC( Fooable other = MockFooable();
+                      other = fooable,
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOCOWFooable_HeapAllocations, MoveAssignment_NonTrivialObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockNonTrivialFooable();
+    CHECK_HEAP_ALLOC( Fooable other = MockFooable();
+                      other = std::move(fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOCOWFooable_HeapAllocations, AssignSameType_LargeObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    MockLargeFooable mock_fooable;
+    Fooable fooable = MockLargeFooable();
+    CHECK_HEAP_ALLOC( fooable = mock_fooable;
+                      fooable = std::move(mock_fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOCOWFooable_HeapAllocations, AssignSameType_SharedLargeObject )
+{
+    auto expected_heap_allocations = 1u;
+
+    Fooable fooable = MockLargeFooable();
+    Fooable copy( fooable );
+    CHECK_HEAP_ALLOC( fooable = MockLargeFooable(),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOCOWFooable_HeapAllocations, AssignSmallerType_LargeObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockLargeFooable();
+    CHECK_HEAP_ALLOC( fooable = MockStringFooable(),
+                      expected_heap_allocations );
+}
+
+TEST( TestSBOCOWFooable_HeapAllocations, InPlace_LargeObject )
+{
+    auto expected_heap_allocations = 1u;
+
+    CHECK_HEAP_ALLOC( Fooable fooable{ type_erasure::in_place_type_t<MockLargeFooable>() },
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( fooable.emplace<MockLargeFooable>(),
+                      expected_heap_allocations );
+
+    expected_heap_allocations = 0u;
+    CHECK_HEAP_ALLOC( fooable.emplace<MockFooable>(),
+                      expected_heap_allocations );
+}
@@ -0,0 +1,13 @@
+#ifndef SBO_COW_LOCAL_FOOABLE_HH
+#define SBO_COW_LOCAL_FOOABLE_HH
+
+namespace SBOCOWLocal
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
@@ -1,13 +1,18 @@
 #include <gtest/gtest.h>
 
 #include "interface.hh"
+#include "local_interface.hh"
 #include "../mock_fooable.hh"
 
+#include <thread>
+
 namespace
 {
     using SBOCOW::Fooable;
     using Mock::MockFooable;
     using Mock::MockLargeFooable;
+    using Mock::MockRelocatableFooable;
+    using Mock::MockNonTrivialFooable;
 
     void death_tests( Fooable& fooable )
     {
@@ -334,3 +339,165 @@ TEST( TestSBOCOWFooable, ConstCast_LargeObject )
     EXPECT_EQ( fooable.cast<MockLargeFooable>()->foo(), Mock::value );
 }
 
+
+
+TEST( TestSBOCOWFooable, BufferConfiguration )
+{
+    EXPECT_EQ( Fooable::buffer_size(), 24u );
+    EXPECT_EQ( Fooable::buffer_alignment(), alignof(void*) );
+    EXPECT_EQ( Fooable::inline_capacity(), 24u - sizeof(void*) );
+    EXPECT_TRUE( Fooable::stored_inline<MockFooable>() );
+
+    using Fitting = std::array<char, 24u - sizeof(void*)>;
+    using TooLarge = std::array<char, 24u - sizeof(void*) + 1u>;
+    EXPECT_TRUE( Fooable::stored_inline<Fitting>() );
+    EXPECT_FALSE( Fooable::stored_inline<TooLarge>() );
+    EXPECT_FALSE( Fooable::stored_inline<MockLargeFooable>() );
+
+    // Values in the buffer carry no reference count.
+    EXPECT_EQ( SBOCOWLocal::Fooable::inline_capacity(), Fooable::inline_capacity() );
+}
+
+TEST( TestSBOCOWFooable, NonTrivialObject )
+{
+    EXPECT_TRUE( Fooable::stored_inline<MockNonTrivialFooable>() );
+
+    {
+        Fooable fooable = MockNonTrivialFooable();
+        ASSERT_FALSE( fooable.cast<MockNonTrivialFooable>() == nullptr );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 1 );
+
+        Fooable copy( fooable );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 2 );
+        test_copies( copy, fooable, Mock::other_value );
+
+        Fooable moved( std::move(copy) );
+        EXPECT_EQ( moved.foo(), Mock::other_value );
+
+        Fooable large = MockLargeFooable();
+        large = std::move(moved);
+        EXPECT_EQ( large.foo(), Mock::other_value );
+
+        fooable = large;
+        EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+        Fooable small = MockFooable();
+        small = std::move(fooable);
+        EXPECT_EQ( small.foo(), Mock::other_value );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
+
+TEST( TestSBOCOWFooable, TriviallyRelocatableObject )
+{
+    EXPECT_TRUE( Fooable::stored_inline<MockRelocatableFooable>() );
+
+    Fooable fooable = MockRelocatableFooable();
+    Fooable other = MockFooable();
+    MockRelocatableFooable::moves() = 0;
+
+    Fooable moved( std::move(fooable) );
+    EXPECT_EQ( moved.foo(), Mock::value );
+
+    std::swap( moved, other );
+    EXPECT_EQ( other.foo(), Mock::value );
+    ASSERT_FALSE( other.cast<MockRelocatableFooable>() == nullptr );
+
+    other.set_value( Mock::other_value );
+    EXPECT_EQ( other.foo(), Mock::other_value );
+    EXPECT_EQ( MockRelocatableFooable::moves(), 0 );
+}
+
+
+TEST( TestSBOCOWLocalFooable, CopyOnWrite_LargeObject )
+{
+    SBOCOWLocal::Fooable fooable = MockLargeFooable();
+    SBOCOWLocal::Fooable copy( fooable );
+    EXPECT_EQ( copy.cast<MockLargeFooable>(), fooable.cast<MockLargeFooable>() );
+
+    copy.set_value( Mock::other_value );
+    EXPECT_NE( copy.cast<MockLargeFooable>(), fooable.cast<MockLargeFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+    EXPECT_EQ( copy.foo(), Mock::other_value );
+
+    SBOCOWLocal::Fooable copy_assign;
+    copy_assign = copy;
+    SBOCOWLocal::Fooable move_assign = MockFooable();
+    move_assign = std::move(copy);
+    EXPECT_EQ( copy_assign.cast<MockLargeFooable>(), move_assign.cast<MockLargeFooable>() );
+    EXPECT_EQ( move_assign.foo(), Mock::other_value );
+}
+
+TEST( TestSBOCOWLocalFooable, CopyOnWrite_SmallObject )
+{
+    SBOCOWLocal::Fooable fooable = MockFooable();
+    SBOCOWLocal::Fooable copy( fooable );
+    copy.set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+    EXPECT_EQ( copy.foo(), Mock::other_value );
+}
+
+TEST( TestSBOCOWLocalFooable, UsedByOtherThread )
+{
+#ifndef NDEBUG
+    SBOCOWLocal::Fooable fooable = MockLargeFooable();
+    EXPECT_DEATH( std::thread( [&fooable] {
+                      SBOCOWLocal::Fooable copy( fooable );
+                  } ).join(), "" );
+    EXPECT_DEATH( std::thread( [&fooable] {
+                      fooable.set_value( Mock::other_value );
+                  } ).join(), "" );
+
+    SBOCOWLocal::Fooable copy( fooable );
+    EXPECT_DEATH( std::thread( [&copy] {
+                      copy = SBOCOWLocal::Fooable();
+                  } ).join(), "" );
+#endif
+}
+
+// Only the count of a heap value is checked, so the other thread may read
+// the heap value, and do anything with a value in the buffer.
+TEST( TestSBOCOWLocalFooable, UncheckedByOtherThread )
+{
+    SBOCOWLocal::Fooable large = MockLargeFooable();
+    SBOCOWLocal::Fooable small = MockFooable();
+    int value = 0;
+    std::thread( [&] {
+        value = large.foo();
+        small.set_value( Mock::other_value );
+        SBOCOWLocal::Fooable copy( small );
+        value += copy.foo();
+    } ).join();
+    EXPECT_EQ( value, Mock::value + Mock::other_value );
+}
+
+TEST( TestSBOCOWFooable, InPlace )
+{
+    using Mock::MockValueFooable;
+    MockValueFooable::transfers() = 0;
+
+    Fooable fooable( type_erasure::in_place_type_t<MockValueFooable>(), Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    MockValueFooable& value = fooable.emplace<MockValueFooable>( Mock::value );
+    EXPECT_EQ( &value, fooable.cast<MockValueFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    Fooable made = SBOCOW::make_fooable<MockValueFooable>( Mock::other_value );
+    EXPECT_EQ( made.foo(), Mock::other_value );
+    EXPECT_EQ( MockValueFooable::transfers(), 0 );
+}
+
+TEST( TestSBOCOWFooable, InPlace_LargeObject )
+{
+    Fooable fooable{ type_erasure::in_place_type_t<Mock::MockLargeFooable>() };
+    ASSERT_FALSE( fooable.cast<Mock::MockLargeFooable>() == nullptr );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    fooable.emplace<Mock::MockLargeFooable>().set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    fooable.emplace<MockFooable>();
+    EXPECT_EQ( fooable.foo(), Mock::value );
+}
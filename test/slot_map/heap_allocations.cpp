@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../sbo/interface.hh"
+#include "../mock_fooable.hh"
+#include "../util.hh"
+
+namespace
+{
+    using SBO::Fooable;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+
+    using SlotMap = type_erasure::slot_map<Fooable>;
+}
+
+TEST( TestSlotMap_HeapAllocations, InsertErase )
+{
+    auto expected_heap_allocations = 0u;
+
+    SlotMap map;
+    map.reserve( 4 );
+
+    // Small values live in the dense array itself.
+    SlotMap::handle h;
+    CHECK_HEAP_ALLOC( h = map.insert( MockFooable() ),
+                      expected_heap_allocations );
+    CHECK_HEAP_ALLOC( map.insert( MockFooable() ),
+                      expected_heap_allocations );
+    CHECK_HEAP_ALLOC( map.erase( h ),
+                      expected_heap_allocations );
+
+    int sum = 0;
+    CHECK_HEAP_ALLOC( for (const Fooable& fooable : map) { sum += fooable.foo(); },
+                      expected_heap_allocations );
+    EXPECT_EQ( sum, Mock::value );
+
+    expected_heap_allocations = 1u;
+    CHECK_HEAP_ALLOC( map.insert( MockLargeFooable() ),
+                      expected_heap_allocations );
+}
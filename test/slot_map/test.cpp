@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "../sbo/interface.hh"
+#include "../mock_fooable.hh"
+
+#include <vector>
+
+namespace
+{
+    using SBO::Fooable;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::MockNonTrivialFooable;
+
+    using SlotMap = type_erasure::slot_map<Fooable>;
+
+    int sum (const SlotMap& map)
+    {
+        int retval = 0;
+        for (const Fooable& fooable : map) {
+            retval += fooable.foo();
+        }
+        return retval;
+    }
+}
+
+
+TEST( TestSlotMap, Empty )
+{
+    SlotMap map;
+    EXPECT_TRUE( map.empty() );
+    EXPECT_EQ( map.size(), 0u );
+    EXPECT_TRUE( map.begin() == map.end() );
+
+    EXPECT_FALSE( map.contains( SlotMap::handle() ) );
+    EXPECT_EQ( map.find( SlotMap::handle() ), nullptr );
+    EXPECT_FALSE( map.erase( SlotMap::handle() ) );
+}
+
+TEST( TestSlotMap, Insert )
+{
+    SlotMap map;
+    SlotMap::handle small = map.insert( MockFooable() );
+    SlotMap::handle large = map.insert( MockLargeFooable() );
+
+    EXPECT_NE( small, large );
+    EXPECT_EQ( map.size(), 2u );
+    EXPECT_TRUE( map.contains( small ) );
+    EXPECT_TRUE( map.contains( large ) );
+    ASSERT_NE( map.find( small ), nullptr );
+    EXPECT_EQ( map.find( small )->foo(), Mock::value );
+
+    map[large].set_value( Mock::other_value );
+    EXPECT_EQ( map[large].foo(), Mock::other_value );
+    EXPECT_EQ( map[small].foo(), Mock::value );
+    EXPECT_EQ( sum( map ), Mock::value + Mock::other_value );
+}
+
+TEST( TestSlotMap, HandleValue )
+{
+    SlotMap map;
+    map.insert( MockFooable() );
+    SlotMap::handle h = map.insert( MockFooable() );
+
+    SlotMap::handle copy( h.value() );
+    EXPECT_EQ( copy, h );
+    EXPECT_TRUE( map.contains( copy ) );
+}
+
+TEST( TestSlotMap, Erase )
+{
+    SlotMap map;
+    std::vector<SlotMap::handle> handles;
+    for (int i = 0; i < 10; ++i) {
+        handles.push_back( map.insert( MockFooable() ) );
+        map[handles.back()].set_value( i );
+    }
+
+    // Erasing moves the last value into the gap, without disturbing the
+    // other handles.
+    EXPECT_TRUE( map.erase( handles[3] ) );
+    EXPECT_FALSE( map.erase( handles[3] ) );
+    EXPECT_FALSE( map.contains( handles[3] ) );
+    EXPECT_EQ( map.find( handles[3] ), nullptr );
+    EXPECT_EQ( map.size(), 9u );
+    EXPECT_EQ( (map.begin() + 3)->foo(), 9 );
+
+    EXPECT_TRUE( map.erase( handles[9] ) );
+    EXPECT_TRUE( map.erase( handles[0] ) );
+    for (int i : {1, 2, 4, 5, 6, 7, 8}) {
+        ASSERT_TRUE( map.contains( handles[i] ) );
+        EXPECT_EQ( map[handles[i]].foo(), i );
+    }
+    EXPECT_EQ( sum( map ), 1 + 2 + 4 + 5 + 6 + 7 + 8 );
+}
+
+TEST( TestSlotMap, StaleHandle )
+{
+    SlotMap map;
+    SlotMap::handle old_handle = map.insert( MockFooable() );
+    map.erase( old_handle );
+
+    // The new value reuses the slot, but not the generation.
+    SlotMap::handle new_handle = map.insert( MockLargeFooable() );
+    EXPECT_NE( new_handle, old_handle );
+    EXPECT_FALSE( map.contains( old_handle ) );
+    EXPECT_FALSE( map.erase( old_handle ) );
+    EXPECT_TRUE( map.contains( new_handle ) );
+    EXPECT_EQ( map.size(), 1u );
+}
+
+TEST( TestSlotMap, Clear )
+{
+    SlotMap map;
+    std::vector<SlotMap::handle> handles;
+    for (int i = 0; i < 5; ++i) {
+        handles.push_back( map.insert( MockNonTrivialFooable() ) );
+    }
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 5 );
+
+    map.clear();
+    EXPECT_TRUE( map.empty() );
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+    for (SlotMap::handle h : handles) {
+        EXPECT_FALSE( map.contains( h ) );
+    }
+
+    for (int i = 0; i < 6; ++i) {
+        SlotMap::handle h = map.insert( MockFooable() );
+        EXPECT_TRUE( map.contains( h ) );
+    }
+    EXPECT_EQ( map.size(), 6u );
+    for (SlotMap::handle h : handles) {
+        EXPECT_FALSE( map.contains( h ) );
+    }
+}
+
+TEST( TestSlotMap, NonTrivialObject )
+{
+    {
+        SlotMap map;
+        SlotMap::handle first = map.insert( MockNonTrivialFooable() );
+        map.insert( MockNonTrivialFooable() );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 2 );
+
+        map.erase( first );
+        EXPECT_EQ( MockNonTrivialFooable::instances(), 1 );
+    }
+
+    EXPECT_EQ( MockNonTrivialFooable::instances(), 0 );
+}
@@ -0,0 +1,13 @@
+#ifndef STATIC_VTABLE_FOOABLE_HH
+#define STATIC_VTABLE_FOOABLE_HH
+
+namespace StaticVTable
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
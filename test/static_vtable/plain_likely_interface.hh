@@ -0,0 +1,15 @@
+#ifndef STATIC_VTABLE_LIKELY_FOOABLE_HH
+#define STATIC_VTABLE_LIKELY_FOOABLE_HH
+
+#include "../mock_fooable.hh"
+
+namespace StaticVTableLikely
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "interface.hh"
+#include "../mock_fooable.hh"
+#include "../util.hh"
+
+namespace
+{
+    using Unique::Fooable;
+    using Mock::MockMoveOnlyFooable;
+    using Mock::MockLargeMoveOnlyFooable;
+}
+
+TEST( TestUniqueFooable_HeapAllocations, Empty )
+{
+    auto expected_heap_allocations = 0u;
+
+    CHECK_HEAP_ALLOC( Fooable fooable,
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable move( std::move(fooable) ),
+                      expected_heap_allocations );
+
+    CHECK_HEAP_ALLOC( Fooable move_assign;
+                      move_assign = std::move(move),
+                      expected_heap_allocations );
+}
+
+TEST( TestUniqueFooable_HeapAllocations, MoveFromValue_MoveOnlyObject )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockMoveOnlyFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( std::move(mock_fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestUniqueFooable_HeapAllocations, MoveConstruction_MoveOnlyObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockMoveOnlyFooable();
+    CHECK_HEAP_ALLOC( Fooable other( std::move(fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestUniqueFooable_HeapAllocations, MoveAssignment_MoveOnlyObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockMoveOnlyFooable();
+    Fooable other = MockMoveOnlyFooable();
+    CHECK_HEAP_ALLOC( other = std::move(fooable),
+                      expected_heap_allocations );
+}
+
+TEST( TestUniqueFooable_HeapAllocations, MoveFromValue_LargeMoveOnlyObject )
+{
+    auto expected_heap_allocations = 1u;
+
+    MockLargeMoveOnlyFooable mock_fooable;
+    CHECK_HEAP_ALLOC( Fooable fooable( std::move(mock_fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestUniqueFooable_HeapAllocations, MoveConstruction_LargeMoveOnlyObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockLargeMoveOnlyFooable();
+    CHECK_HEAP_ALLOC( Fooable other( std::move(fooable) ),
+                      expected_heap_allocations );
+}
+
+TEST( TestUniqueFooable_HeapAllocations, MoveAssignment_LargeMoveOnlyObject )
+{
+    auto expected_heap_allocations = 0u;
+
+    Fooable fooable = MockLargeMoveOnlyFooable();
+    Fooable other = MockMoveOnlyFooable();
+    CHECK_HEAP_ALLOC( other = std::move(fooable),
+                      expected_heap_allocations );
+}
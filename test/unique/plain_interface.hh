@@ -0,0 +1,13 @@
+#ifndef UNIQUE_FOOABLE_HH
+#define UNIQUE_FOOABLE_HH
+
+namespace Unique
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
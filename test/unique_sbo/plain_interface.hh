@@ -0,0 +1,13 @@
+#ifndef UNIQUE_SBO_FOOABLE_HH
+#define UNIQUE_SBO_FOOABLE_HH
+
+namespace UniqueSBO
+{
+    class Fooable
+    {
+    public:
+        int foo() const;
+        void set_value(int value);
+    };
+}
+#endif
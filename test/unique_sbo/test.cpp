@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+
+#define SMALL_OBJECT_OPTIMIZATION_BUFFER_SIZE 24
+#include "interface.hh"
+#include "../mock_fooable.hh"
+
+#include <type_traits>
+
+namespace
+{
+    using UniqueSBO::Fooable;
+    using Mock::MockFooable;
+    using Mock::MockLargeFooable;
+    using Mock::MockMoveOnlyFooable;
+    using Mock::MockLargeMoveOnlyFooable;
+
+    void death_tests( Fooable& fooable )
+    {
+#ifndef NDEBUG
+        EXPECT_DEATH( fooable.foo(), "" );
+        EXPECT_DEATH( fooable.set_value( Mock::other_value ), "" );
+#endif
+    }
+
+    void test_interface( Fooable& fooable, int initial_value, int new_value )
+    {
+        EXPECT_EQ( fooable.foo(), initial_value );
+        fooable.set_value( new_value );
+        EXPECT_EQ( fooable.foo(), new_value );
+    }
+
+    void test_ref_interface( Fooable& fooable, const MockFooable& mock_fooable,
+                             int new_value )
+    {
+        test_interface(fooable, mock_fooable.foo(), new_value);
+        EXPECT_EQ( mock_fooable.foo(), new_value );
+    }
+}
+
+
+TEST( TestUniqueSBOFooable, MoveOnly )
+{
+    EXPECT_FALSE( std::is_copy_constructible<Fooable>::value );
+    EXPECT_FALSE( std::is_copy_assignable<Fooable>::value );
+    EXPECT_TRUE( std::is_nothrow_move_constructible<Fooable>::value );
+    EXPECT_TRUE( std::is_nothrow_move_assignable<Fooable>::value );
+}
+
+TEST( TestUniqueSBOFooable, Empty )
+{
+    Fooable fooable;
+    death_tests(fooable);
+
+    Fooable move( std::move(fooable) );
+    death_tests(move);
+
+    Fooable move_assign;
+    move_assign = std::move(move);
+    death_tests(move_assign);
+}
+
+
+TEST( TestUniqueSBOFooable, CopyFromValue_SmallObject )
+{
+    MockFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+    EXPECT_EQ( mock_fooable.foo(), value );
+}
+
+TEST( TestUniqueSBOFooable, CopyFromValue_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( mock_fooable );
+
+    test_interface( fooable, value, Mock::other_value );
+    EXPECT_EQ( mock_fooable.foo(), value );
+}
+
+
+TEST( TestUniqueSBOFooable, CopyFromValueWithReferenceWrapper_SmallObject )
+{
+    MockFooable mock_fooable;
+    Fooable fooable( std::ref(mock_fooable) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+TEST( TestUniqueSBOFooable, CopyFromValueWithReferenceWrapper_LargeObject )
+{
+    MockLargeFooable mock_fooable;
+    Fooable fooable( std::ref(mock_fooable) );
+
+    test_ref_interface( fooable, mock_fooable, Mock::other_value );
+}
+
+
+TEST( TestUniqueSBOFooable, MoveFromValue_MoveOnlyObject )
+{
+    MockMoveOnlyFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+TEST( TestUniqueSBOFooable, MoveFromValue_LargeMoveOnlyObject )
+{
+    MockLargeMoveOnlyFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable( std::move(mock_fooable) );
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+
+TEST( TestUniqueSBOFooable, MoveConstruction_MoveOnlyObject )
+{
+    Fooable fooable = MockMoveOnlyFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestUniqueSBOFooable, MoveConstruction_LargeMoveOnlyObject )
+{
+    Fooable fooable = MockLargeMoveOnlyFooable();
+    auto value = fooable.foo();
+    Fooable other( std::move(fooable) );
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+
+TEST( TestUniqueSBOFooable, MoveAssignFromValue_MoveOnlyObject )
+{
+    MockMoveOnlyFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable = MockLargeMoveOnlyFooable();
+    fooable = std::move(mock_fooable);
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+TEST( TestUniqueSBOFooable, MoveAssignFromValue_LargeMoveOnlyObject )
+{
+    MockLargeMoveOnlyFooable mock_fooable;
+    auto value = mock_fooable.foo();
+    Fooable fooable = MockMoveOnlyFooable();
+    fooable = std::move(mock_fooable);
+
+    test_interface( fooable, value, Mock::other_value );
+}
+
+
+TEST( TestUniqueSBOFooable, MoveAssignment_MoveOnlyObject )
+{
+    Fooable fooable = MockMoveOnlyFooable();
+    auto value = fooable.foo();
+    Fooable other = MockLargeMoveOnlyFooable();
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+TEST( TestUniqueSBOFooable, MoveAssignment_LargeMoveOnlyObject )
+{
+    Fooable fooable = MockLargeMoveOnlyFooable();
+    auto value = fooable.foo();
+    Fooable other = MockMoveOnlyFooable();
+    other = std::move(fooable);
+
+    test_interface( other, value, Mock::other_value );
+    death_tests(fooable);
+}
+
+
+TEST( TestUniqueSBOFooable, Cast_MoveOnlyObject )
+{
+    Fooable fooable = MockMoveOnlyFooable();
+    ASSERT_FALSE( fooable.cast<MockMoveOnlyFooable>() == nullptr );
+    EXPECT_TRUE( fooable.cast<MockFooable>() == nullptr );
+
+    fooable.cast<MockMoveOnlyFooable>()->set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+}
+
+TEST( TestUniqueSBOFooable, ConstCast_LargeMoveOnlyObject )
+{
+    const Fooable fooable = MockLargeMoveOnlyFooable();
+    ASSERT_FALSE( fooable.cast<MockLargeMoveOnlyFooable>() == nullptr );
+    EXPECT_EQ( fooable.cast<MockLargeMoveOnlyFooable>()->foo(), Mock::value );
+}
+
+
+TEST( TestUniqueSBOFooable, BufferConfiguration )
+{
+    EXPECT_EQ( Fooable::buffer_size(), 24u );
+    EXPECT_EQ( Fooable::buffer_alignment(), alignof(void*) );
+    EXPECT_EQ( Fooable::inline_capacity(), 24u - sizeof(void*) );
+    EXPECT_TRUE( Fooable::stored_inline<MockMoveOnlyFooable>() );
+    EXPECT_FALSE( Fooable::stored_inline<MockLargeMoveOnlyFooable>() );
+}
+
+TEST( TestUniqueSBOFooable, InPlace )
+{
+    using Mock::MockValueFooable;
+    MockValueFooable::transfers() = 0;
+
+    Fooable fooable( type_erasure::in_place_type_t<MockValueFooable>(), Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    MockValueFooable& value = fooable.emplace<MockValueFooable>( Mock::value );
+    EXPECT_EQ( &value, fooable.cast<MockValueFooable>() );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    Fooable made = UniqueSBO::make_fooable<MockValueFooable>( Mock::other_value );
+    EXPECT_EQ( made.foo(), Mock::other_value );
+    EXPECT_EQ( MockValueFooable::transfers(), 0 );
+}
+
+TEST( TestUniqueSBOFooable, InPlace_LargeObject )
+{
+    Fooable fooable{ type_erasure::in_place_type_t<Mock::MockLargeFooable>() };
+    ASSERT_FALSE( fooable.cast<Mock::MockLargeFooable>() == nullptr );
+    EXPECT_EQ( fooable.foo(), Mock::value );
+
+    fooable.emplace<Mock::MockLargeFooable>().set_value( Mock::other_value );
+    EXPECT_EQ( fooable.foo(), Mock::other_value );
+
+    fooable.emplace<MockFooable>();
+    EXPECT_EQ( fooable.foo(), Mock::value );
+}